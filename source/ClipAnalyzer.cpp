@@ -0,0 +1,308 @@
+#include "ClipAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+//===================== Clip index I/O =====================
+
+static constexpr juce::uint32 kAnalysisMagic = 0x4e414a44; // "DJAN"
+static constexpr juce::uint32 kAnalysisVersion = 1;
+
+bool ClipAnalysis::save(const juce::File& file) const
+{
+    if (!valid || !file.getParentDirectory().createDirectory())
+        return false;
+
+    juce::FileOutputStream out(file);
+    if (out.failedToOpen())
+        return false;
+
+    out.setPosition(0);
+    out.truncate();
+
+    out.writeInt((int)kAnalysisMagic);
+    out.writeInt((int)kAnalysisVersion);
+    out.writeFloat(bpm);
+    out.writeInt(bars);
+    out.writeInt(beatsPerBar);
+    out.writeInt(downbeatOffset);
+    out.writeFloat(confidence);
+    out.writeDouble(sampleRate);
+
+    return out.getStatus().wasOk();
+}
+
+bool ClipAnalysis::load(const juce::File& file)
+{
+    constexpr juce::int64 kEntrySize = 7 * 4 + 8;
+
+    juce::FileInputStream in(file);
+    if (in.failedToOpen() || in.getTotalLength() != kEntrySize)
+        return false;
+
+    if ((juce::uint32)in.readInt() != kAnalysisMagic || (juce::uint32)in.readInt() != kAnalysisVersion)
+        return false;
+
+    ClipAnalysis loaded;
+    loaded.bpm = in.readFloat();
+    loaded.bars = in.readInt();
+    loaded.beatsPerBar = in.readInt();
+    loaded.downbeatOffset = in.readInt();
+    loaded.confidence = in.readFloat();
+    loaded.sampleRate = in.readDouble();
+
+    if (!(loaded.bpm > 0.0f) || loaded.bars <= 0 || loaded.beatsPerBar <= 0 || loaded.downbeatOffset < 0
+        || !(loaded.sampleRate > 0.0))
+        return false;
+
+    loaded.valid = true;
+    *this = loaded;
+    return true;
+}
+
+//===================== Onset envelope =====================
+
+ClipAnalyzer::Envelope ClipAnalyzer::computeEnvelope(const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    Envelope env;
+    env.hop = juce::jmax(64, juce::roundToInt(sampleRate * 0.01)); // ~10 ms
+
+    const int numSamples = audio.getNumSamples();
+    const int numHops = numSamples / env.hop;
+    const int numChannels = audio.getNumChannels();
+    if (numHops < 8 || numChannels == 0)
+        return env;
+
+    // Per-hop energy of the first difference (transients) and of a ~150 Hz low-pass (kick)
+    std::vector<float> highEnergy((size_t)numHops), lowEnergy((size_t)numHops);
+    const float lowCoeff = (float)std::exp(-2.0 * juce::MathConstants<double>::pi * 150.0 / sampleRate);
+    const float channelScale = 1.0f / (float)numChannels;
+
+    float prev = 0.0f, lowState = 0.0f;
+    for (int h = 0; h < numHops; ++h)
+    {
+        float high = 0.0f, low = 0.0f;
+        for (int i = h * env.hop, end = i + env.hop; i < end; ++i)
+        {
+            float mono = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+                mono += audio.getSample(ch, i);
+            mono *= channelScale;
+
+            const float diff = mono - prev;
+            prev = mono;
+            lowState = mono + lowCoeff * (lowState - mono);
+
+            high += diff * diff;
+            low += lowState * lowState;
+        }
+
+        highEnergy[(size_t)h] = std::log(high + 1.0e-9f);
+        lowEnergy[(size_t)h] = std::log(low + 1.0e-9f);
+    }
+
+    // Half-wave rectified log-energy rise, wrapping at the loop point
+    env.full.resize((size_t)numHops);
+    env.low.resize((size_t)numHops);
+    for (int h = 0; h < numHops; ++h)
+    {
+        const size_t before = (size_t)((h + numHops - 1) % numHops);
+        env.full[(size_t)h] = juce::jmax(0.0f, highEnergy[(size_t)h] - highEnergy[before]);
+        env.low[(size_t)h] = juce::jmax(0.0f, lowEnergy[(size_t)h] - lowEnergy[before]);
+    }
+
+    return env;
+}
+
+static float sampleCircular(const std::vector<float>& env, double pos) noexcept
+{
+    const int n = (int)env.size();
+    const double wrapped = pos - std::floor(pos / n) * n;
+    const int i0 = (int)wrapped % n;
+    const float frac = (float)(wrapped - std::floor(wrapped));
+    return env[(size_t)i0] + frac * (env[(size_t)((i0 + 1) % n)] - env[(size_t)i0]);
+}
+
+float ClipAnalyzer::circularAutocorrelation(const std::vector<float>& env, double lag) noexcept
+{
+    double sum = 0.0, energy = 0.0;
+    for (size_t i = 0; i < env.size(); ++i)
+    {
+        sum += env[i] * sampleCircular(env, (double)i + lag);
+        energy += env[i] * env[i];
+    }
+
+    return energy > 0.0 ? (float)(sum / energy) : 0.0f;
+}
+
+float ClipAnalyzer::combStrength(const std::vector<float>& env, double start, double period, int count) noexcept
+{
+    float sum = 0.0f;
+    for (int k = 0; k < count; ++k)
+        sum += sampleCircular(env, start + k * period);
+    return sum;
+}
+
+//===================== Analysis =====================
+
+// Mild preference for tempi near 120 BPM when readings are otherwise close
+static float tempoPrior(double bpm) noexcept
+{
+    const double octaves = std::log2(bpm / 120.0);
+    return (float)std::exp(-0.5 * octaves * octaves);
+}
+
+ClipAnalysis ClipAnalyzer::analyze(const juce::AudioBuffer<float>& audio, double sampleRate, int beatsPerBar)
+{
+    ClipAnalysis result;
+    result.sampleRate = sampleRate;
+    result.beatsPerBar = juce::jmax(1, beatsPerBar);
+
+    const auto env = computeEnvelope(audio, sampleRate);
+    if (env.full.empty() || sampleRate <= 0.0)
+        return result;
+
+    const double lengthSeconds = audio.getNumSamples() / sampleRate;
+    const double hopsPerSecond = sampleRate / env.hop;
+    const int numHops = (int)env.full.size();
+
+    auto scoreTempo = [&](double bpm)
+        {
+            const double beatLag = hopsPerSecond * 60.0 / bpm;
+            return circularAutocorrelation(env.full, beatLag) * tempoPrior(bpm);
+        };
+
+    // 1) Whole-bar readings of the clip length
+    double bestBpm = 0.0, bestScore = -1.0, totalScore = 0.0;
+    int bestBars = 0;
+
+    for (int bars = 1; bars <= 64; bars *= 2)
+    {
+        const double bpm = bars * result.beatsPerBar * 60.0 / lengthSeconds;
+        if (bpm < kMinBpm || bpm >= kMaxBpm)
+            continue;
+
+        const double score = scoreTempo(bpm);
+        totalScore += score;
+        if (score > bestScore)
+            bestScore = score, bestBpm = bpm, bestBars = bars;
+    }
+
+    // 2) Otherwise a free search over the plausible range
+    if (bestBars == 0)
+    {
+        totalScore = 0.0;
+        for (double bpm = kMinBpm; bpm < kMaxBpm; bpm += 0.5)
+        {
+            const double score = scoreTempo(bpm);
+            totalScore += score;
+            if (score > bestScore)
+                bestScore = score, bestBpm = bpm;
+        }
+
+        const double barSeconds = result.beatsPerBar * 60.0 / bestBpm;
+        bestBars = juce::jmax(1, juce::roundToInt(lengthSeconds / barSeconds));
+        totalScore /= 40.0; // comparable to a handful of whole-bar candidates
+    }
+
+    result.bpm = (float)bestBpm;
+    result.bars = bestBars;
+    result.confidence = totalScore > 0.0 ? (float)juce::jlimit(0.0, 1.0, bestScore / totalScore) : 0.0f;
+
+    // 3) Beat phase, then which beat of the bar is the one
+    const double beatLag = hopsPerSecond * 60.0 / bestBpm;
+    const int beatsInClip = juce::jmax(1, (int)(numHops / beatLag));
+
+    double bestPhase = 0.0;
+    float bestPhaseScore = combStrength(env.full, 0.0, beatLag, beatsInClip);
+    for (int p = 1; p < (int)beatLag; ++p)
+    {
+        const float s = combStrength(env.full, p, beatLag, beatsInClip);
+        if (s > bestPhaseScore)
+            bestPhaseScore = s, bestPhase = p;
+    }
+
+    const double barLag = beatLag * result.beatsPerBar;
+    const int barsInClip = juce::jmax(1, (int)(numHops / barLag));
+    const float zeroScore = combStrength(env.low, 0.0, barLag, barsInClip);
+
+    double downbeat = 0.0;
+    float downbeatScore = zeroScore;
+    for (int b = 0; b < result.beatsPerBar; ++b)
+    {
+        const double start = bestPhase + b * beatLag;
+        const float s = combStrength(env.low, start, barLag, barsInClip);
+        if (s > downbeatScore)
+            downbeatScore = s, downbeat = start;
+    }
+
+    // Keep the file start unless another phase is clearly stronger
+    constexpr float kDownbeatMargin = 1.5f;
+    if (downbeatScore < zeroScore * kDownbeatMargin || downbeat < 1.5 || downbeat > numHops - 1.5)
+        downbeat = 0.0;
+
+    result.downbeatOffset = juce::jlimit(0, juce::jmax(0, audio.getNumSamples() - 1),
+        (int)std::lround(downbeat * env.hop));
+    result.valid = true;
+    return result;
+}
+
+//===================== Transients =====================
+
+std::vector<int> ClipAnalyzer::findTransients(const juce::AudioBuffer<float>& audio, double sampleRate, int maxTransients)
+{
+    std::vector<int> positions;
+    if (sampleRate <= 0.0 || maxTransients <= 0)
+        return positions;
+
+    const auto env = computeEnvelope(audio, sampleRate);
+    const int numHops = (int)env.full.size();
+    if (numHops == 0)
+        return positions;
+
+    double mean = 0.0, sumSquares = 0.0;
+    for (float v : env.full)
+        mean += v, sumSquares += (double)v * v;
+    mean /= numHops;
+    const float threshold = (float)(mean + 0.5 * std::sqrt(juce::jmax(0.0, sumSquares / numHops - mean * mean)));
+
+    // Local maxima above the threshold (circular: the hit at the loop point counts)
+    std::vector<int> peaks;
+    for (int h = 0; h < numHops; ++h)
+    {
+        const float v = env.full[(size_t)h];
+        if (v > threshold
+            && v >= env.full[(size_t)((h + numHops - 1) % numHops)]
+            && v > env.full[(size_t)((h + 1) % numHops)])
+            peaks.push_back(h);
+    }
+
+    // Strongest first, skipping any too close to one already kept
+    std::stable_sort(peaks.begin(), peaks.end(),
+        [&env](int a, int b) { return env.full[(size_t)a] > env.full[(size_t)b]; });
+
+    const int minGap = juce::jmax(1, juce::roundToInt(kMinTransientGapSeconds * sampleRate / env.hop));
+    std::vector<int> kept;
+
+    for (int h : peaks)
+    {
+        if ((int)kept.size() >= maxTransients)
+            break;
+
+        const bool clear = std::none_of(kept.begin(), kept.end(), [&](int k)
+            {
+                const int d = std::abs(h - k);
+                return juce::jmin(d, numHops - d) < minGap;
+            });
+
+        if (clear)
+            kept.push_back(h);
+    }
+
+    std::sort(kept.begin(), kept.end());
+    positions.reserve(kept.size());
+    for (int h : kept)
+        positions.push_back(h * env.hop);
+
+    return positions;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/** Tempo and bar grid estimated for one clip. */
+struct ClipAnalysis
+{
+    float bpm = 120.0f;
+    int bars = 1;
+    int beatsPerBar = 4;
+    int downbeatOffset = 0;     // samples from the file start to the first downbeat
+    double sampleRate = 0.0;    // rate downbeatOffset is expressed in
+    float confidence = 0.0f;    // 0..1, how clearly the winning tempo stood out
+    bool valid = false;
+
+    /** Clip index I/O (ClipCache entry). load() rejects other versions. */
+    bool save(const juce::File& file) const;
+    bool load(const juce::File& file);
+};
+
+/**
+ * Offline clip analysis: tempo, loop length in bars and first downbeat.
+ *
+ * Works on a circular onset envelope (loops wrap, so the transient at the
+ * loop point counts). Loop packs are assumed to hold whole bars, so tempo
+ * candidates are first taken from the clip length itself (1, 2, 4, ... bars)
+ * and scored by the envelope's autocorrelation at their beat period; only
+ * when no whole-bar reading lands in the plausible range does it fall back
+ * to a free autocorrelation search. The downbeat is the beat phase whose bar
+ * positions carry the most low-band onset energy, and it stays at zero
+ * unless another phase clearly wins, since most loops start on the one.
+ *
+ * Pure function of the audio; safe to run on any thread, one clip per call.
+ */
+class ClipAnalyzer
+{
+public:
+    static constexpr float kMinBpm = 70.0f;
+    static constexpr float kMaxBpm = 180.0f;
+
+    static ClipAnalysis analyze(const juce::AudioBuffer<float>& audio, double sampleRate, int beatsPerBar = 4);
+
+    /**
+     * Sample positions of the strongest onsets (at most `maxTransients`, in
+     * file order): peaks of the onset envelope clearly above its average and
+     * at least kMinTransientGapSeconds apart. Same thread rules as analyze().
+     */
+    static std::vector<int> findTransients(const juce::AudioBuffer<float>& audio, double sampleRate, int maxTransients);
+
+    static constexpr double kMinTransientGapSeconds = 0.06;
+
+private:
+    struct Envelope
+    {
+        std::vector<float> full;    // broadband onset strength per hop
+        std::vector<float> low;     // low band (kick) onset strength per hop
+        int hop = 0;
+    };
+
+    static Envelope computeEnvelope(const juce::AudioBuffer<float>& audio, double sampleRate);
+    static float circularAutocorrelation(const std::vector<float>& env, double lag) noexcept;
+    static float combStrength(const std::vector<float>& env, double start, double period, int count) noexcept;
+};
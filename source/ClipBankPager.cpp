@@ -0,0 +1,289 @@
+#include "ClipBankPager.h"
+#include "ParallelFor.h"
+#include "TraceRecorder.h"
+
+// Decodes one clip and attaches its cached (or freshly built) overview, analysis, slices and loudness
+static void loadClip(DJamClip& c, const juce::File& file, double sampleRate, const ClipCache& cache)
+{
+    c.loadFromFile(file, sampleRate);
+    if (!c.isLoaded())
+        return;
+
+    const auto cacheFile = cache.getEntryFile(file, ".djov");
+    auto overview = std::make_shared<WaveformOverview>();
+
+    if (!overview->load(cacheFile, c.getNumSamples()))
+    {
+        overview->build(c.getAudio());
+        overview->save(cacheFile);
+    }
+
+    c.setOverview(std::move(overview));
+
+    // Tempo / bars / downbeat from the clip index, analysed on a miss
+    const auto analysisFile = cache.getEntryFile(file, ".djan");
+    ClipAnalysis analysis;
+
+    if (!analysis.load(analysisFile))
+    {
+        analysis = ClipAnalyzer::analyze(c.getAudio(), c.getSampleRate());
+        analysis.save(analysisFile);
+    }
+
+    c.applyAnalysis(analysis);
+
+    // Slice tables from the grid just set and the clip's own hits
+    c.buildSlices();
+
+    // Integrated LUFS / true peak for gain normalisation
+    const auto loudnessFile = cache.getEntryFile(file, ".djld");
+    ClipLoudness loudness;
+
+    if (!loudness.load(loudnessFile))
+    {
+        loudness = ClipLoudness::measure(c.getAudio(), c.getSampleRate());
+        loudness.save(loudnessFile);
+    }
+
+    c.setLoudness(loudness);
+}
+
+ClipBankPager::ClipBankPager(int slots, const ClipCache& clipCache)
+    : juce::Thread("D-Jam bank loader"),
+      cache(clipCache),
+      numSlots(slots),
+      residentBudget(slots + kSpareBanks),
+      wantedBanks(new std::atomic<int>[(size_t)slots]),
+      claims(new std::atomic<int>[(size_t)(slots * kNumClaims)])
+{
+    for (int s = 0; s < numSlots; ++s)
+        wantedBanks[(size_t)s].store(0);
+
+    for (int i = 0; i < numSlots * kNumClaims; ++i)
+        claims[(size_t)i].store(kNoBank);
+}
+
+ClipBankPager::~ClipBankPager()
+{
+    stopThread(5000);
+}
+
+//===================== Message thread =====================
+
+void ClipBankPager::prepare(std::vector<DJamClip>& clipStorage, const juce::Array<juce::File>& catalogue, double sr)
+{
+    release();
+
+    clips = &clipStorage;
+    files = catalogue;
+    sampleRate = sr;
+    numFiles = catalogue.size();
+    numBanks = (numFiles + kClipsPerBank - 1) / kClipsPerBank;
+
+    bankStates.reset(numBanks > 0 ? new std::atomic<int>[(size_t)numBanks] : nullptr);
+    for (int b = 0; b < numBanks; ++b)
+        bankStates[(size_t)b].store(absent);
+
+    lastWanted.assign((size_t)numBanks, 0);
+    serviceCount = 0;
+
+    for (int i = 0; i < numSlots * kNumClaims; ++i)
+        claims[(size_t)i].store(kNoBank);
+}
+
+void ClipBankPager::release()
+{
+    stopThread(5000);
+
+    if (clips != nullptr)
+    {
+        const juce::ScopedLock sl(evictionLock);
+        for (int b = 0; b < numBanks; ++b)
+            bankStates[(size_t)b].store(absent);
+
+        for (int i = 0; i < numFiles; ++i)
+            (*clips)[(size_t)i].unload();
+    }
+
+    clips = nullptr;
+    numFiles = numBanks = 0;
+}
+
+int ClipBankPager::getNumResidentBanks() const noexcept
+{
+    int n = 0;
+    for (int b = 0; b < numBanks; ++b)
+        n += bankStates[(size_t)b].load(std::memory_order_relaxed) == resident ? 1 : 0;
+    return n;
+}
+
+void ClipBankPager::setWantedBank(int slot, int bank) noexcept
+{
+    if (slot >= 0 && slot < numSlots)
+        wantedBanks[(size_t)slot].store(bank, std::memory_order_relaxed);
+}
+
+void ClipBankPager::loadWantedBanks()
+{
+    auto loadIfAbsent = [this](int bank)
+        {
+            int expected = absent;
+            if (bank >= 0 && bank < numBanks && bankStates[(size_t)bank].compare_exchange_strong(expected, loading))
+                loadBank(bank);
+        };
+
+    for (int s = 0; s < numSlots; ++s)
+        loadIfAbsent(wantedBanks[(size_t)s].load(std::memory_order_relaxed));
+
+    // Banks of clips the slots were already playing before a reload
+    for (int i = 0; i < numSlots * kNumClaims; ++i)
+        loadIfAbsent(claims[(size_t)i].load(std::memory_order_relaxed));
+
+    if (numBanks > 0)
+        startThread(juce::Thread::Priority::low);
+}
+
+//===================== Audio thread =====================
+
+bool ClipBankPager::isResident(int bank) const noexcept
+{
+    return bank >= 0 && bank < numBanks && bankStates[(size_t)bank].load() == resident;
+}
+
+bool ClipBankPager::claim(int slot, Claim which, int bank) noexcept
+{
+    if (bank == kNoBank)
+    {
+        keepClaim(slot, which, kNoBank);
+        return true;
+    }
+
+    auto& c = claims[(size_t)(slot * kNumClaims + which)];
+    const int previous = c.load();
+    if (previous == bank)
+        return true;    // held all along, so it can't have been freed
+
+    // Claim first, then check: pairs with tryEvict() marking first, then checking claims
+    c.store(bank);
+    if (isResident(bank))
+        return true;
+
+    c.store(previous);
+    return false;
+}
+
+void ClipBankPager::keepClaim(int slot, Claim which, int bank) noexcept
+{
+    claims[(size_t)(slot * kNumClaims + which)].store(bank);
+}
+
+//===================== Loader thread =====================
+
+void ClipBankPager::run()
+{
+    TraceRecorder::get().setThreadName("bank loader");
+
+    while (!threadShouldExit())
+    {
+        service();
+        wait(kPollIntervalMs);
+    }
+}
+
+void ClipBankPager::service()
+{
+    ++serviceCount;
+
+    auto markWanted = [this](int bank)
+        {
+            if (bank >= 0 && bank < numBanks)
+                lastWanted[(size_t)bank] = serviceCount;
+        };
+
+    for (int s = 0; s < numSlots; ++s)
+        markWanted(wantedBanks[(size_t)s].load(std::memory_order_relaxed));
+    for (int i = 0; i < numSlots * kNumClaims; ++i)
+        markWanted(claims[(size_t)i].load(std::memory_order_relaxed));
+
+    // Load in slot order, so the first bank a slot is switched to comes first
+    for (int s = 0; s < numSlots && !threadShouldExit(); ++s)
+    {
+        const int bank = wantedBanks[(size_t)s].load(std::memory_order_relaxed);
+        if (bank < 0 || bank >= numBanks)
+            continue;
+
+        int expected = absent;
+        if (bankStates[(size_t)bank].compare_exchange_strong(expected, loading))
+            loadBank(bank);
+    }
+
+    // Over budget: evict the banks wanted longest ago; a bank wanted this pass is never a candidate
+    int numResident = getNumResidentBanks();
+    while (numResident > residentBudget && !threadShouldExit())
+    {
+        int oldest = -1;
+        for (int b = 0; b < numBanks; ++b)
+            if (bankStates[(size_t)b].load(std::memory_order_relaxed) == resident
+                && lastWanted[(size_t)b] != serviceCount
+                && (oldest < 0 || lastWanted[(size_t)b] < lastWanted[(size_t)oldest]))
+                oldest = b;
+
+        if (oldest < 0 || !tryEvict(oldest))
+            break;
+
+        --numResident;
+    }
+}
+
+void ClipBankPager::loadBank(int bank)
+{
+    DJAM_TRACE_SCOPE("load bank", bank)
+
+    const int first = bank * kClipsPerBank;
+    const int count = juce::jmin(kClipsPerBank, numFiles - first);
+
+    parallelFor(count, [&](int i)
+        {
+            TraceRecorder::get().setThreadName("clip loader");
+            DJAM_TRACE_SCOPE("load clip", first + i)
+            auto& clip = (*clips)[(size_t)(first + i)];
+            loadClip(clip, files[first + i], sampleRate, cache);
+
+            if (onClipLoaded != nullptr && clip.isLoaded())
+                onClipLoaded(first + i, clip);
+        });
+
+    bankStates[(size_t)bank].store(resident);
+}
+
+bool ClipBankPager::isClaimed(int bank) const noexcept
+{
+    for (int i = 0; i < numSlots * kNumClaims; ++i)
+        if (claims[(size_t)i].load() == bank)
+            return true;
+    return false;
+}
+
+bool ClipBankPager::tryEvict(int bank)
+{
+    int expected = resident;
+    if (!bankStates[(size_t)bank].compare_exchange_strong(expected, evicting))
+        return false;
+
+    if (isClaimed(bank))
+    {
+        bankStates[(size_t)bank].store(resident);
+        return false;
+    }
+
+    DJAM_TRACE_SCOPE("evict bank", bank)
+    const juce::ScopedLock sl(evictionLock);
+
+    const int first = bank * kClipsPerBank;
+    const int count = juce::jmin(kClipsPerBank, numFiles - first);
+    for (int i = 0; i < count; ++i)
+        (*clips)[(size_t)(first + i)].unload();
+
+    bankStates[(size_t)bank].store(absent);
+    return true;
+}
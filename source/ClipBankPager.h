@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <juce_core/juce_core.h>
+
+#include "DJamClip.h"
+#include "ClipCache.h"
+
+/**
+ * Keeps only the banks the slots use in memory.
+ *
+ * The pack is a catalogue of files split into fixed banks of kClipsPerBank
+ * clips; clip index = bank * kClipsPerBank + position. Every file has a
+ * DJamClip entry from the start, but its audio is only loaded while the bank
+ * is resident. A background thread loads the banks slots ask for and evicts
+ * the least recently wanted ones beyond a small budget.
+ *
+ * Eviction can't race playback: before starting a clip the audio thread
+ * claims its bank, and the loader only frees a bank after marking it as
+ * evicting and finding no claim on it. Both sides use sequentially
+ * consistent atomics, so at least one of them sees the other and backs off.
+ */
+class ClipBankPager : private juce::Thread
+{
+public:
+    static constexpr int kClipsPerBank = 128;
+    static constexpr int kMaxBanks = 512;
+    static constexpr int kNoBank = -1;      // takes and invalid clips: always playable
+
+    /** What a slot holds a bank for: the clip playing, and the one lined up after it. */
+    enum Claim { activeClaim = 0, nextClaim, kNumClaims };
+
+    ClipBankPager(int numSlots, const ClipCache& cache);
+    ~ClipBankPager() override;
+
+    /**
+     * Message thread, audio stopped. Takes the catalogue (`files[i]` backs
+     * `clips[i]`); nothing is loaded yet. `clips` must not reallocate until
+     * release().
+     */
+    void prepare(std::vector<DJamClip>& clips, const juce::Array<juce::File>& files, double sampleRate);
+
+    /** Stops the loader and frees every resident bank. */
+    void release();
+
+    int getNumBanks() const noexcept { return numBanks; }
+    int getNumResidentBanks() const noexcept;
+
+    /** File name of a pack clip, resident or not (message thread). */
+    juce::String getClipName(int clip) const { return clip >= 0 && clip < numFiles ? files[clip].getFileNameWithoutExtension() : juce::String(); }
+
+    /** Bank of a pack clip, or kNoBank for takes and out-of-range indices. */
+    int bankOf(int clip) const noexcept { return clip >= 0 && clip < numFiles ? clip / kClipsPerBank : kNoBank; }
+
+    /** The bank a slot is pointed at; the loader fetches it in the background (any thread). */
+    void setWantedBank(int slot, int bank) noexcept;
+
+    /** Loads every wanted or claimed bank on the calling thread, then starts the background loader. */
+    void loadWantedBanks();
+
+    /** True once the bank's audio is loaded and until it is picked for eviction (any thread). */
+    bool isResident(int bank) const noexcept;
+
+    /**
+     * Audio thread: holds `bank` for `slot` before one of its clips is armed or
+     * restored. Fails (and leaves the previous claim) if the bank isn't resident.
+     */
+    bool claim(int slot, Claim which, int bank) noexcept;
+
+    /** Audio thread: re-states claims the slot already holds (or drops them with kNoBank). */
+    void keepClaim(int slot, Claim which, int bank) noexcept;
+
+    /** Called on a loader thread after each pack clip loads (several at once: loads run in parallel). */
+    std::function<void(int clip, const DJamClip&)> onClipLoaded;
+
+    /** Held while a bank is freed; take it to read a resident clip from another thread. */
+    const juce::CriticalSection& getEvictionLock() const noexcept { return evictionLock; }
+
+private:
+    enum BankState : int { absent = 0, loading, resident, evicting };
+
+    void run() override;
+    void service();
+    void loadBank(int bank);
+    bool tryEvict(int bank);
+    bool isClaimed(int bank) const noexcept;
+
+    const ClipCache& cache;
+    const int numSlots;
+    const int residentBudget;   // banks kept once nothing wants them any more, slots' banks included
+
+    std::vector<DJamClip>* clips = nullptr;
+    juce::Array<juce::File> files;
+    double sampleRate = 0.0;
+    int numFiles = 0;
+    int numBanks = 0;
+
+    std::unique_ptr<std::atomic<int>[]> bankStates;
+    std::vector<juce::uint32> lastWanted;          // loader thread: service() stamp of the last time wanted
+    juce::uint32 serviceCount = 0;
+
+    std::unique_ptr<std::atomic<int>[]> wantedBanks;    // per slot
+    std::unique_ptr<std::atomic<int>[]> claims;         // per slot and Claim
+
+    juce::CriticalSection evictionLock;
+
+    static constexpr int kPollIntervalMs = 20;
+    static constexpr int kSpareBanks = 4;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipBankPager)
+};
@@ -0,0 +1,159 @@
+#include "ClipBrowser.h"
+
+ClipBrowser::ClipBrowser(DJAM0AudioProcessor& p)
+    : processor(p)
+{
+    queryBox.setTextToShowWhenEmpty("Search clips: name, folder, bpm:120, bpm:118-124, bars:4, key:am",
+        juce::Colours::grey);
+    queryBox.onTextChange = [this] { runQuery(); };
+    queryBox.onReturnKey = [this]
+        {
+            if (resultList.getSelectedRow() < 0 && !rows.empty())
+                resultList.selectRow(0);
+            launchSelected();
+        };
+    addAndMakeVisible(queryBox);
+
+    for (int s = 0; s < DJAM0AudioProcessor::getNumSlots(); ++s)
+        slotSelect.addItem("Slot " + juce::String(s + 1), s + 1);
+    slotSelect.setSelectedId(1, juce::dontSendNotification);
+    slotSelect.setTooltip("Slot the chosen clip is queued in");
+    addAndMakeVisible(slotSelect);
+
+    resultList.setRowHeight(22);
+    resultList.setMultipleSelectionEnabled(false);
+    addAndMakeVisible(resultList);
+
+    addAndMakeVisible(statusLabel);
+    addAndMakeVisible(followEditor);
+}
+
+void ClipBrowser::refresh()
+{
+    // New clips or metadata (banks analysed as they load) can change which clips match
+    if (processor.getClipSearch().getVersion() != indexVersion)
+        runQuery(true);
+    else
+        resultList.repaint();
+
+    followEditor.refresh();
+}
+
+void ClipBrowser::runQuery(bool keepView)
+{
+    const auto& index = processor.getClipSearch();
+    indexVersion = index.getVersion();
+    indexedClips = index.getNumClips();
+
+    const int selectedRow = resultList.getSelectedRow();
+    const int selectedClip = keepView && selectedRow >= 0 && selectedRow < (int)rows.size()
+        ? rows[(size_t)selectedRow].clip : -1;
+
+    const auto results = index.search(queryBox.getText(), kMaxResults);
+
+    rows.clear();
+    rows.reserve(results.size());
+    for (const auto& r : results)
+        rows.push_back({ r.clip, processor.getClipInfo(r.clip).name });
+
+    resultList.updateContent();
+    resultList.deselectAllRows();
+    if (keepView)
+    {
+        const auto kept = std::find_if(rows.begin(), rows.end(),
+            [selectedClip](const Row& r) { return r.clip == selectedClip; });
+        if (selectedClip >= 0 && kept != rows.end())
+            resultList.selectRow((int)(kept - rows.begin()), true);
+    }
+    else
+    {
+        resultList.scrollToEnsureRowIsOnscreen(0);
+    }
+    resultList.repaint();
+
+    juce::String status;
+    status << (int)rows.size() << (rows.size() == (size_t)kMaxResults ? "+" : "") << " of " << indexedClips << " clips";
+    statusLabel.setText(status, juce::dontSendNotification);
+}
+
+void ClipBrowser::launchSelected()
+{
+    const int row = resultList.getSelectedRow();
+    if (row < 0 || row >= (int)rows.size())
+        return;
+
+    processor.requestClip(slotSelect.getSelectedId() - 1, rows[(size_t)row].clip);
+}
+
+void ClipBrowser::paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool selected)
+{
+    if (row < 0 || row >= (int)rows.size())
+        return;
+
+    const auto& lf = getLookAndFeel();
+    if (selected)
+        g.fillAll(lf.findColour(juce::TextEditor::highlightColourId));
+
+    const auto& entry = rows[(size_t)row];
+    const auto& index = processor.getClipSearch();
+    const auto meta = index.getMetadata(entry.clip);
+
+    auto r = juce::Rectangle<int>(0, 0, width, height).reduced(6, 0);
+    g.setColour(lf.findColour(juce::ListBox::textColourId));
+    g.setFont(14.0f);
+
+    const int bank = entry.clip / DJAM0AudioProcessor::kClipsPerBank;
+    const int pos = entry.clip % DJAM0AudioProcessor::kClipsPerBank;
+    g.drawText(juce::String(bank) + ":" + juce::String(pos).paddedLeft('0', 3), r.removeFromLeft(60), juce::Justification::centredLeft);
+
+    g.drawText(index.getKey(entry.clip), r.removeFromRight(40), juce::Justification::centredRight);
+    g.drawText(meta.bars > 0 ? juce::String(meta.bars) + " bars" : juce::String(), r.removeFromRight(60), juce::Justification::centredRight);
+    g.drawText(meta.bpm > 0.0f ? juce::String(meta.bpm, 1) + " bpm" : juce::String(), r.removeFromRight(80), juce::Justification::centredRight);
+
+    g.drawText(entry.name, r.reduced(4, 0), juce::Justification::centredLeft, true);
+}
+
+void ClipBrowser::listBoxItemDoubleClicked(int row, const juce::MouseEvent&)
+{
+    resultList.selectRow(row);
+    launchSelected();
+}
+
+void ClipBrowser::selectedRowsChanged(int lastRowSelected)
+{
+    followEditor.setClip(lastRowSelected >= 0 && lastRowSelected < (int)rows.size() ? rows[(size_t)lastRowSelected].clip : -1);
+}
+
+void ClipBrowser::returnKeyPressed(int)
+{
+    launchSelected();
+}
+
+void ClipBrowser::paint(juce::Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+}
+
+void ClipBrowser::resized()
+{
+    auto r = getLocalBounds().reduced(4);
+    auto top = r.removeFromTop(26);
+
+    slotSelect.setBounds(top.removeFromRight(100));
+    top.removeFromRight(4);
+    queryBox.setBounds(top);
+
+    statusLabel.setBounds(r.removeFromBottom(22));
+    followEditor.setBounds(r.removeFromBottom(28));
+    r.removeFromTop(4);
+    resultList.setBounds(r);
+}
+
+void ClipBrowser::visibilityChanged()
+{
+    if (isVisible())
+    {
+        runQuery();
+        queryBox.grabKeyboardFocus();
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "PluginProcessor.h"
+#include "FollowActionEditor.h"
+
+/**
+ * Editor page for finding a clip in a large pack: type to search the pack's
+ * ClipSearchIndex (names, folders, tempo and key filters), then double-click
+ * or press return to queue the clip in the chosen slot. Results update on
+ * every keystroke; the list only paints the rows in view. The selected
+ * clip's follow action is edited in the strip below the list.
+ */
+class ClipBrowser : public juce::Component,
+                    private juce::ListBoxModel
+{
+public:
+    explicit ClipBrowser(DJAM0AudioProcessor& processor);
+
+    /** Picks up a reloaded pack and metadata that arrived since the last call (editor frame callback). */
+    void refresh();
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    struct Row
+    {
+        int clip = -1;
+        juce::String name;
+    };
+
+    /** Searches again; `keepView` holds the selection and scroll (the index changed, not the query). */
+    void runQuery(bool keepView = false);
+    void launchSelected();
+
+    // ListBoxModel
+    int getNumRows() override { return (int)rows.size(); }
+    void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool selected) override;
+    void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override;
+    void selectedRowsChanged(int lastRowSelected) override;
+    void returnKeyPressed(int lastRowSelected) override;
+
+    DJAM0AudioProcessor& processor;
+
+    juce::TextEditor queryBox;
+    juce::ComboBox slotSelect;
+    juce::ListBox resultList{ "Clips", this };
+    juce::Label statusLabel;
+    FollowActionEditor followEditor{ processor };
+
+    std::vector<Row> rows;
+    int indexedClips = -1;      // pack size the results were computed for
+    int indexVersion = -1;      // ClipSearchIndex::getVersion() the results were computed for
+
+    static constexpr int kMaxResults = 500;
+};
@@ -0,0 +1,26 @@
+#include "ClipCache.h"
+
+ClipCache::ClipCache(const juce::File& cacheFolder)
+    : folder(cacheFolder != juce::File()
+        ? cacheFolder
+        : juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("D-Jam").getChildFile("ClipCache"))
+{
+}
+
+juce::File ClipCache::getEntryFile(const juce::File& clipFile, const juce::String& extension) const
+{
+    // Path + size + mtime: a changed file lands on a new key
+    const juce::String identity = clipFile.getFullPathName()
+        + "|" + juce::String(clipFile.getSize())
+        + "|" + juce::String(clipFile.getLastModificationTime().toMilliseconds());
+
+    const auto key = juce::String::toHexString((juce::int64)identity.hashCode64());
+    return folder.getChildFile(key + extension);
+}
+
+void ClipCache::clear() const
+{
+    if (folder.isDirectory())
+        folder.deleteRecursively();
+}
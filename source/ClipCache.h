@@ -0,0 +1,28 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+/**
+ * On-disk cache of per-clip data derived at load time (waveform overviews,
+ * analysis results, ...).
+ *
+ * Entries are keyed by the clip file's path, size and modification time, so
+ * an edited or replaced file simply misses and gets rebuilt. Every entry kind
+ * gets its own extension next to the same key.
+ */
+class ClipCache
+{
+public:
+    /** Uses `<user app data>/D-Jam/ClipCache` unless another folder is given. */
+    explicit ClipCache(const juce::File& folder = {});
+
+    const juce::File& getFolder() const noexcept { return folder; }
+
+    /** Cache file for `clipFile` with the given entry extension (e.g. ".djov"). */
+    juce::File getEntryFile(const juce::File& clipFile, const juce::String& extension) const;
+
+    /** Deletes every cached entry. */
+    void clear() const;
+
+private:
+    juce::File folder;
+};
@@ -0,0 +1,57 @@
+#include "ClipId.h"
+
+static constexpr juce::uint32 kClipIdMagic = 0x44494a44; // "DJID"
+static constexpr juce::uint32 kClipIdVersion = 1;
+
+ClipId ClipId::fromFileContent(const juce::File& file)
+{
+    juce::FileInputStream in(file);
+    if (in.failedToOpen())
+        return {};
+
+    const auto digest = juce::SHA256(in).getRawData();
+
+    ClipId id;
+    for (int i = 0; i < 8; ++i)
+        id.value = (id.value << 8) | (juce::uint8)digest[(size_t)i];
+
+    // Zero is reserved for "none"
+    if (id.value == 0)
+        id.value = 1;
+
+    return id;
+}
+
+bool ClipId::save(const juce::File& file) const
+{
+    if (!isValid() || !file.getParentDirectory().createDirectory())
+        return false;
+
+    juce::FileOutputStream out(file);
+    if (out.failedToOpen())
+        return false;
+
+    out.setPosition(0);
+    out.truncate();
+
+    out.writeInt((int)kClipIdMagic);
+    out.writeInt((int)kClipIdVersion);
+    out.writeInt64((juce::int64)value);
+
+    return out.getStatus().wasOk();
+}
+
+bool ClipId::load(const juce::File& file)
+{
+    constexpr juce::int64 kEntrySize = 4 + 4 + 8;
+
+    juce::FileInputStream in(file);
+    if (in.failedToOpen() || in.getTotalLength() != kEntrySize)
+        return false;
+
+    if ((juce::uint32)in.readInt() != kClipIdMagic || (juce::uint32)in.readInt() != kClipIdVersion)
+        return false;
+
+    value = (juce::uint64)in.readInt64();
+    return isValid();
+}
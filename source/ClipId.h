@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <juce_core/juce_core.h>
+
+/**
+ * Stable identity of a clip, derived from the file's bytes (the first 64
+ * bits of its SHA-256). Renaming, moving or adding files around it doesn't
+ * change it, so sessions that store IDs keep pointing at the same audio.
+ * Zero means "no clip" (live takes, empty slots).
+ *
+ * Hashing a file reads it once; the result is kept in the clip cache.
+ */
+struct ClipId
+{
+    juce::uint64 value = 0;
+
+    bool isValid() const noexcept { return value != 0; }
+    bool operator==(const ClipId& other) const noexcept { return value == other.value; }
+    bool operator!=(const ClipId& other) const noexcept { return value != other.value; }
+
+    juce::String toString() const { return juce::String::toHexString((juce::int64)value).paddedLeft('0', 16); }
+
+    /** Hashes the whole file; an unreadable file gives an invalid ID. Any thread. */
+    static ClipId fromFileContent(const juce::File& file);
+
+    /** Clip index I/O (ClipCache entry). */
+    bool save(const juce::File& file) const;
+    bool load(const juce::File& file);
+};
+
+template <>
+struct std::hash<ClipId>
+{
+    size_t operator()(const ClipId& id) const noexcept { return std::hash<juce::uint64>{}(id.value); }
+};
@@ -0,0 +1,177 @@
+#include "ClipLoudness.h"
+#include "KWeighting.h"
+#include <cmath>
+#include <vector>
+
+//===================== Integrated loudness =====================
+
+// BS.1770-4: 400 ms blocks, 75 % overlap, -70 LUFS absolute and -10 LU relative gates
+static constexpr double kBlockSeconds = 0.4;
+static constexpr int kBlockSteps = 4;
+static constexpr double kAbsoluteGate = -70.0;
+static constexpr double kRelativeGate = -10.0;
+
+static double energyToLufs(double meanSquare) noexcept
+{
+    return meanSquare > 0.0 ? -0.691 + 10.0 * std::log10(meanSquare) : -100.0;
+}
+
+static float measureIntegrated(const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    const int numSamples = audio.getNumSamples();
+    const int stepLength = juce::jmax(1, juce::roundToInt(sampleRate * kBlockSeconds / kBlockSteps));
+    const int numSteps = numSamples / stepLength;
+    if (numSteps < kBlockSteps)
+        return -100.0f;
+
+    // K-weighted energy per 100 ms step, summed over channels
+    std::vector<double> stepEnergy((size_t)numSteps, 0.0);
+    for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+    {
+        KWeightingFilter filter;
+        filter.prepare(sampleRate);
+
+        const float* data = audio.getReadPointer(ch);
+        for (int s = 0; s < numSteps; ++s)
+            stepEnergy[(size_t)s] += filter.processSumSquares(data + s * stepLength, stepLength);
+    }
+
+    // Overlapping 400 ms blocks from four consecutive steps
+    std::vector<double> blocks;
+    blocks.reserve((size_t)numSteps);
+    for (int s = 0; s + kBlockSteps <= numSteps; ++s)
+    {
+        double e = 0.0;
+        for (int k = 0; k < kBlockSteps; ++k)
+            e += stepEnergy[(size_t)(s + k)];
+        blocks.push_back(e / (stepLength * kBlockSteps));
+    }
+
+    auto gatedMean = [&blocks](double gateLufs)
+        {
+            double sum = 0.0;
+            int count = 0;
+            for (double b : blocks)
+                if (energyToLufs(b) > gateLufs)
+                    sum += b, ++count;
+            return count > 0 ? sum / count : 0.0;
+        };
+
+    const double ungated = gatedMean(kAbsoluteGate);
+    if (ungated <= 0.0)
+        return -100.0f;
+
+    return (float)energyToLufs(gatedMean(energyToLufs(ungated) + kRelativeGate));
+}
+
+//===================== True peak =====================
+
+// 4x polyphase interpolator: 48-tap Hann-windowed sinc, 12 taps per phase
+static constexpr int kOversample = 4;
+static constexpr int kTapsPerPhase = 12;
+
+static float measureTruePeak(const juce::AudioBuffer<float>& audio)
+{
+    constexpr int numTaps = kOversample * kTapsPerPhase;
+    const double pi = juce::MathConstants<double>::pi;
+
+    float coeffs[kOversample][kTapsPerPhase];
+    for (int t = 0; t < numTaps; ++t)
+    {
+        const double x = (t - (numTaps - 1) * 0.5) / kOversample;
+        const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(pi * x) / (pi * x);
+        const double window = 0.5 - 0.5 * std::cos(2.0 * pi * (t + 0.5) / numTaps);
+        coeffs[t % kOversample][t / kOversample] = (float)(sinc * window);
+    }
+
+    float peak = 0.0f;
+    for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+    {
+        const float* data = audio.getReadPointer(ch);
+        const int n = audio.getNumSamples();
+
+        // Sample peak, then the four interpolated points between each pair (even tap count: none coincide)
+        const auto range = juce::FloatVectorOperations::findMinAndMax(data, n);
+        peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+
+        for (int i = kTapsPerPhase; i < n; ++i)
+        {
+            const float* history = data + i - kTapsPerPhase;
+            for (int p = 0; p < kOversample; ++p)
+            {
+                float y = 0.0f;
+                for (int k = 0; k < kTapsPerPhase; ++k)
+                    y += coeffs[p][k] * history[kTapsPerPhase - 1 - k];
+                peak = juce::jmax(peak, std::abs(y));
+            }
+        }
+    }
+
+    return juce::Decibels::gainToDecibels(peak, -100.0f);
+}
+
+//===================== ClipLoudness =====================
+
+ClipLoudness ClipLoudness::measure(const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    ClipLoudness result;
+    if (audio.getNumSamples() == 0 || audio.getNumChannels() == 0 || sampleRate <= 0.0)
+        return result;
+
+    result.integratedLufs = measureIntegrated(audio, sampleRate);
+    result.truePeakDb = measureTruePeak(audio);
+    result.valid = true;
+    return result;
+}
+
+float ClipLoudness::getNormalisationGain() const noexcept
+{
+    if (!valid || integratedLufs <= -70.0f)
+        return 1.0f;
+
+    const float gainDb = juce::jmin(kTargetLufs - integratedLufs,
+        kTruePeakCeilingDb - truePeakDb,
+        kMaxGainDb);
+
+    return juce::Decibels::decibelsToGain(juce::jmax(-kMaxGainDb, gainDb));
+}
+
+static constexpr juce::uint32 kLoudnessMagic = 0x444c4a44; // "DJLD"
+static constexpr juce::uint32 kLoudnessVersion = 1;
+
+bool ClipLoudness::save(const juce::File& file) const
+{
+    if (!valid || !file.getParentDirectory().createDirectory())
+        return false;
+
+    juce::FileOutputStream out(file);
+    if (out.failedToOpen())
+        return false;
+
+    out.setPosition(0);
+    out.truncate();
+
+    out.writeInt((int)kLoudnessMagic);
+    out.writeInt((int)kLoudnessVersion);
+    out.writeFloat(integratedLufs);
+    out.writeFloat(truePeakDb);
+
+    return out.getStatus().wasOk();
+}
+
+bool ClipLoudness::load(const juce::File& file)
+{
+    constexpr juce::int64 kEntrySize = 4 * 4;
+
+    juce::FileInputStream in(file);
+    if (in.failedToOpen() || in.getTotalLength() != kEntrySize)
+        return false;
+
+    if ((juce::uint32)in.readInt() != kLoudnessMagic || (juce::uint32)in.readInt() != kLoudnessVersion)
+        return false;
+
+    integratedLufs = in.readFloat();
+    truePeakDb = in.readFloat();
+    valid = true;
+    return true;
+}
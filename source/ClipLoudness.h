@@ -0,0 +1,34 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * Offline loudness of one clip: BS.1770-4 integrated loudness (gated) and
+ * true peak (4x oversampled), plus the normalisation gain derived from them.
+ *
+ * Measured once per clip on the loader's worker threads and kept in the clip
+ * index next to the analysis, so packs are only measured on first load.
+ */
+struct ClipLoudness
+{
+    static constexpr float kTargetLufs = -14.0f;
+    static constexpr float kTruePeakCeilingDb = -1.0f;
+    static constexpr float kMaxGainDb = 24.0f;
+
+    float integratedLufs = -100.0f;
+    float truePeakDb = -100.0f;
+    bool valid = false;
+
+    /** Measures `audio` (all channels weighted 1.0, as for L/R). Any thread. */
+    static ClipLoudness measure(const juce::AudioBuffer<float>& audio, double sampleRate);
+
+    /**
+     * Linear gain bringing the clip to kTargetLufs without pushing its true
+     * peak over kTruePeakCeilingDb. Silent or unmeasured clips get unity.
+     */
+    float getNormalisationGain() const noexcept;
+
+    /** Clip index I/O (ClipCache entry). load() rejects other versions. */
+    bool save(const juce::File& file) const;
+    bool load(const juce::File& file);
+};
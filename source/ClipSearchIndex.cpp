@@ -0,0 +1,440 @@
+#include "ClipSearchIndex.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+static constexpr int kMaxFuzzyLength = 32;
+
+//===================== Tokens =====================
+
+juce::StringArray ClipSearchIndex::tokenize(const juce::String& text, bool withParts)
+{
+    juce::StringArray words;
+    juce::String current;
+
+    auto flush = [&]
+        {
+            if (current.isEmpty())
+                return;
+
+            words.add(current);
+
+            // "kick02" is also found by "kick" and "02"
+            if (withParts && current.containsAnyOf("0123456789") && current.containsAnyOf("abcdefghijklmnopqrstuvwxyz"))
+            {
+                juce::String part;
+                bool partIsDigits = false;
+
+                for (auto p = current.getCharPointer(); !p.isEmpty(); ++p)
+                {
+                    const bool isDigit = juce::CharacterFunctions::isDigit(*p);
+                    if (part.isNotEmpty() && isDigit != partIsDigits)
+                    {
+                        words.add(part);
+                        part.clear();
+                    }
+
+                    part += *p;
+                    partIsDigits = isDigit;
+                }
+
+                words.add(part);
+            }
+
+            current.clear();
+        };
+
+    const auto lower = text.toLowerCase();
+    for (auto p = lower.getCharPointer(); !p.isEmpty(); ++p)
+    {
+        if (juce::CharacterFunctions::isLetterOrDigit(*p) || *p == '#')
+            current += *p;
+        else
+            flush();
+    }
+
+    flush();
+    words.removeDuplicates(false);
+    return words;
+}
+
+juce::String ClipSearchIndex::parseKey(const juce::String& token)
+{
+    const auto lower = token.toLowerCase();
+    if (lower.isEmpty() || lower.length() > 6 || lower[0] < 'a' || lower[0] > 'g')
+        return {};
+
+    juce::String key = juce::String::charToString(lower[0]).toUpperCase();
+    int i = 1;
+    if (lower[1] == '#' || lower[1] == 'b')
+        key += lower[i++];
+
+    const auto mode = lower.substring(i);
+    if (mode == "m" || mode == "min" || mode == "minor")
+        return key + "m";
+    if (mode == "maj" || mode == "major")
+        return key;
+
+    // A bare letter is too common a word to read as a key; a sharp or flat isn't
+    return mode.isEmpty() && i == 2 ? key : juce::String();
+}
+
+void ClipSearchIndex::addToken(const std::string& text, int clip)
+{
+    const auto [it, inserted] = tokenLookup.try_emplace(text, (int)tokens.size());
+    if (inserted)
+    {
+        tokens.push_back({ text, {} });
+
+        if (tokensByLength.size() <= text.size())
+            tokensByLength.resize(text.size() + 1);
+        tokensByLength[text.size()].push_back(it->second);
+    }
+
+    auto& postings = tokens[(size_t)it->second].postings;
+    if (postings.empty() || postings.back() != clip)
+        postings.push_back(clip);
+}
+
+//===================== Building =====================
+
+void ClipSearchIndex::clear(int expectedClips)
+{
+    const juce::ScopedLock sl(lock);
+
+    clips.clear();
+    clips.reserve((size_t)juce::jmax(0, expectedClips));
+    tokens.clear();
+    tokenLookup.clear();
+    tokensByLength.clear();
+    numIndexed = 0;
+    ++version;
+
+    sortedTokens.clear();
+    wordScore.clear();
+    wordHits.clear();
+    totalScore.clear();
+    candidates.clear();
+}
+
+void ClipSearchIndex::addClip(int clip, const juce::String& name, const juce::StringArray& tags)
+{
+    if (clip < 0)
+        return;
+
+    auto words = tokenize(name);
+    for (const auto& tag : tags)
+        words.addArray(tokenize(tag));
+    words.removeDuplicates(false);
+
+    const juce::ScopedLock sl(lock);
+
+    if ((size_t)clip >= clips.size())
+        clips.resize((size_t)clip + 1);
+
+    auto& entry = clips[(size_t)clip];
+    if (entry.indexed)
+        return;
+
+    entry.indexed = true;
+    ++numIndexed;
+    ++version;
+
+    for (const auto& word : words)
+    {
+        addToken(word.toStdString(), clip);
+
+        if (entry.key.isEmpty())
+            entry.key = parseKey(word);
+    }
+}
+
+void ClipSearchIndex::setMetadata(int clip, const Metadata& metadata)
+{
+    if (clip < 0)
+        return;
+
+    const juce::ScopedLock sl(lock);
+
+    if ((size_t)clip >= clips.size())
+        clips.resize((size_t)clip + 1);
+
+    auto& entry = clips[(size_t)clip];
+    if (entry.metadata.bpm == metadata.bpm && entry.metadata.bars == metadata.bars)
+        return;
+
+    entry.metadata = metadata;
+    ++version;
+
+    if (!entry.metadataIndexed && metadata.bpm > 0.0f)
+    {
+        entry.metadataIndexed = true;
+        addToken(juce::String(juce::roundToInt(metadata.bpm)).toStdString() + "bpm", clip);
+
+        if (metadata.bars > 0)
+            addToken(juce::String(metadata.bars).toStdString() + "bars", clip);
+    }
+}
+
+int ClipSearchIndex::getNumClips() const
+{
+    const juce::ScopedLock sl(lock);
+    return numIndexed;
+}
+
+int ClipSearchIndex::getVersion() const
+{
+    const juce::ScopedLock sl(lock);
+    return version;
+}
+
+ClipSearchIndex::Metadata ClipSearchIndex::getMetadata(int clip) const
+{
+    const juce::ScopedLock sl(lock);
+    return clip >= 0 && (size_t)clip < clips.size() ? clips[(size_t)clip].metadata : Metadata{};
+}
+
+juce::String ClipSearchIndex::getKey(int clip) const
+{
+    const juce::ScopedLock sl(lock);
+    return clip >= 0 && (size_t)clip < clips.size() ? clips[(size_t)clip].key : juce::String();
+}
+
+//===================== Searching =====================
+
+void ClipSearchIndex::updateSortedTokens() const
+{
+    // Tokens added since the last search are sorted on their own and merged in
+    const size_t numSorted = sortedTokens.size();
+    if (numSorted == tokens.size())
+        return;
+
+    for (size_t i = numSorted; i < tokens.size(); ++i)
+        sortedTokens.push_back((int)i);
+
+    const auto byText = [this](int a, int b) { return tokens[(size_t)a].text < tokens[(size_t)b].text; };
+    std::sort(sortedTokens.begin() + (std::ptrdiff_t)numSorted, sortedTokens.end(), byText);
+    std::inplace_merge(sortedTokens.begin(), sortedTokens.begin() + (std::ptrdiff_t)numSorted, sortedTokens.end(), byText);
+}
+
+int ClipSearchIndex::boundedEditDistance(std::string_view a, std::string_view b, int maxDistance) noexcept
+{
+    const int n = (int)a.size(), m = (int)b.size();
+    if (std::abs(n - m) > maxDistance || n > kMaxFuzzyLength || m > kMaxFuzzyLength)
+        return maxDistance + 1;
+
+    int prev[kMaxFuzzyLength + 1], cur[kMaxFuzzyLength + 1];
+    for (int j = 0; j <= m; ++j)
+        prev[j] = j;
+
+    for (int i = 1; i <= n; ++i)
+    {
+        cur[0] = i;
+        int rowMin = i;
+
+        for (int j = 1; j <= m; ++j)
+        {
+            const int substitution = prev[j - 1] + (a[(size_t)i - 1] == b[(size_t)j - 1] ? 0 : 1);
+            cur[j] = std::min({ prev[j] + 1, cur[j - 1] + 1, substitution });
+            rowMin = std::min(rowMin, cur[j]);
+        }
+
+        // Every later row is at least this row's minimum
+        if (rowMin > maxDistance)
+            return maxDistance + 1;
+
+        std::copy(cur, cur + m + 1, prev);
+    }
+
+    return prev[m];
+}
+
+void ClipSearchIndex::scoreWord(const std::string& word) const
+{
+    auto hit = [this](const Token& token, float score)
+        {
+            for (const int clip : token.postings)
+            {
+                auto& s = wordScore[(size_t)clip];
+                if (s < 0.0f)
+                    wordHits.push_back(clip);
+                s = std::max(s, score);
+            }
+        };
+
+    // Prefix range of the sorted dictionary (the exact match sorts first in it)
+    auto it = std::lower_bound(sortedTokens.begin(), sortedTokens.end(), word,
+        [this](int id, const std::string& w) { return tokens[(size_t)id].text < w; });
+
+    for (; it != sortedTokens.end() && tokens[(size_t)*it].text.compare(0, word.size(), word) == 0; ++it)
+    {
+        const auto& token = tokens[(size_t)*it];
+        const float extra = (float)(token.text.size() - word.size()) / (float)token.text.size();
+        hit(token, token.text.size() == word.size() ? kExactScore : kPrefixScore - 0.5f * extra);
+    }
+
+    // Typos: against whole tokens of about the same length, and against the start of longer ones
+    if (word.size() < 3 || word.size() > (size_t)kMaxFuzzyLength)
+        return;
+
+    const int maxDistance = word.size() >= 7 ? 2 : 1;
+
+    for (size_t length = word.size() - (size_t)maxDistance; length < tokensByLength.size(); ++length)
+    {
+        for (const int id : tokensByLength[length])
+        {
+            const auto& token = tokens[(size_t)id];
+            if (token.text.compare(0, word.size(), word) == 0)
+                continue;   // already scored as a prefix
+
+            std::string_view text(token.text);
+            if (text.size() > word.size() + (size_t)maxDistance)
+                text = text.substr(0, word.size());
+
+            const int distance = boundedEditDistance(word, text, maxDistance);
+            if (distance <= maxDistance)
+                hit(token, kFuzzyScore / (float)distance);
+        }
+    }
+}
+
+bool ClipSearchIndex::parseFilter(const juce::String& word, Filter& filter)
+{
+    const int colon = word.indexOfChar(':');
+    if (colon <= 0 || colon == word.length() - 1)
+        return false;
+
+    const auto field = word.substring(0, colon);
+    const auto value = word.substring(colon + 1);
+
+    if (field == "key")
+    {
+        filter.kind = Filter::Kind::key;
+        filter.key = parseKey(value);
+        return filter.key.isNotEmpty();
+    }
+
+    if (field == "bpm")
+        filter.kind = Filter::Kind::bpm;
+    else if (field == "bars")
+        filter.kind = Filter::Kind::bars;
+    else
+        return false;
+
+    // "120" or "118-124"
+    const int dash = value.indexOfChar('-');
+    filter.low = value.getFloatValue();
+    filter.high = dash > 0 ? value.substring(dash + 1).getFloatValue() : filter.low;
+
+    // Analysed tempos aren't whole numbers: a single value means that BPM when rounded
+    if (dash <= 0 && filter.kind == Filter::Kind::bpm)
+    {
+        filter.low -= 0.5f;
+        filter.high += 0.5f;
+    }
+
+    return true;
+}
+
+bool ClipSearchIndex::passes(const ClipEntry& entry, const Filter& filter) const noexcept
+{
+    switch (filter.kind)
+    {
+        case Filter::Kind::bpm:  return entry.metadata.bpm > 0.0f && entry.metadata.bpm >= filter.low && entry.metadata.bpm <= filter.high;
+        case Filter::Kind::bars: return entry.metadata.bars >= filter.low && entry.metadata.bars <= filter.high;
+        case Filter::Kind::key:  return entry.key == filter.key;
+    }
+
+    return false;
+}
+
+std::vector<ClipSearchIndex::Result> ClipSearchIndex::search(const juce::String& query, int maxResults) const
+{
+    std::vector<Result> results;
+    if (maxResults <= 0)
+        return results;
+
+    // Words and filters; a query word isn't split into parts, so "kick02" must match as a whole
+    juce::StringArray words;
+    std::vector<Filter> filters;
+    for (const auto& word : juce::StringArray::fromTokens(query.toLowerCase(), " \t", ""))
+    {
+        Filter filter;
+        if (parseFilter(word, filter))
+            filters.push_back(filter);
+        else
+            words.addArray(tokenize(word, false));
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    updateSortedTokens();
+    wordScore.resize(clips.size(), -1.0f);
+    totalScore.resize(clips.size(), 0.0f);
+    candidates.clear();
+
+    if (words.isEmpty())
+    {
+        for (int clip = 0; clip < (int)clips.size(); ++clip)
+            if (clips[(size_t)clip].indexed)
+            {
+                totalScore[(size_t)clip] = 0.0f;
+                candidates.push_back(clip);
+            }
+    }
+
+    // Every word must match: the first seeds the candidates, the rest narrow them down
+    for (int w = 0; w < words.size(); ++w)
+    {
+        scoreWord(words[w].toStdString());
+
+        if (w == 0)
+        {
+            for (const int clip : wordHits)
+            {
+                totalScore[(size_t)clip] = wordScore[(size_t)clip];
+                candidates.push_back(clip);
+            }
+        }
+        else
+        {
+            size_t kept = 0;
+            for (const int clip : candidates)
+                if (wordScore[(size_t)clip] >= 0.0f)
+                {
+                    totalScore[(size_t)clip] += wordScore[(size_t)clip];
+                    candidates[kept++] = clip;
+                }
+            candidates.resize(kept);
+        }
+
+        for (const int clip : wordHits)
+            wordScore[(size_t)clip] = -1.0f;
+        wordHits.clear();
+
+        if (candidates.empty())
+            return results;
+    }
+
+    if (!filters.empty())
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](int clip)
+            {
+                return !std::all_of(filters.begin(), filters.end(),
+                    [&](const Filter& f) { return passes(clips[(size_t)clip], f); });
+            }), candidates.end());
+
+    const auto better = [this](int a, int b)
+        {
+            const float sa = totalScore[(size_t)a], sb = totalScore[(size_t)b];
+            return sa != sb ? sa > sb : a < b;
+        };
+
+    const auto n = std::min((size_t)maxResults, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + (std::ptrdiff_t)n, candidates.end(), better);
+
+    results.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        results.push_back({ candidates[i], totalScore[(size_t)candidates[i]] });
+
+    return results;
+}
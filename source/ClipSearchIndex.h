@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <juce_core/juce_core.h>
+
+/**
+ * Type-to-find over the clip pack: names, folder tags and metadata.
+ *
+ * Each clip contributes lower-case tokens: the words of its file name, the
+ * folders between the pack root and the file (tags), its key when the name
+ * carries one, and "<n>bpm" / "<n>bars" once it has been analysed. A query is
+ * split into words and a clip must match every word, either exactly, as a
+ * prefix, or (from three letters on) within a small edit distance. Words
+ * like bpm:120, bpm:118-124, bars:4 and key:am filter on metadata instead.
+ *
+ * Tokens map to posting lists, so a query touches the dictionary once per
+ * word and then only the clips that matched. Clips are added while the pack
+ * is catalogued, and their metadata arrives as banks load. Both can happen on
+ * any thread; search() runs on the message thread. A single lock covers
+ * everything and is held for the length of one call.
+ */
+class ClipSearchIndex
+{
+public:
+    struct Metadata
+    {
+        float bpm = 0.0f;   // 0 = not analysed yet
+        int bars = 0;
+    };
+
+    struct Result
+    {
+        int clip = -1;
+        float score = 0.0f;
+    };
+
+    /** Empties the index; `expectedClips` reserves room for a pack of that size. */
+    void clear(int expectedClips = 0);
+
+    /** Indexes a clip's name and tags (folder names). Adding a clip twice is ignored. */
+    void addClip(int clip, const juce::String& name, const juce::StringArray& tags);
+
+    /** Tempo and length, once known. The first valid value per clip also becomes searchable text. */
+    void setMetadata(int clip, const Metadata& metadata);
+
+    /** Best matches first (ties in clip order); an empty query lists the pack in order. */
+    std::vector<Result> search(const juce::String& query, int maxResults) const;
+
+    int getNumClips() const;
+
+    /** Changes whenever a clip or its metadata does, so a result list knows to search again. */
+    int getVersion() const;
+    Metadata getMetadata(int clip) const;
+
+    /** Key parsed from the clip's name ("Am", "F#", ...), or empty. */
+    juce::String getKey(int clip) const;
+
+    /**
+     * Lower-case words of `text`. With `withParts`, mixed letter/digit words
+     * also yield their parts ("loop01" -> loop01, loop, 01).
+     */
+    static juce::StringArray tokenize(const juce::String& text, bool withParts = true);
+
+    /** "am" -> "Am", "c#min" -> "C#m", "ebmaj" -> "Eb"; empty if `token` isn't a key. */
+    static juce::String parseKey(const juce::String& token);
+
+private:
+    struct Token
+    {
+        std::string text;
+        std::vector<int> postings;  // clips, each once
+    };
+
+    struct ClipEntry
+    {
+        bool indexed = false;
+        bool metadataIndexed = false;
+        Metadata metadata;
+        juce::String key;
+    };
+
+    struct Filter
+    {
+        enum class Kind { bpm, bars, key } kind = Kind::bpm;
+        float low = 0.0f, high = 0.0f;
+        juce::String key;
+    };
+
+    void addToken(const std::string& text, int clip);
+    void updateSortedTokens() const;
+    static bool parseFilter(const juce::String& word, Filter& filter);
+    bool passes(const ClipEntry& entry, const Filter& filter) const noexcept;
+    void scoreWord(const std::string& word) const;
+
+    /** Edit distance between a and b, or maxDistance + 1 once it is certain to exceed it. */
+    static int boundedEditDistance(std::string_view a, std::string_view b, int maxDistance) noexcept;
+
+    juce::CriticalSection lock;
+
+    std::vector<ClipEntry> clips;
+    std::vector<Token> tokens;
+    std::unordered_map<std::string, int> tokenLookup;
+    std::vector<std::vector<int>> tokensByLength;   // token ids per text length, for fuzzy matching
+    int numIndexed = 0;
+    int version = 0;
+
+    // Query state, reused between searches (under the lock)
+    mutable std::vector<int> sortedTokens;          // token ids by text, for prefix ranges
+    mutable std::vector<float> wordScore;           // per clip, -1 = no match for the current word
+    mutable std::vector<int> wordHits;              // clips touched by the current word
+    mutable std::vector<float> totalScore;          // per clip, summed over words
+    mutable std::vector<int> candidates;
+
+    static constexpr float kExactScore = 3.0f;
+    static constexpr float kPrefixScore = 2.0f;
+    static constexpr float kFuzzyScore = 1.0f;
+};
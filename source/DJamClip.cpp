@@ -3,21 +3,22 @@
 
 
 // Shared static AudioFormatManager for all DJamClips
+// (initialised once, thread-safe, as clips load in parallel)
 juce::AudioFormatManager& getSharedFormatManager()
 {
     static juce::AudioFormatManager fm;
-    static bool initialized = false;
+    static const bool initialized = []
+        {
+            fm.registerBasicFormats();  // WAV, AIFF, MP3, etc.
+            return true;
+        }();
 
-    if (!initialized)
-    {
-        fm.registerBasicFormats();  // WAV, AIFF, MP3, etc.
-        initialized = true;
-    }
+    juce::ignoreUnused(initialized);
     return fm;
 }
 
 
-void DJamClip::loadFromFile(const juce::File& file)
+void DJamClip::loadFromFile(const juce::File& file, double targetSR)
 {
     DBG("loadFromFile loading: " + file.getFileName());
 
@@ -28,31 +29,336 @@ void DJamClip::loadFromFile(const juce::File& file)
 
     if (reader != nullptr)
     {
-        buffer.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
-        reader->read(&buffer, 0, (int)reader->lengthInSamples, 0, true, true);
+        const int n = (int)reader->lengthInSamples;
+        buffer.setSize((int)reader->numChannels, n);
+        reader->read(&buffer, 0, n, 0, true, true);
+        sampleRate = reader->sampleRate;
+
+        // Optional resample if file sample rate != target sample rate
+        if (targetSR > 0.0 && reader->sampleRate != targetSR)
+        {
+            const double ratio = reader->sampleRate / targetSR;
+            const int newNumSamples = (int)((double)n / ratio);
+            juce::AudioBuffer<float> resampled(buffer.getNumChannels(), newNumSamples);
+
+            juce::LagrangeInterpolator interp;
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                interp.reset();
+                interp.process(ratio,
+                    buffer.getReadPointer(ch),
+                    resampled.getWritePointer(ch),
+                    newNumSamples);
+            }
+
+            buffer = std::move(resampled);
+            sampleRate = targetSR;
+        }
+
+        seam.setSize(buffer.getNumChannels(), kMaxSeamSamples);
+        buildSeam();
     }
     else
     {
         DBG("Failed to create reader for: " + file.getFullPathName());
     }
 }
+
+void DJamClip::unload()
+{
+    buffer = {};
+    seam = {};
+    seamLength = 0;
+    beatSlices = {};
+    transientSlices = {};
+    overview.reset();
+    loudness = {};
+    normalisationGain = 1.0f;
+}
+
 void DJamClip::render(juce::AudioBuffer<float>& output,
     int startSample, int numSamples,
-    int startBeat, int beatCount)
+    juce::int64 position,
+    LevelAccumulator* meter,
+    float gain,
+    bool crossfadeSeam) const
 {
-    if (!isLoaded())
+    const int total = buffer.getNumSamples();
+    if (!isLoaded() || total <= 0 || numSamples <= 0)
         return;
 
     const int channels = std::min(output.getNumChannels(), buffer.getNumChannels());
-    const int samplesPerBeat = buffer.getNumSamples() / numBeats;
-    const int startSampleInClip = startBeat * samplesPerBeat;
-    const int samplesToCopy = std::min(numSamples, buffer.getNumSamples() - startSampleInClip);
+
+    // Positions count from the downbeat; audio before it plays at the end of the cycle
+    int read = (int)(((position + downbeatOffset) % total + total) % total);
+
+    // Runs end at the seam (when crossfading) and at the end of the file, where reading wraps to 0
+    const int seamStart = crossfadeSeam && seamLength > 0 ? total - seamLength : total;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const bool inSeam = read >= seamStart;
+        const int run = std::min(numSamples - done, (inSeam ? total : seamStart) - read);
+        const auto& source = inSeam ? seam : buffer;
+        const int sourcePos = inSeam ? read - seamStart : read;
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            output.addFrom(ch, startSample + done, source, ch, sourcePos, run, gain);
+
+            if (meter != nullptr)
+                meter->add(source.getReadPointer(ch, sourcePos), run, gain);
+        }
+
+        done += run;
+        read += run;
+        if (read == total)
+            read = 0;
+    }
+}
+
+void DJamClip::renderRamped(juce::AudioBuffer<float>& output,
+    int startSample, int numSamples,
+    juce::int64 position,
+    float startGain, float endGain,
+    LevelAccumulator* meter,
+    bool crossfadeSeam) const noexcept
+{
+    const int total = buffer.getNumSamples();
+    if (!isLoaded() || total <= 0 || numSamples <= 0)
+        return;
+
+    const int read = (int)(((position + downbeatOffset) % total + total) % total);
+    addSliceRun(output, startSample, numSamples, read, false,
+        startGain, (endGain - startGain) / (float)numSamples, crossfadeSeam, meter);
+}
+
+void DJamClip::buildSeam() noexcept
+{
+    const int total = buffer.getNumSamples();
+    const int channels = juce::jmin(buffer.getNumChannels(), seam.getNumChannels());
+    seamLength = juce::jmin((int)(sampleRate * kSeamSeconds), total / 4, seam.getNumSamples());
+
+    if (seamLength < 2 || channels <= 0)
+    {
+        seamLength = 0;
+        return;
+    }
 
     for (int ch = 0; ch < channels; ++ch)
     {
-        output.addFrom(ch, startSample,
-            buffer,
-            ch, startSampleInClip,
-            samplesToCopy);
+        const float* src = buffer.getReadPointer(ch);
+        float* dst = seam.getWritePointer(ch);
+
+        // Where the tail should land: one step before the loop start, continuing its slope
+        const float target = 2.0f * src[0] - src[1];
+        const float step = target - src[total - 1];
+        const int tail = total - seamLength;
+
+        for (int i = 0; i < seamLength; ++i)
+        {
+            const float w = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::pi * (float)(i + 1) / (float)seamLength);
+            dst[i] = src[tail + i] + step * w;
+        }
+    }
+}
+
+void DJamClip::buildSlices()
+{
+    const int total = buffer.getNumSamples();
+    beatSlices.setBeatGrid(total, numBeats);
+
+    if (total <= 0)
+    {
+        transientSlices.clear();
+        return;
     }
+
+    // Detected in file positions; tables hold loop positions (from the downbeat), which add 0 themselves
+    auto starts = ClipAnalyzer::findTransients(buffer, sampleRate, SliceTable::kMaxSlices - 1);
+    for (auto& s : starts)
+        s = ((s - downbeatOffset) % total + total) % total;
+
+    transientSlices.setStarts(std::move(starts), total);
+}
+
+const SliceTable& DJamClip::getSlices(SliceSource source) const noexcept
+{
+    if (source == SliceSource::transients && transientSlices.getNumSlices() > 1)
+        return transientSlices;
+
+    return beatSlices;
+}
+
+void DJamClip::renderSlice(juce::AudioBuffer<float>& output,
+    int startSample, int numSamples,
+    const SliceTable& slices, int slice,
+    int offset, int segmentLength, bool reverse,
+    LevelAccumulator* meter,
+    float gain,
+    bool crossfadeSeam) const noexcept
+{
+    const int total = buffer.getNumSamples();
+    if (!isLoaded() || numSamples <= 0 || slice < 0 || slice >= slices.getNumSlices())
+        return;
+
+    const int sliceStart = slices.getStart(slice);
+    const int sliceLength = slices.getLength(slice);
+    const int playable = juce::jmin(sliceLength, segmentLength);
+    if (playable < 2)
+        return;
+
+    const int fade = juce::jlimit(1, playable / 2, juce::roundToInt(sampleRate * kSliceFadeSeconds));
+    const int end = juce::jmin(offset + numSamples, playable);
+
+    // Fade in, hold, fade out: each part is one straight gain line
+    for (int k = juce::jmax(0, offset); k < end;)
+    {
+        int partEnd;
+        float startGain, gainStep;
+
+        if (k < fade)
+        {
+            partEnd = fade;
+            gainStep = gain / (float)fade;
+            startGain = gainStep * (float)k;
+        }
+        else if (k < playable - fade)
+        {
+            partEnd = playable - fade;
+            gainStep = 0.0f;
+            startGain = gain;
+        }
+        else
+        {
+            partEnd = playable;
+            gainStep = -gain / (float)fade;
+            startGain = gain * (float)(playable - k) / (float)fade;
+        }
+
+        const int n = juce::jmin(end, partEnd) - k;
+        const juce::int64 loopPos = reverse ? (juce::int64)sliceStart + sliceLength - 1 - k
+                                            : (juce::int64)sliceStart + k;
+        const int read = (int)(((loopPos + downbeatOffset) % total + total) % total);
+
+        addSliceRun(output, startSample + k - offset, n, read, reverse, startGain, gainStep, crossfadeSeam, meter);
+        k += n;
+    }
+}
+
+void DJamClip::addSliceRun(juce::AudioBuffer<float>& output, int outStart, int count,
+    int read, bool reverse, float startGain, float gainStep,
+    bool crossfadeSeam, LevelAccumulator* meter) const noexcept
+{
+    const int total = buffer.getNumSamples();
+    const int channels = std::min(output.getNumChannels(), buffer.getNumChannels());
+    const int seamStart = crossfadeSeam && seamLength > 0 ? total - seamLength : total;
+
+    // Same runs as render(), walked in either direction
+    for (int done = 0; done < count;)
+    {
+        const bool inSeam = read >= seamStart;
+        const int regionStart = inSeam ? seamStart : 0;
+        const int run = std::min(count - done, reverse ? read - regionStart + 1 : (inSeam ? total : seamStart) - read);
+        const auto& source = inSeam ? seam : buffer;
+        const int sourcePos = read - regionStart;
+        const float g0 = startGain + gainStep * (float)done;
+        const float g1 = g0 + gainStep * (float)run;
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            if (!reverse)
+            {
+                output.addFromWithRamp(ch, outStart + done, source.getReadPointer(ch, sourcePos), run, g0, g1);
+            }
+            else
+            {
+                const float* src = source.getReadPointer(ch);
+                float* dst = output.getWritePointer(ch, outStart + done);
+                for (int i = 0; i < run; ++i)
+                    dst[i] += src[sourcePos - i] * (g0 + gainStep * (float)i);
+            }
+
+            if (meter != nullptr)
+                meter->add(source.getReadPointer(ch, reverse ? sourcePos - run + 1 : sourcePos), run, std::max(g0, g1));
+        }
+
+        done += run;
+        read = reverse ? read - run : read + run;
+        if (read == total)
+            read = 0;
+        else if (read < 0)
+            read = total - 1;
+    }
+}
+
+void DJamClip::applyAnalysis(const ClipAnalysis& analysis) noexcept
+{
+    if (!analysis.valid)
+        return;
+
+    bpm = analysis.bpm;
+    beatsPerBar = analysis.beatsPerBar;
+    barsLength = analysis.bars;
+    numBeats = barsLength * beatsPerBar;
+
+    // The cached offset may come from a session at another sample rate
+    const double scale = analysis.sampleRate > 0.0 ? sampleRate / analysis.sampleRate : 1.0;
+    downbeatOffset = juce::jlimit(0, juce::jmax(0, buffer.getNumSamples() - 1),
+        (int)std::lround(analysis.downbeatOffset * scale));
+}
+
+void DJamClip::warm(int numFrames) const noexcept
+{
+    if (!isLoaded())
+        return;
+
+    // One read per cache line is enough to fault the pages in
+    constexpr int kFloatsPerLine = 64 / (int)sizeof(float);
+    const int frames = std::min(numFrames, buffer.getNumSamples());
+    float sink = 0.0f;
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        const float* src = buffer.getReadPointer(ch);
+        for (int i = 0; i < frames; i += kFloatsPerLine)
+            sink += src[i];
+    }
+
+    static volatile float warmSink;
+    warmSink = sink;
+}
+
+void DJamClip::prepareTake(const juce::String& takeName, int numChannels, int capacitySamples, double sr)
+{
+    name = takeName;
+    sampleRate = sr;
+    takeCapacity = juce::jmax(0, capacitySamples);
+
+    // Full capacity up front; finishTake() only ever shrinks in place
+    buffer.setSize(juce::jmax(1, numChannels), takeCapacity);
+    buffer.clear();
+    seam.setSize(buffer.getNumChannels(), kMaxSeamSamples);
+    seamLength = 0;
+    beatSlices.reserve();
+    transientSlices.clear();
+}
+
+void DJamClip::finishTake(int lengthSamples, int bars, float takeBpm) noexcept
+{
+    const int length = juce::jlimit(0, takeCapacity, lengthSamples);
+    buffer.setSize(buffer.getNumChannels(), length, true, false, true);
+
+    barsLength = juce::jmax(1, bars);
+    bpm = takeBpm;
+    numBeats = barsLength * beatsPerBar;
+    downbeatOffset = 0;
+    loudness = {};
+    normalisationGain = 1.0f;
+
+    // Takes are cut on a bar, not at a zero crossing: they need the seam most
+    buildSeam();
+
+    // Beat grid only (no detection on the audio thread); fits the room prepareTake() reserved
+    beatSlices.setBeatGrid(length, numBeats);
 }
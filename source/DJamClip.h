@@ -1,8 +1,15 @@
 #pragma once
 
+#include <memory>
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "DJamHostSync.h"
+#include "Metering.h"
+#include "WaveformOverview.h"
+#include "ClipAnalyzer.h"
+#include "ClipLoudness.h"
+#include "ClipId.h"
+#include "SliceTable.h"
 
 /**
  * Represents a short, loopable audio clip loaded from disk.
@@ -15,29 +22,162 @@ public:
     DJamClip() = default;
 
     /** Loads a clip from file and optionally resamples to match targetSR. */
-    void loadFromFile(const juce::File& file);
+    void loadFromFile(const juce::File& file, double targetSR = 0.0);
 
     bool isLoaded() const noexcept { return buffer.getNumSamples() > 0; }
 
+    /** Frees the audio and overview (bank eviction); the name and ID stay. */
+    void unload();
+
+    /** name of the file */
+    const juce::String& getName() const noexcept { return name; }
+
+    /** Content-derived identity (invalid for live takes). */
+    ClipId getId() const noexcept { return id; }
+    void setId(ClipId newId) noexcept { id = newId; }
+
     int getLoopLengthBars() const noexcept { return barsLength; }
     float getBPM() const noexcept { return bpm; }
     int getBeatsPerBar() const noexcept { return beatsPerBar; }
     double getSampleRate() const noexcept { return sampleRate; }
+    int getNumSamples() const noexcept { return buffer.getNumSamples(); }
+    int getNumChannels() const noexcept { return buffer.getNumChannels(); }
+    const juce::AudioBuffer<float>& getAudio() const noexcept { return buffer; }
+
+    /** Min/max pyramid for the editor (shared so a view can outlive a reload). */
+    std::shared_ptr<const WaveformOverview> getOverview() const noexcept { return overview; }
+    void setOverview(std::shared_ptr<const WaveformOverview> o) noexcept { overview = std::move(o); }
+
+    void setLoopLengthBars(int bars) noexcept { barsLength = bars; numBeats = bars * beatsPerBar; }
+
+    /** Samples from the file start to the first downbeat; playback loops from there. */
+    int getDownbeatOffset() const noexcept { return downbeatOffset; }
+
+    /** Adopts an offline analysis result (tempo, bar length, downbeat). */
+    void applyAnalysis(const ClipAnalysis& analysis) noexcept;
 
-    void setLoopLengthBars(int bars) noexcept { barsLength = bars; }
+    /** Loudness measured at load; its gain is applied by the caller of render(). */
+    const ClipLoudness& getLoudness() const noexcept { return loudness; }
+    void setLoudness(const ClipLoudness& l) noexcept { loudness = l; normalisationGain = l.getNormalisationGain(); }
+    float getNormalisationGain() const noexcept { return normalisationGain; }
 
-    /** Renders a bar-aligned clip into the audio buffer. */
+    /**
+     * Adds `numSamples` of the clip into `output` from `position`, in samples
+     * from the downbeat (any value; it wraps). The clip repeats as often as
+     * the block needs: the copy is split into contiguous runs at the loop
+     * end, so there is no per-sample wrap test. Scaled by `gain` (folded into
+     * the mix multiply, so it costs nothing per sample). If `meter` is given,
+     * the copied source runs are measured on the way. With `crossfadeSeam`,
+     * the last samples of the file come from the precomputed seam instead.
+     */
     void render(juce::AudioBuffer<float>& output,
         int startSample, int numSamples,
-        int startBeat, int beatCount);
+        juce::int64 position,
+        LevelAccumulator* meter = nullptr,
+        float gain = 1.0f,
+        bool crossfadeSeam = false) const;
+
+    /**
+     * render() with the gain ramped from `startGain` to `endGain` across the
+     * block, for fades the caller places itself (a loop wrapping away from
+     * the end of the file). Audio thread; never allocates.
+     */
+    void renderRamped(juce::AudioBuffer<float>& output,
+        int startSample, int numSamples,
+        juce::int64 position,
+        float startGain, float endGain,
+        LevelAccumulator* meter = nullptr,
+        bool crossfadeSeam = false) const noexcept;
+
+    /** Samples at the end of the file replaced by the seam crossfade (0 = none). */
+    int getSeamLength() const noexcept { return seamLength; }
+
+    //==================== Slices ====================
+
+    /** Builds the beat-grid and transient slice tables (loader thread, after applyAnalysis()). */
+    void buildSlices();
+
+    /** Slice points to play from; transients fall back to the beat grid when too few were found. */
+    const SliceTable& getSlices(SliceSource source) const noexcept;
+
+    /**
+     * Adds part of one slice-sequence segment into `output`: a segment of
+     * `segmentLength` samples plays `slice` of `slices` from its start (or,
+     * `reverse`, backwards from its end) and is silent once the slice runs
+     * out; this call covers segment samples [offset, offset + numSamples).
+     * Each segment fades in and out over kSliceFadeSeconds, so retriggers
+     * don't click. Audio thread; never allocates.
+     */
+    void renderSlice(juce::AudioBuffer<float>& output,
+        int startSample, int numSamples,
+        const SliceTable& slices, int slice,
+        int offset, int segmentLength, bool reverse,
+        LevelAccumulator* meter = nullptr,
+        float gain = 1.0f,
+        bool crossfadeSeam = false) const noexcept;
+
+    static constexpr double kSliceFadeSeconds = 0.002;
+
+    /**
+     * Touches the first `numFrames` of the clip so its pages are resident
+     * and cache-warm before it starts. Safe to call from the audio thread.
+     */
+    void warm(int numFrames) const noexcept;
+
+    //==================== Live takes ====================
+
+    /**
+     * Message thread: turns this clip into an empty take able to hold
+     * `capacitySamples` frames. This is the only allocation a take needs.
+     */
+    void prepareTake(const juce::String& takeName, int numChannels, int capacitySamples, double sr);
+
+    /** Frames available for recording into a prepared take. */
+    int getTakeCapacity() const noexcept { return takeCapacity; }
+
+    /** Direct write access for the recorder (audio thread). */
+    float* getTakeWritePointer(int channel) noexcept { return buffer.getWritePointer(channel); }
+
+    /** Audio thread: trims the take to what was recorded; never reallocates. */
+    void finishTake(int lengthSamples, int bars, float takeBpm) noexcept;
 
 private:
+    /**
+     * Precomputes the loop seam: the file's last samples bent, with a
+     * raised-cosine crossfade, from the tail onto a copy of it offset to meet
+     * the loop start, so a loop whose end doesn't match its start wraps
+     * without a step. Length and transients are untouched. Never allocates
+     * once `seam` has room for kMaxSeamSamples.
+     */
+    void buildSeam() noexcept;
+
+    /**
+     * Adds `count` samples from buffer index `read` on, forwards or
+     * backwards (wrapping at the file ends), with gain startGain + gainStep * i.
+     */
+    void addSliceRun(juce::AudioBuffer<float>& output, int outStart, int count,
+        int read, bool reverse, float startGain, float gainStep,
+        bool crossfadeSeam, LevelAccumulator* meter) const noexcept;
+
+    static constexpr double kSeamSeconds = 0.005;
+    static constexpr int kMaxSeamSamples = 2048;    // 5 ms up to 384 kHz
+
     juce::AudioBuffer<float> buffer;
+    juce::AudioBuffer<float> seam;      // replaces buffer's last seamLength samples when crossfading
+    int seamLength = 0;
+    SliceTable beatSlices;
+    SliceTable transientSlices;
     juce::String name;
+    ClipId id;
+    std::shared_ptr<const WaveformOverview> overview;
+    ClipLoudness loudness;
+    float normalisationGain = 1.0f;
 
     int barsLength = 1;
     int beatsPerBar = 4;
-    int numBeats = 16;
+    int numBeats = 4;           // barsLength * beatsPerBar
+    int downbeatOffset = 0;
     float bpm = 120.f;
     double sampleRate = 44100.0;
+    int takeCapacity = 0;
 };
@@ -9,9 +9,15 @@ bool getHostPhase(juce::AudioPlayHead* playHead, HostPhase& out)
     if (!playHead->getCurrentPosition(pos))
         return false;
 
-    out.bpm = (pos.bpm > 0.0 ? pos.bpm : out.bpm);
-    out.numerator = (pos.timeSigNumerator > 0 ? pos.timeSigNumerator : out.numerator);
+    // Odd hosts send 0, inf or NaN tempos and silly meters: keep the last good value
+    if (std::isfinite(pos.bpm) && pos.bpm >= kMinHostBpm && pos.bpm <= kMaxHostBpm)
+        out.bpm = pos.bpm;
+    if (pos.timeSigNumerator > 0 && pos.timeSigNumerator <= kMaxHostNumerator)
+        out.numerator = pos.timeSigNumerator;
     out.denominator = (pos.timeSigDenominator > 0 ? pos.timeSigDenominator : out.denominator);
+    if (!std::isfinite(pos.ppqPosition))
+        return false;
+
     out.isPlaying = pos.isPlaying;
     out.ppqPosition = pos.ppqPosition;
     out.currentSample = (juce::int64)pos.timeInSamples;
@@ -22,7 +28,7 @@ bool getHostPhase(juce::AudioPlayHead* playHead, HostPhase& out)
 int samplesToNextBar(const HostPhase& hp)
 {
     // Guard against invalid tempo
-    if (hp.bpm <= 0.0 || hp.sampleRate <= 0.0)
+    if (hp.bpm <= 0.0 || hp.sampleRate <= 0.0 || hp.numerator <= 0 || !std::isfinite(hp.ppqPosition))
         return 0;
 
     // Compute the number of beats per bar and beats elapsed
@@ -8,9 +8,8 @@
 struct HostPhase
 {
     double bpm = 120.0;
-    int numerator = 4, denominator = 4;
+    int numerator = 4, denominator = 4;   // a bar is `numerator` beats everywhere in the engine
     bool isPlaying = false;
-    int beatsPerBar = 4; // default time signature
     double ppqPosition = 0.0;      // Host beats from start
     juce::int64 currentSample = 0;       // Host sample position
     double sampleRate = 44100.0;
@@ -26,8 +25,17 @@ struct HostPhase
     }
 };
 
-/** Queries the host for current tempo, signature, and play state. */
+/** Tempo range accepted from the host; outside it the last good tempo is kept. */
+static constexpr double kMinHostBpm = 10.0;
+static constexpr double kMaxHostBpm = 1000.0;
+static constexpr int kMaxHostNumerator = 64;
+
+/**
+ * Queries the host for current tempo, signature, and play state.
+ * Returns false when there is no usable position (no play head, or a
+ * non-finite ppq), in which case the caller treats the block as stopped.
+ */
 bool getHostPhase(juce::AudioPlayHead* playHead, HostPhase& out);
 
-/** Computes the number of samples remaining until the next bar boundary. */
+/** Computes the number of samples remaining until the next bar boundary (>= 1), or 0 if the phase is unusable. */
 int samplesToNextBar(const HostPhase& hp);
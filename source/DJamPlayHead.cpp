@@ -0,0 +1,50 @@
+#include "DJamPlayHead.h"
+
+// A locate shorter than this (in beats) is treated as host jitter, not a jump
+static constexpr double kJumpToleranceBeats = 0.01;
+
+void DJamPlayHead::update(juce::AudioPlayHead* playHead, int blockSamples, double sampleRate)
+{
+    if (playHead == nullptr)
+        return;
+
+    const auto position = playHead->getPosition();
+    if (!position.hasValue())
+        return;
+
+    previousInfo = currentInfo;
+    playingPrev = playingNow;
+
+    juce::AudioPlayHead::CurrentPositionInfo info;
+    info.isPlaying = position->getIsPlaying();
+    info.bpm = position->getBpm().orFallback(previousInfo.bpm > 0.0 ? previousInfo.bpm : 120.0);
+    info.ppqPosition = position->getPpqPosition().orFallback(0.0);
+    info.timeInSamples = position->getTimeInSamples().orFallback(0);
+
+    if (const auto sig = position->getTimeSignature())
+    {
+        info.timeSigNumerator = sig->numerator;
+        info.timeSigDenominator = sig->denominator;
+    }
+
+    currentInfo = info;
+    playingNow = info.isPlaying;
+
+    if (playingNow && !playingPrev)
+    {
+        if (onStart) onStart(currentInfo);
+    }
+    else if (!playingNow && playingPrev)
+    {
+        if (onStop) onStop();
+    }
+    else if (playingNow && validLast
+        && std::abs(currentInfo.ppqPosition - expectedPPQ) > kJumpToleranceBeats)
+    {
+        if (onJump) onJump(lastPPQ, currentInfo.ppqPosition);
+    }
+
+    lastPPQ = currentInfo.ppqPosition;
+    expectedPPQ = lastPPQ + (sampleRate > 0.0 ? blockSamples * info.bpm / (60.0 * sampleRate) : 0.0);
+    validLast = playingNow;
+}
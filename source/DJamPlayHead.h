@@ -16,8 +16,10 @@ class DJamPlayHead
 public:
     DJamPlayHead() = default;
 
-    // Call this each block with the plugin's current playhead
-    void update(juce::AudioPlayHead* playHead);
+    // Call this each block with the plugin's current playhead, before rendering
+    // `blockSamples` at `sampleRate` (used to tell a locate from normal advance).
+    // Audio thread; the hooks are invoked in place, so they must be real-time safe.
+    void update(juce::AudioPlayHead* playHead, int blockSamples, double sampleRate);
 
     // Listener hooks  these fire only on change
     std::function<void(const juce::AudioPlayHead::CurrentPositionInfo&)> onStart;
@@ -36,5 +38,6 @@ private:
     bool playingNow = false;
     bool playingPrev = false;
     double lastPPQ = 0.0;
+    double expectedPPQ = 0.0;   // where the previous block should have left the transport
     bool validLast = false;
 };
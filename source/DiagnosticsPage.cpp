@@ -0,0 +1,109 @@
+#include "DiagnosticsPage.h"
+
+DiagnosticsPage::DiagnosticsPage(EngineProfiler& p)
+    : profiler(p)
+{
+    reportView.setMultiLine(true);
+    reportView.setReadOnly(true);
+    reportView.setCaretVisible(false);
+    reportView.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 13.0f, juce::Font::plain));
+    addAndMakeVisible(reportView);
+
+    resetButton.onClick = [this] { profiler.requestReset(); };
+    addAndMakeVisible(resetButton);
+
+    dumpButton.onClick = [this]
+        {
+            const auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                .getNonexistentChildFile("D-Jam Profile " + juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S"), ".txt");
+
+            statusLabel.setText(profiler.dumpToFile(file) ? "Saved " + file.getFullPathName()
+                                                          : juce::String("Could not write the profile"),
+                juce::dontSendNotification);
+        };
+    addAndMakeVisible(dumpButton);
+
+    traceButton.setClickingTogglesState(true);
+    traceButton.onClick = [this]
+        {
+            auto& trace = TraceRecorder::get();
+
+            if (traceButton.getToggleState())
+            {
+                traceFile = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                    .getNonexistentChildFile("D-Jam Trace " + juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S"), ".json");
+
+                if (!trace.start(traceFile))
+                {
+                    traceButton.setToggleState(false, juce::dontSendNotification);
+                    statusLabel.setText("Could not write the trace", juce::dontSendNotification);
+                    return;
+                }
+
+                statusLabel.setText("Recording trace...", juce::dontSendNotification);
+            }
+            else
+            {
+                trace.stop();
+                juce::String text = "Saved " + traceFile.getFullPathName();
+                if (const auto dropped = trace.getDroppedCount())
+                    text << " (" << (juce::int64)dropped << " events dropped)";
+                statusLabel.setText(text, juce::dontSendNotification);
+            }
+        };
+    addAndMakeVisible(traceButton);
+
+    addAndMakeVisible(statusLabel);
+
+#if !DJAM_PROFILE
+    reportView.setText("Profiling is not compiled into this build (configure with -DDJAM_PROFILE=ON).");
+    resetButton.setEnabled(false);
+    dumpButton.setEnabled(false);
+#endif
+}
+
+void DiagnosticsPage::refresh(const EngineSnapshot& snapshot)
+{
+#if DJAM_PROFILE
+    auto report = profiler.createReport();
+#else
+    juce::String report = "Profiling is not compiled into this build (configure with -DDJAM_PROFILE=ON).\n";
+#endif
+
+    // Inserts are timed in every build: what a chain costs is what sizes a many-slot setup
+    float total = 0.0f;
+    report << "\nInsert chains (share of the block budget)\n";
+    for (size_t i = 0; i < snapshot.slots.size(); ++i)
+    {
+        const float load = snapshot.slots[i].insertLoad;
+        total += load;
+        report << "  slot " << juce::String((int)i + 1).paddedLeft(' ', 3) << "  "
+               << (load > 0.0f ? juce::String(load * 100.0f, 2).paddedLeft(' ', 7) + " %" : juce::String("      -")) << "\n";
+    }
+    report << "  total     " << juce::String(total * 100.0f, 2).paddedLeft(' ', 7) << " %\n";
+
+    if (reportView.getText() != report)
+        reportView.setText(report, false);
+}
+
+void DiagnosticsPage::paint(juce::Graphics& g)
+{
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+}
+
+void DiagnosticsPage::resized()
+{
+    auto r = getLocalBounds().reduced(4);
+    auto buttons = r.removeFromBottom(26);
+
+    resetButton.setBounds(buttons.removeFromLeft(80));
+    buttons.removeFromLeft(4);
+    dumpButton.setBounds(buttons.removeFromLeft(110));
+    buttons.removeFromLeft(4);
+    traceButton.setBounds(buttons.removeFromLeft(110));
+    buttons.removeFromLeft(8);
+    statusLabel.setBounds(buttons);
+
+    r.removeFromBottom(4);
+    reportView.setBounds(r);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "EngineProfiler.h"
+#include "TraceRecorder.h"
+#include "EngineSnapshot.h"
+
+/**
+ * Editor page showing the EngineProfiler report: per-stage and per-slot
+ * latency percentiles, deadline misses and worst block load. Refreshed by
+ * the editor a few times a second while visible, along with each slot's
+ * insert-chain load. Also starts and stops a Chrome/Perfetto trace of the
+ * audio, loader and UI threads.
+ */
+class DiagnosticsPage : public juce::Component
+{
+public:
+    explicit DiagnosticsPage(EngineProfiler& profiler);
+
+    /** Re-reads the profiler and the slots' insert loads (`snapshot` covers every slot). */
+    void refresh(const EngineSnapshot& snapshot);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    EngineProfiler& profiler;
+
+    juce::TextEditor reportView;
+    juce::TextButton resetButton{ "Reset" }, dumpButton{ "Dump to file" }, traceButton{ "Record trace" };
+    juce::File traceFile;
+    juce::Label statusLabel;
+};
@@ -0,0 +1,177 @@
+#include "EngineProfiler.h"
+#include <bit>
+
+//===================== ProfileHistogram =====================
+
+int ProfileHistogram::bucketFor(juce::uint64 ns) noexcept
+{
+    if (ns < 4)
+        return (int)ns;
+
+    // Four buckets per octave: the two bits below the leading one pick the quarter
+    const int msb = (int)std::bit_width(ns) - 1;
+    const int quarter = (int)((ns >> (msb - 2)) & 3);
+    return juce::jmin(kNumBuckets - 1, msb * 4 + quarter);
+}
+
+double ProfileHistogram::bucketMidNs(int bucket) noexcept
+{
+    if (bucket < 4)
+        return (double)bucket;
+
+    const int msb = bucket / 4, quarter = bucket % 4;
+    const double low = std::ldexp(4.0 + quarter, msb - 2);
+    return low + std::ldexp(0.5, msb - 2);
+}
+
+void ProfileHistogram::add(juce::uint64 ns) noexcept
+{
+    // Single writer: plain load/store keeps this free of locked instructions
+    auto& bucket = counts[(size_t)bucketFor(ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sumNs.store(sumNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    if (ns > maxNs.load(std::memory_order_relaxed))
+        maxNs.store(ns, std::memory_order_relaxed);
+}
+
+void ProfileHistogram::reset() noexcept
+{
+    for (auto& c : counts)
+        c.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    sumNs.store(0, std::memory_order_relaxed);
+    maxNs.store(0, std::memory_order_relaxed);
+}
+
+ProfileHistogram::Snapshot ProfileHistogram::snapshot() const noexcept
+{
+    Snapshot s;
+    for (int i = 0; i < kNumBuckets; ++i)
+        s.counts[(size_t)i] = counts[(size_t)i].load(std::memory_order_relaxed);
+    s.count = count.load(std::memory_order_relaxed);
+    s.sumNs = sumNs.load(std::memory_order_relaxed);
+    s.maxNs = maxNs.load(std::memory_order_relaxed);
+    return s;
+}
+
+double ProfileHistogram::Snapshot::percentileNs(double p) const noexcept
+{
+    juce::uint64 total = 0;
+    for (auto c : counts)
+        total += c;
+    if (total == 0)
+        return 0.0;
+
+    const auto target = (juce::uint64)std::ceil(p / 100.0 * (double)total);
+    juce::uint64 seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i)
+    {
+        seen += counts[(size_t)i];
+        if (seen >= target)
+            return juce::jmin(bucketMidNs(i), (double)maxNs);
+    }
+
+    return (double)maxNs;
+}
+
+//===================== EngineProfiler =====================
+
+const char* EngineProfiler::getStageName(Stage stage) noexcept
+{
+    switch (stage)
+    {
+        case Stage::blockSetup:    return "block setup";
+        case Stage::slotRender:    return "slot render";
+        case Stage::barScheduling: return "bar scheduling";
+        case Stage::looperRecord:  return "looper record";
+        case Stage::publish:       return "publish";
+        case Stage::numStages:     break;
+    }
+    return "?";
+}
+
+void EngineProfiler::prepare(double newSampleRate, int newNumSlots)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    numSlots = juce::jlimit(0, kMaxSlots, newNumSlots);
+
+    // Cycle counter against the OS clock over ~20 ms
+    const auto ticks0 = juce::Time::getHighResolutionTicks();
+    const auto cycles0 = now();
+    juce::Thread::sleep(20);
+    const auto cycles1 = now();
+    const auto ticks1 = juce::Time::getHighResolutionTicks();
+
+    const double ns = juce::Time::highResolutionTicksToSeconds(ticks1 - ticks0) * 1.0e9;
+    nsPerCycle = cycles1 > cycles0 ? ns / (double)(cycles1 - cycles0) : 1.0;
+
+    requestReset();
+}
+
+void EngineProfiler::commit(const BlockScope& block) noexcept
+{
+    if (resetRequested.exchange(false, std::memory_order_relaxed))
+    {
+        for (auto& h : stages) h.reset();
+        for (auto& h : slots) h.reset();
+        blocks.reset();
+        deadlineMisses.store(0, std::memory_order_relaxed);
+        worstLoad.store(0.0f, std::memory_order_relaxed);
+    }
+
+    for (int s = 0; s < kNumStages; ++s)
+        stages[(size_t)s].add(toNs(block.stageCycles[(size_t)s]));
+
+    for (int i = 0; i < numSlots; ++i)
+        slots[(size_t)i].add(toNs(block.slotCycles[(size_t)i]));
+
+    const auto totalNs = toNs(now() - block.start);
+    blocks.add(totalNs);
+
+    // Deadline: the block's duration in real time
+    const double budgetNs = block.samples * 1.0e9 / sampleRate;
+    const float load = budgetNs > 0.0 ? (float)(totalNs / budgetNs) : 0.0f;
+
+    if (load >= 1.0f)
+        deadlineMisses.store(deadlineMisses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (load > worstLoad.load(std::memory_order_relaxed))
+        worstLoad.store(load, std::memory_order_relaxed);
+}
+
+static juce::String formatRow(const juce::String& name, const ProfileHistogram::Snapshot& s)
+{
+    auto us = [](double ns) { return juce::String(ns / 1000.0, 2).paddedLeft(' ', 10); };
+
+    return name.paddedRight(' ', 18)
+        + juce::String((juce::int64)s.count).paddedLeft(' ', 10)
+        + us(s.meanNs()) + us(s.percentileNs(50.0)) + us(s.percentileNs(99.0))
+        + us(s.percentileNs(99.9)) + us((double)s.maxNs) + "\n";
+}
+
+juce::String EngineProfiler::createReport() const
+{
+    juce::String report;
+    const auto block = getBlock();
+
+    report << "D-Jam engine profile (" << juce::String(sampleRate, 0) << " Hz)\n"
+           << "blocks: " << (juce::int64)block.count
+           << "   deadline misses: " << (juce::int64)getDeadlineMisses()
+           << "   worst load: " << juce::String(getWorstLoad() * 100.0f, 1) << " %\n\n"
+           << juce::String("stage").paddedRight(' ', 18) << "     count   mean us    p50 us    p99 us  p99.9 us    max us\n";
+
+    report << formatRow("whole block", block);
+    for (int s = 0; s < kNumStages; ++s)
+        report << formatRow(getStageName((Stage)s), getStage((Stage)s));
+
+    report << "\n";
+    for (int i = 0; i < numSlots; ++i)
+        report << formatRow("slot " + juce::String(i + 1), getSlot(i));
+
+    return report;
+}
+
+bool EngineProfiler::dumpToFile(const juce::File& file) const
+{
+    return file.replaceWithText(createReport());
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_core/juce_core.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+ #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+ #include <x86intrin.h>
+#endif
+
+// Compile-time switch: build with DJAM_PROFILE=1 (CMake option DJAM_PROFILE) to
+// time processBlock. When 0 the DJAM_PROFILE_* macros compile to nothing.
+#ifndef DJAM_PROFILE
+ #define DJAM_PROFILE 0
+#endif
+
+/**
+ * Latency histogram with quarter-octave buckets (1 ns .. ~4 s).
+ * Written by one thread (the audio thread) without read-modify-write
+ * atomics; readers take a relaxed copy whenever they like.
+ */
+class ProfileHistogram
+{
+public:
+    static constexpr int kNumBuckets = 128;
+
+    struct Snapshot
+    {
+        std::array<juce::uint32, kNumBuckets> counts{};
+        juce::uint64 count = 0, sumNs = 0, maxNs = 0;
+
+        double meanNs() const noexcept { return count > 0 ? (double)sumNs / (double)count : 0.0; }
+        double percentileNs(double p) const noexcept;
+    };
+
+    /** Writer thread only. */
+    void add(juce::uint64 ns) noexcept;
+    void reset() noexcept;
+
+    Snapshot snapshot() const noexcept;
+
+    static int bucketFor(juce::uint64 ns) noexcept;
+    static double bucketMidNs(int bucket) noexcept;
+
+private:
+    std::array<std::atomic<juce::uint32>, kNumBuckets> counts{};
+    std::atomic<juce::uint64> count{ 0 }, sumNs{ 0 }, maxNs{ 0 };
+};
+
+/**
+ * Per-stage and per-slot timing of processBlock, plus deadline tracking.
+ *
+ * Stages are timed with the CPU cycle counter (rdtsc / cntvct), summed over
+ * a block's sub-blocks in a stack-local BlockScope and committed once per
+ * block, so the audio thread only pays a few counter reads per stage. The
+ * editor's diagnostics page and dumpToFile() read the histograms.
+ */
+class EngineProfiler
+{
+public:
+    enum class Stage
+    {
+        blockSetup,     // host phase, transport edges, parameter pulls
+        slotRender,     // all slots, including their insert chains
+        barScheduling,  // follow actions, looper bar, flushAtBar, applyArmedStart
+        looperRecord,
+        publish,        // meters, loudness, playback snapshot
+        numStages
+    };
+
+    static constexpr int kNumStages = (int)Stage::numStages;
+    static constexpr int kMaxSlots = 64;
+
+    static const char* getStageName(Stage stage) noexcept;
+
+    /** Message thread: sets the budget and calibrates the cycle counter. */
+    void prepare(double sampleRate, int numSlots);
+
+    /** Any thread: asks the audio thread to clear everything at its next block. */
+    void requestReset() noexcept { resetRequested.store(true, std::memory_order_relaxed); }
+
+    static juce::uint64 now() noexcept
+    {
+       #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+       #elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+       #elif defined(__aarch64__)
+        juce::uint64 v;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+        return v;
+       #else
+        return (juce::uint64)juce::Time::getHighResolutionTicks();
+       #endif
+    }
+
+    /** Stack-local accumulator for one processBlock call. */
+    class BlockScope
+    {
+    public:
+        BlockScope(EngineProfiler& p, int numSamples) noexcept : profiler(p), samples(numSamples), start(now()) {}
+        ~BlockScope() noexcept { profiler.commit(*this); }
+
+        void stage(Stage s, juce::uint64 since) noexcept { stageCycles[(size_t)s] += now() - since; }
+        void slot(int index, juce::uint64 since) noexcept
+        {
+            if (index >= 0 && index < kMaxSlots)
+                slotCycles[(size_t)index] += now() - since;
+        }
+
+    private:
+        friend class EngineProfiler;
+        EngineProfiler& profiler;
+        int samples;
+        juce::uint64 start;
+        std::array<juce::uint64, kNumStages> stageCycles{};
+        std::array<juce::uint64, kMaxSlots> slotCycles{};
+    };
+
+    //==================== Readout (any thread) ====================
+
+    ProfileHistogram::Snapshot getStage(Stage s) const noexcept { return stages[(size_t)s].snapshot(); }
+    ProfileHistogram::Snapshot getSlot(int slot) const noexcept { return slots[(size_t)slot].snapshot(); }
+    ProfileHistogram::Snapshot getBlock() const noexcept { return blocks.snapshot(); }
+
+    juce::uint64 getDeadlineMisses() const noexcept { return deadlineMisses.load(std::memory_order_relaxed); }
+    float getWorstLoad() const noexcept { return worstLoad.load(std::memory_order_relaxed); }
+    int getNumSlots() const noexcept { return numSlots; }
+
+    /** Plain-text table of everything above. */
+    juce::String createReport() const;
+    bool dumpToFile(const juce::File& file) const;
+
+private:
+    void commit(const BlockScope& block) noexcept;
+    juce::uint64 toNs(juce::uint64 cycles) const noexcept { return (juce::uint64)((double)cycles * nsPerCycle); }
+
+    std::array<ProfileHistogram, kNumStages> stages;
+    std::array<ProfileHistogram, kMaxSlots> slots;
+    ProfileHistogram blocks;
+
+    std::atomic<juce::uint64> deadlineMisses{ 0 };
+    std::atomic<float> worstLoad{ 0.0f };
+    std::atomic<bool> resetRequested{ false };
+
+    double nsPerCycle = 1.0;
+    double sampleRate = 44100.0;
+    int numSlots = 0;
+};
+
+#if DJAM_PROFILE
+ #define DJAM_PROFILE_BLOCK(profiler, numSamples) EngineProfiler::BlockScope djamProfileBlock(profiler, numSamples);
+ #define DJAM_PROFILE_MARK(name)                  const juce::uint64 name = EngineProfiler::now();
+ #define DJAM_PROFILE_STAGE(stageName, mark)      djamProfileBlock.stage(EngineProfiler::Stage::stageName, mark);
+ #define DJAM_PROFILE_SLOT(index, mark)           djamProfileBlock.slot(index, mark);
+#else
+ #define DJAM_PROFILE_BLOCK(profiler, numSamples)
+ #define DJAM_PROFILE_MARK(name)
+ #define DJAM_PROFILE_STAGE(stageName, mark)
+ #define DJAM_PROFILE_SLOT(index, mark)
+#endif
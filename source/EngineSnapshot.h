@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include "LiveLooper.h"
+
+/**
+ * What the editor shows for one slot, captured once per UI frame.
+ *
+ * Filled from the processor's published atomics and parameter values, so
+ * capturing never locks or touches the ValueTree. Rows compare a fresh
+ * snapshot against the one they last drew and only update what changed.
+ */
+struct SlotSnapshot
+{
+    int activeClip = -1;        // playing now
+    int requestedClip = -1;     // bank and clip parameters
+    int pendingClip = -1;       // launch queued or armed for a coming bar, -1 = none
+    bool pendingReady = true;   // false while the pending clip's bank is still loading
+    int phaseSamples = 0;       // position in the active clip's loop
+    bool muted = false;
+    bool soloed = false;
+    LiveLooper::State record = LiveLooper::State::idle;
+    float insertLoad = 0.0f;    // insert chain's share of the block budget (diagnostics; not drawn by rows)
+
+    /** True when anything other than the playhead differs. */
+    bool labelsDiffer(const SlotSnapshot& other) const noexcept
+    {
+        return activeClip != other.activeClip || requestedClip != other.requestedClip
+            || pendingClip != other.pendingClip || pendingReady != other.pendingReady
+            || muted != other.muted || soloed != other.soloed || record != other.record;
+    }
+};
+
+/** One frame of engine state for the whole editor. */
+struct EngineSnapshot
+{
+    std::vector<SlotSnapshot> slots;
+};
@@ -0,0 +1,125 @@
+#include "FollowActionEditor.h"
+
+FollowActionEditor::FollowActionEditor(DJAM0AudioProcessor& p)
+    : processor(p)
+{
+    titleLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(titleLabel);
+
+    // Item ids are FollowActionType + 1
+    typeBox.addItemList({ "No follow", "Next", "Previous", "Random", "Specific", "Stop" }, 1);
+    typeBox.setTooltip("What happens once the clip has played for the follow time");
+    typeBox.onChange = [this] { commit(); };
+    addAndMakeVisible(typeBox);
+
+    afterLabel.setText("after", juce::dontSendNotification);
+    afterLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(afterLabel);
+
+    countSlider.setSliderStyle(juce::Slider::IncDecButtons);
+    countSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 40, 20);
+    countSlider.setRange(1.0, 64.0, 1.0);
+    countSlider.onValueChange = [this] { commit(); };
+    addAndMakeVisible(countSlider);
+
+    // Item ids are FollowUnit + 1
+    unitBox.addItemList({ "bars", "loops" }, 1);
+    unitBox.onChange = [this] { commit(); };
+    addAndMakeVisible(unitBox);
+
+    // Specific target: any clip in the pack, shown by name
+    targetSlider.setSliderStyle(juce::Slider::IncDecButtons);
+    targetSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 60, 20);
+    targetSlider.setTooltip("Clip that follows (pack index)");
+    targetSlider.onValueChange = [this] { commit(); };
+    addAndMakeVisible(targetSlider);
+
+    targetName.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(targetName);
+
+    setClip(-1);
+}
+
+void FollowActionEditor::setClip(int clipIndex)
+{
+    clip = clipIndex;
+
+    const bool enabled = clip >= 0;
+    for (auto* c : std::initializer_list<juce::Component*>{ &typeBox, &countSlider, &unitBox, &targetSlider })
+        c->setEnabled(enabled);
+
+    titleLabel.setText("Follow: " + (enabled ? processor.getClipInfo(clip).name : juce::String("(no clip selected)")),
+        juce::dontSendNotification);
+
+    showAction(enabled ? processor.getClipFollowAction(clip) : FollowAction{});
+}
+
+void FollowActionEditor::refresh()
+{
+    if (clip >= 0 && !sameAction(processor.getClipFollowAction(clip), shown))
+        showAction(processor.getClipFollowAction(clip));
+}
+
+void FollowActionEditor::showAction(const FollowAction& action)
+{
+    shown = action;
+
+    // The pack can have grown since the last clip was shown
+    targetSlider.setRange(0.0, juce::jmax(1.0, (double)processor.getClipSearch().getNumClips() - 1.0), 1.0);
+
+    typeBox.setSelectedId((int)action.type + 1, juce::dontSendNotification);
+    countSlider.setValue(action.count, juce::dontSendNotification);
+    unitBox.setSelectedId((int)action.unit + 1, juce::dontSendNotification);
+    targetSlider.setValue(juce::jmax(0, action.targetClip), juce::dontSendNotification);
+
+    const bool specific = action.type == FollowActionType::specific;
+    targetSlider.setVisible(specific);
+    targetName.setVisible(specific);
+    targetName.setText(specific ? processor.getClipInfo(action.targetClip).name : juce::String(),
+        juce::dontSendNotification);
+}
+
+void FollowActionEditor::commit()
+{
+    if (clip < 0)
+        return;
+
+    FollowAction action;
+    action.type = (FollowActionType)juce::jlimit(0, (int)FollowActionType::stop, typeBox.getSelectedId() - 1);
+    action.unit = (FollowUnit)juce::jlimit(0, (int)FollowUnit::loops, unitBox.getSelectedId() - 1);
+    action.count = (int)countSlider.getValue();
+    action.targetClip = action.type == FollowActionType::specific ? (int)targetSlider.getValue() : -1;
+
+    processor.setClipFollowAction(clip, action);
+
+    // An inactive action is stored as the default: keep the controls as set, ready for a type to be picked
+    if (action.isActive())
+    {
+        showAction(processor.getClipFollowAction(clip));
+    }
+    else
+    {
+        shown = processor.getClipFollowAction(clip);
+        targetSlider.setVisible(false);
+        targetName.setVisible(false);
+    }
+}
+
+bool FollowActionEditor::sameAction(const FollowAction& a, const FollowAction& b) noexcept
+{
+    return a.type == b.type && a.unit == b.unit && a.count == b.count && a.targetClip == b.targetClip;
+}
+
+void FollowActionEditor::resized()
+{
+    auto r = getLocalBounds();
+
+    titleLabel.setBounds(r.removeFromLeft(juce::jmin(220, r.getWidth() / 3)));
+    typeBox.setBounds(r.removeFromLeft(100).reduced(2));
+    afterLabel.setBounds(r.removeFromLeft(44));
+    countSlider.setBounds(r.removeFromLeft(90));
+    unitBox.setBounds(r.removeFromLeft(70).reduced(2));
+    r.removeFromLeft(8);
+    targetSlider.setBounds(r.removeFromLeft(100));
+    targetName.setBounds(r);
+}
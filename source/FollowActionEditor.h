@@ -0,0 +1,38 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "PluginProcessor.h"
+
+/**
+ * Strip on the Find page that edits one clip's follow action: what happens
+ * (next, previous, random, a specific clip, stop), after how many bars or
+ * loops, and for a specific action which clip follows. Every change goes
+ * through DJAM0AudioProcessor::setClipFollowAction, so it takes effect on
+ * the next bar and is saved with the session.
+ */
+class FollowActionEditor : public juce::Component
+{
+public:
+    explicit FollowActionEditor(DJAM0AudioProcessor& processor);
+
+    /** Edits `clipIndex`'s action; -1 disables the controls. */
+    void setClip(int clipIndex);
+
+    /** Follows changes made elsewhere (state restore); editor frame callback. */
+    void refresh();
+
+    void resized() override;
+
+private:
+    void showAction(const FollowAction& action);
+    void commit();
+
+    static bool sameAction(const FollowAction& a, const FollowAction& b) noexcept;
+
+    DJAM0AudioProcessor& processor;
+    int clip = -1;
+    FollowAction shown;
+
+    juce::Label titleLabel, afterLabel, targetName;
+    juce::ComboBox typeBox, unitBox;
+    juce::Slider countSlider, targetSlider;
+};
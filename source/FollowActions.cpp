@@ -0,0 +1,81 @@
+#include "FollowActions.h"
+
+// Layout: [63..32] targetClip + 1 | [31..16] count | [15..8] unit | [7..0] type
+juce::uint64 FollowActionTable::pack(const FollowAction& a) noexcept
+{
+    return ((juce::uint64)(juce::uint32)(a.targetClip + 1) << 32)
+         | ((juce::uint64)(juce::uint16)juce::jlimit(0, 0xffff, a.count) << 16)
+         | ((juce::uint64)a.unit << 8)
+         | (juce::uint64)a.type;
+}
+
+FollowAction FollowActionTable::unpack(juce::uint64 bits) noexcept
+{
+    FollowAction a;
+    a.type = (FollowActionType)(bits & 0xff);
+    a.unit = (FollowUnit)((bits >> 8) & 0xff);
+    a.count = (int)((bits >> 16) & 0xffff);
+    a.targetClip = (int)(juce::uint32)(bits >> 32) - 1;
+    return a;
+}
+
+void FollowActionTable::resize(int numClips)
+{
+    numEntries = juce::jmax(0, numClips);
+    entries.reset(numEntries > 0 ? new std::atomic<juce::uint64>[(size_t)numEntries] : nullptr);
+
+    const auto cleared = pack({});
+    for (int i = 0; i < numEntries; ++i)
+        entries[(size_t)i].store(cleared, std::memory_order_relaxed);
+}
+
+void FollowActionTable::set(int clip, const FollowAction& action) noexcept
+{
+    if (clip >= 0 && clip < numEntries)
+        entries[(size_t)clip].store(pack(action), std::memory_order_release);
+}
+
+FollowAction FollowActionTable::get(int clip) const noexcept
+{
+    if (clip < 0 || clip >= numEntries)
+        return {};
+
+    return unpack(entries[(size_t)clip].load(std::memory_order_acquire));
+}
+
+int FollowActionTable::resolveTarget(const FollowAction& action, int currentClip, juce::Random& rng,
+    int rangeStart, int rangeSize) const noexcept
+{
+    // A specific target is a pack index: the range doesn't apply to it
+    if (action.type == FollowActionType::specific)
+        return (action.targetClip >= 0 && action.targetClip < numEntries) ? action.targetClip : -1;
+
+    const int first = juce::jlimit(0, numEntries, rangeStart);
+    const int n = rangeSize < 0 ? numEntries - first : juce::jmin(rangeSize, numEntries - first);
+    if (n <= 0)
+        return -1;
+
+    const int local = currentClip - first;   // position within the range
+
+    switch (action.type)
+    {
+        case FollowActionType::next:     return first + ((local + 1) % n + n) % n;
+        case FollowActionType::previous: return first + ((local - 1) % n + n) % n;
+
+        case FollowActionType::random:
+        {
+            if (n == 1)
+                return first;
+
+            // Pick among the other n-1 clips so "random" always changes clip
+            const int pick = rng.nextInt(n - 1);
+            return first + (pick >= local ? pick + 1 : pick);
+        }
+
+        case FollowActionType::specific:
+        case FollowActionType::stop:
+        case FollowActionType::none:
+        default:
+            return -1;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <juce_core/juce_core.h>
+
+/** What a clip does once it has played for its follow time. */
+enum class FollowActionType : juce::uint8
+{
+    none = 0,
+    next,       // clip index + 1 (wraps within the clip's bank)
+    previous,   // clip index - 1 (wraps within the clip's bank)
+    random,     // any other clip in the bank
+    specific,   // FollowAction::targetClip
+    stop        // stop the slot
+};
+
+/** Unit of FollowAction::count. */
+enum class FollowUnit : juce::uint8
+{
+    bars = 0,
+    loops       // multiples of the slot's loop length
+};
+
+/**
+ * Per-clip follow action: "after `count` bars/loops, do `type`".
+ */
+struct FollowAction
+{
+    FollowActionType type = FollowActionType::none;
+    FollowUnit unit = FollowUnit::loops;
+    int count = 1;
+    int targetClip = -1;
+
+    bool isActive() const noexcept { return type != FollowActionType::none && count > 0; }
+
+    /** Number of whole bars until the action fires for a loop of `loopBars`. */
+    int barsUntilFollow(int loopBars) const noexcept
+    {
+        return unit == FollowUnit::loops ? count * juce::jmax(1, loopBars) : count;
+    }
+};
+
+/**
+ * Preallocated chain table mapping each clip in the bank to its follow action.
+ *
+ * Sized on the message thread when the bank is (re)loaded. Entries are packed
+ * into single atomics so the UI can edit them while the audio thread reads
+ * them, without locks or allocation.
+ */
+class FollowActionTable
+{
+public:
+    /** Reallocates for `numClips` entries, all cleared. Not real-time safe. */
+    void resize(int numClips);
+
+    int size() const noexcept { return numEntries; }
+
+    /** Stores an action for `clip` (ignored when out of range). */
+    void set(int clip, const FollowAction& action) noexcept;
+
+    /** Returns the action for `clip`, or an inactive one when out of range. */
+    FollowAction get(int clip) const noexcept;
+
+    /**
+     * Resolves the clip an action leads to from `currentClip`. next, previous
+     * and random stay within [rangeStart, rangeStart + rangeSize) (the clip's
+     * bank; a negative size means the whole table); specific targets may be
+     * anywhere. Returns -1 for stop (or when nothing valid can be picked).
+     */
+    int resolveTarget(const FollowAction& action, int currentClip, juce::Random& rng,
+        int rangeStart = 0, int rangeSize = -1) const noexcept;
+
+private:
+    static juce::uint64 pack(const FollowAction& a) noexcept;
+    static FollowAction unpack(juce::uint64 bits) noexcept;
+
+    std::unique_ptr<std::atomic<juce::uint64>[]> entries;
+    int numEntries = 0;
+};
@@ -0,0 +1,70 @@
+#include "InternalClock.h"
+#include "DJamHostSync.h"
+
+void InternalClock::prepare(double newSampleRate)
+{
+    if (newSampleRate <= 0.0 || newSampleRate == sampleRate)
+        return;
+
+    // Keep the beat, re-express the samples at the new rate
+    const double ppq = getPpqPosition();
+    sampleRate = newSampleRate;
+    samplePosition = (juce::int64)std::llround(ppq * 60.0 / bpm * sampleRate);
+    anchorSample = samplePosition;
+    anchorPpq = ppq;
+}
+
+void InternalClock::setTempo(double newBpm, int newNumerator) noexcept
+{
+    numerator = juce::jlimit(1, kMaxHostNumerator, newNumerator);
+
+    newBpm = juce::jlimit(kMinHostBpm, kMaxHostBpm, std::isfinite(newBpm) ? newBpm : bpm);
+    if (newBpm == bpm)
+        return;
+
+    reanchor();
+    bpm = newBpm;
+}
+
+void InternalClock::setRunning(bool shouldRun) noexcept
+{
+    if (shouldRun && !running)
+    {
+        samplePosition = anchorSample = 0;
+        anchorPpq = 0.0;
+    }
+
+    running = shouldRun;
+}
+
+void InternalClock::advance(int numSamples) noexcept
+{
+    if (running && numSamples > 0)
+        samplePosition += numSamples;
+}
+
+double InternalClock::getPpqPosition() const noexcept
+{
+    return anchorPpq + (double)(samplePosition - anchorSample) * bpm / (60.0 * sampleRate);
+}
+
+void InternalClock::reanchor() noexcept
+{
+    anchorPpq = getPpqPosition();
+    anchorSample = samplePosition;
+}
+
+juce::Optional<juce::AudioPlayHead::PositionInfo> InternalClock::getPosition() const
+{
+    const double ppq = getPpqPosition();
+
+    PositionInfo info;
+    info.setIsPlaying(running);
+    info.setBpm(bpm);
+    info.setTimeSignature(TimeSignature{ numerator, 4 });
+    info.setTimeInSamples(samplePosition);
+    info.setTimeInSeconds((double)samplePosition / sampleRate);
+    info.setPpqPosition(ppq);
+    info.setPpqPositionOfLastBarStart(std::floor(ppq / numerator) * numerator);
+    return info;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+/**
+ * Free-running transport for when there is no host to follow (the
+ * Standalone build, hosts without a play head) or the user wants the
+ * engine to be the master.
+ *
+ * It is an AudioPlayHead, so the engine reads it through exactly the path
+ * it reads a host's: getHostPhase(), DJamPlayHead's start/stop/jump edges
+ * and the bar-split scheduling in processBlock. Position is kept as a
+ * sample count since the last start; the beat position is measured from the
+ * last tempo change rather than summed block by block, so it doesn't drift.
+ *
+ * Audio thread only.
+ */
+class InternalClock : public juce::AudioPlayHead
+{
+public:
+    InternalClock() = default;
+
+    /** Audio stopped. The beat position survives a sample rate change. */
+    void prepare(double sampleRate);
+
+    /** Tempo and beats per bar (quarter notes), applied from the current position on. */
+    void setTempo(double bpm, int numerator) noexcept;
+
+    /** Starting always begins at bar 1, like a freshly started transport. */
+    void setRunning(bool shouldRun) noexcept;
+
+    /** Moves the transport past one rendered block (while running). */
+    void advance(int numSamples) noexcept;
+
+    bool isRunning() const noexcept { return running; }
+    double getBpm() const noexcept { return bpm; }
+    double getPpqPosition() const noexcept;
+
+    juce::Optional<PositionInfo> getPosition() const override;
+
+private:
+    void reanchor() noexcept;
+
+    double sampleRate = 44100.0;
+    double bpm = 120.0;
+    int numerator = 4;
+    bool running = false;
+
+    juce::int64 samplePosition = 0;     // since the last start
+    juce::int64 anchorSample = 0;       // position of the last tempo change...
+    double anchorPpq = 0.0;             // ...and the beat it fell on
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InternalClock)
+};
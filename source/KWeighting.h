@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cmath>
+#include <juce_core/juce_core.h>
+
+/**
+ * ITU-R BS.1770 K-weighting pre-filter (high shelf + RLB high-pass) for one
+ * channel. Coefficients are derived for any sample rate, following the
+ * analog prototypes in the standard.
+ */
+class KWeightingFilter
+{
+public:
+    void prepare(double sampleRate) noexcept
+    {
+        const double pi = juce::MathConstants<double>::pi;
+
+        // Stage 1: high shelf, +4 dB above ~1.7 kHz (head diffraction)
+        {
+            const double f0 = 1681.974450955533, G = 3.999843853973347, Q = 0.7071752369554196;
+            const double K = std::tan(pi * f0 / sampleRate);
+            const double Vh = std::pow(10.0, G / 20.0);
+            const double Vb = std::pow(Vh, 0.4996667741545416);
+            const double a0 = 1.0 + K / Q + K * K;
+
+            shelf = { (Vh + Vb * K / Q + K * K) / a0,
+                      2.0 * (K * K - Vh) / a0,
+                      (Vh - Vb * K / Q + K * K) / a0,
+                      2.0 * (K * K - 1.0) / a0,
+                      (1.0 - K / Q + K * K) / a0 };
+        }
+
+        // Stage 2: RLB high-pass at ~38 Hz
+        {
+            const double f0 = 38.13547087602444, Q = 0.5003270373238773;
+            const double K = std::tan(pi * f0 / sampleRate);
+            const double a0 = 1.0 + K / Q + K * K;
+
+            highPass = { 1.0, -2.0, 1.0,
+                         2.0 * (K * K - 1.0) / a0,
+                         (1.0 - K / Q + K * K) / a0 };
+        }
+
+        reset();
+    }
+
+    void reset() noexcept { shelf.reset(); highPass.reset(); }
+
+    /** Filters `n` samples and returns their weighted sum of squares. */
+    double processSumSquares(const float* data, int n) noexcept
+    {
+        double sum = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            const double y = highPass.process(shelf.process((double)data[i]));
+            sum += y * y;
+        }
+        return sum;
+    }
+
+private:
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        double process(double x) noexcept
+        {
+            // Transposed direct form II
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+
+        void reset() noexcept { z1 = z2 = 0.0; }
+    };
+
+    Biquad shelf, highPass;
+};
@@ -0,0 +1,54 @@
+#include "LevelMeter.h"
+
+// Display range: -60 dBFS .. 0 dBFS
+static constexpr float kMeterFloorDb = -60.0f;
+static constexpr double kPeakDecayPerSecond = 0.08; // fraction of the peak left after one second
+
+float LevelMeter::toDisplay(float linear) noexcept
+{
+    const float db = juce::Decibels::gainToDecibels(linear, kMeterFloorDb);
+    return juce::jlimit(0.0f, 1.0f, (db - kMeterFloorDb) / -kMeterFloorDb);
+}
+
+void LevelMeter::setLevels(float peak, float rms)
+{
+    // Decay by elapsed time so the refresh rate (timer or display vblank) doesn't matter
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const double elapsed = lastUpdateMs > 0.0 ? juce::jmin(0.25, (now - lastUpdateMs) * 0.001) : 0.0;
+    lastUpdateMs = now;
+
+    const float decay = (float)std::pow(kPeakDecayPerSecond, elapsed);
+    displayPeak = juce::jmax(toDisplay(peak), displayPeak * decay);
+    displayRms = toDisplay(rms);
+
+    // Sub-pixel changes are not worth a repaint
+    const float threshold = 1.0f / (float)juce::jmax(1, getWidth());
+    if (std::abs(displayPeak - drawnPeak) >= threshold || std::abs(displayRms - drawnRms) >= threshold)
+        repaint();
+}
+
+void LevelMeter::reset()
+{
+    displayPeak = displayRms = 0.0f;
+    lastUpdateMs = 0.0;
+    repaint();
+}
+
+void LevelMeter::paint(juce::Graphics& g)
+{
+    drawnPeak = displayPeak;
+    drawnRms = displayRms;
+
+    auto r = getLocalBounds().toFloat().reduced(1.0f);
+
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRect(r);
+
+    const auto rmsColour = displayPeak >= 1.0f ? juce::Colours::red : juce::Colours::limegreen;
+    g.setColour(rmsColour);
+    g.fillRect(r.withWidth(r.getWidth() * displayRms));
+
+    g.setColour(juce::Colours::white);
+    const float x = r.getX() + r.getWidth() * displayPeak;
+    g.drawLine(x, r.getY(), x, r.getBottom(), 1.5f);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+/**
+ * Horizontal level bar: RMS as the filled bar, peak as a decaying tick.
+ * Fed by the editor's refresh; only repaints when the drawn level moves.
+ */
+class LevelMeter : public juce::Component
+{
+public:
+    LevelMeter() = default;
+
+    /** Feeds one UI frame of linear peak/RMS values. */
+    void setLevels(float peak, float rms);
+
+    /** Drops the held peak and level, e.g. when the meter starts showing another channel. */
+    void reset();
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    static float toDisplay(float linear) noexcept;
+
+    float displayPeak = 0.0f;
+    float displayRms = 0.0f;
+    float drawnPeak = 0.0f, drawnRms = 0.0f;
+    double lastUpdateMs = 0.0;
+};
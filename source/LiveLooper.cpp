@@ -0,0 +1,189 @@
+#include "LiveLooper.h"
+
+LiveLooper::LiveLooper(int numSlots)
+    : recorders(new Recorder[(size_t)juce::jmax(0, numSlots)]),
+      numRecorders(juce::jmax(0, numSlots))
+{
+    writerThread.startThread();
+    startTimer(250);
+}
+
+LiveLooper::~LiveLooper()
+{
+    stopTimer();
+
+    for (int i = 0; i < numRecorders; ++i)
+        releaseWriter(recorders[(size_t)i]);
+
+    writerThread.stopThread(2000);
+}
+
+void LiveLooper::prepare(double newSampleRate, int maxBlockSize)
+{
+    sampleRate = newSampleRate;
+    inputScratch.setSize(2, juce::jmax(1, maxBlockSize));
+    capturedSamples = 0;
+}
+
+bool LiveLooper::arm(int slot, DJamClip& take, int takeIndex, int bars, double bpm, int beatsPerBar, int numInputChannels)
+{
+    if (slot < 0 || slot >= numRecorders || bpm <= 0.0)
+        return false;
+
+    auto& r = recorders[(size_t)slot];
+    // Busy while recording, or while the previous take is still being flushed
+    if (r.state.load(std::memory_order_acquire) != (int)State::idle || r.writer != nullptr)
+        return false;
+
+    // Room for the requested bars plus headroom for tempo drift while recording
+    const double samplesPerBar = sampleRate * 60.0 / bpm * juce::jmax(1, beatsPerBar);
+    const int capacity = (int)std::ceil(samplesPerBar * bars * 1.25);
+    const int numChannels = juce::jlimit(1, 2, numInputChannels);
+
+    take.prepareTake("Slot " + juce::String(slot + 1) + " Take", numChannels, capacity, sampleRate);
+
+    r.take = &take;
+    r.takeIndex = takeIndex;
+    r.bars = juce::jmax(1, bars);
+    r.barsDone = 0;
+    r.written = 0;
+    r.writerDone.store(false, std::memory_order_relaxed);
+
+    if (takeFolder.isDirectory())
+        r.writer = createWriter(slot, numChannels);
+
+    r.activeWriter.store(r.writer.get(), std::memory_order_relaxed);
+
+    numActive.fetch_add(1, std::memory_order_acq_rel);
+    r.state.store((int)State::armed, std::memory_order_release);
+    return true;
+}
+
+void LiveLooper::cancel(int slot)
+{
+    if (slot < 0 || slot >= numRecorders)
+        return;
+
+    auto& r = recorders[(size_t)slot];
+
+    for (auto from : { State::armed, State::recording })
+    {
+        int expected = (int)from;
+        if (r.state.compare_exchange_strong(expected, (int)State::idle, std::memory_order_acq_rel))
+        {
+            numActive.fetch_sub(1, std::memory_order_acq_rel);
+            r.writerDone.store(true, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void LiveLooper::setTakeFolder(const juce::File& folder)
+{
+    takeFolder = folder;
+}
+
+LiveLooper::State LiveLooper::getState(int slot) const noexcept
+{
+    if (slot < 0 || slot >= numRecorders)
+        return State::idle;
+
+    return (State)recorders[(size_t)slot].state.load(std::memory_order_acquire);
+}
+
+//===================== Audio thread =====================
+
+void LiveLooper::captureInput(const juce::AudioBuffer<float>& input, int numSamples) noexcept
+{
+    // Anything past the prepared block size is recorded as silence
+    capturedSamples = juce::jmin(numSamples, inputScratch.getNumSamples());
+    const int numChannels = juce::jmin(input.getNumChannels(), inputScratch.getNumChannels());
+
+    for (int ch = 0; ch < inputScratch.getNumChannels(); ++ch)
+    {
+        if (ch < numChannels)
+            inputScratch.copyFrom(ch, 0, input, ch, 0, capturedSamples);
+        else if (numChannels > 0)
+            inputScratch.copyFrom(ch, 0, input, 0, 0, capturedSamples); // mono in -> both sides
+        else
+            inputScratch.clear(ch, 0, capturedSamples);
+    }
+}
+
+void LiveLooper::record(int offset, int numSamples) noexcept
+{
+    for (int i = 0; i < numRecorders; ++i)
+    {
+        auto& r = recorders[(size_t)i];
+        if (r.state.load(std::memory_order_acquire) != (int)State::recording)
+            continue;
+
+        const int n = juce::jmin(numSamples, r.take->getTakeCapacity() - r.written);
+        if (n <= 0)
+            continue;
+
+        const int available = juce::jlimit(0, n, capturedSamples - offset);
+        const float* src[2] = {};
+
+        for (int ch = 0; ch < r.take->getNumChannels(); ++ch)
+        {
+            float* dest = r.take->getTakeWritePointer(ch) + r.written;
+            src[ch] = inputScratch.getReadPointer(ch, juce::jmin(offset, inputScratch.getNumSamples() - 1));
+
+            juce::FloatVectorOperations::copy(dest, src[ch], available);
+            juce::FloatVectorOperations::clear(dest + available, n - available);
+        }
+
+        // Lock-free FIFO hand-off to the disk thread (drops if it falls behind)
+        if (auto* w = r.activeWriter.load(std::memory_order_acquire); w != nullptr && available > 0)
+            w->write(src, available);
+
+        r.written += n;
+    }
+}
+
+//===================== Disk writing =====================
+
+std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> LiveLooper::createWriter(int slot, int numChannels)
+{
+    const auto stamp = juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S");
+    auto file = takeFolder.getNonexistentChildFile("D-Jam Slot " + juce::String(slot + 1) + " " + stamp, ".wav");
+
+    std::unique_ptr<juce::OutputStream> stream = std::make_unique<juce::FileOutputStream>(file);
+    if (static_cast<juce::FileOutputStream*>(stream.get())->failedToOpen())
+        return {};
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wav.createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, 24, {}, 0));
+
+    if (writer == nullptr)
+        return {};
+
+    stream.release(); // owned by the writer now
+    return std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(writer.release(), writerThread, 1 << 16);
+}
+
+void LiveLooper::releaseWriter(Recorder& r)
+{
+    r.activeWriter.store(nullptr, std::memory_order_release);
+    r.writer.reset(); // flushes what is left in the FIFO
+}
+
+void LiveLooper::timerCallback()
+{
+    // Finished writers are flushed and closed here, never on the audio thread.
+    // Detach on one tick and delete on the next, so a block that loaded the
+    // pointer just before cancel() has long finished with it.
+    for (int i = 0; i < numRecorders; ++i)
+    {
+        auto& r = recorders[(size_t)i];
+        if (r.writer == nullptr || !r.writerDone.load(std::memory_order_acquire))
+            continue;
+
+        if (r.activeWriter.load(std::memory_order_acquire) != nullptr)
+            r.activeWriter.store(nullptr, std::memory_order_release);
+        else
+            releaseWriter(r);
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_events/juce_events.h>
+
+#include "DJamClip.h"
+
+/**
+ * Bar-quantized live looping from the processor's input bus.
+ *
+ * A slot is armed on the message thread, which is where the take clip's
+ * storage and the optional disk writer are created. From then on the audio
+ * thread only moves samples: recording starts at the next bar boundary,
+ * runs for the requested number of bars straight into the take's buffer,
+ * and the finished take is handed back to be launched on the same boundary.
+ *
+ * When a take folder is set, samples are also pushed through a
+ * ThreadedWriter's lock-free FIFO and written to disk on a background thread.
+ */
+class LiveLooper : private juce::Timer
+{
+public:
+    enum class State { idle, armed, recording };
+
+    explicit LiveLooper(int numSlots);
+    ~LiveLooper() override;
+
+    /** Message thread: sizes the input scratch for blocks up to `maxBlockSize`. */
+    void prepare(double sampleRate, int maxBlockSize);
+
+    /**
+     * Message thread: arms `slot` to record `bars` bars into `take` (which is
+     * pack entry `takeIndex`). Returns false if the slot is already busy.
+     */
+    bool arm(int slot, DJamClip& take, int takeIndex, int bars, double bpm, int beatsPerBar, int numInputChannels);
+
+    /** Message thread: drops an armed or running recording; the take is not launched. */
+    void cancel(int slot);
+
+    /** Message thread: folder for takes on disk; an invalid File disables writing. */
+    void setTakeFolder(const juce::File& folder);
+    juce::File getTakeFolder() const { return takeFolder; }
+
+    State getState(int slot) const noexcept;
+    bool isActive() const noexcept { return numActive.load(std::memory_order_acquire) > 0; }
+
+    //==================== Audio thread ====================
+
+    /** Copies this block's input before the processor clears the buffer. */
+    void captureInput(const juce::AudioBuffer<float>& input, int numSamples) noexcept;
+
+    /** Records the captured input for [offset, offset + numSamples). */
+    void record(int offset, int numSamples) noexcept;
+
+    /**
+     * Call at every bar boundary. Starts armed recordings and completes
+     * finished ones, calling onTakeReady(slot, takeIndex) for each.
+     */
+    template <typename OnTakeReady>
+    void onBarBoundary(float bpm, OnTakeReady&& onTakeReady) noexcept
+    {
+        for (int i = 0; i < numRecorders; ++i)
+        {
+            auto& r = recorders[(size_t)i];
+            const auto st = (State)r.state.load(std::memory_order_acquire);
+
+            if (st == State::armed)
+            {
+                r.written = 0;
+                r.barsDone = 0;
+
+                int expected = (int)State::armed;
+                r.state.compare_exchange_strong(expected, (int)State::recording, std::memory_order_acq_rel);
+            }
+            else if (st == State::recording && ++r.barsDone >= r.bars)
+            {
+                // cancel() may race us to idle; only the winner finishes the take
+                int expected = (int)State::recording;
+                if (!r.state.compare_exchange_strong(expected, (int)State::idle, std::memory_order_acq_rel))
+                    continue;
+
+                r.take->finishTake(r.written, r.bars, bpm);
+                r.writerDone.store(true, std::memory_order_release);
+                numActive.fetch_sub(1, std::memory_order_acq_rel);
+                onTakeReady(i, r.takeIndex);
+            }
+        }
+    }
+
+private:
+    struct Recorder
+    {
+        std::atomic<int> state{ (int)State::idle };
+        DJamClip* take = nullptr;
+        int takeIndex = -1;
+        int bars = 0;
+        int barsDone = 0;
+        int written = 0;
+
+        std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> writer;
+        std::atomic<juce::AudioFormatWriter::ThreadedWriter*> activeWriter{ nullptr };
+        std::atomic<bool> writerDone{ false };
+    };
+
+    void timerCallback() override;
+    void releaseWriter(Recorder& r);
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> createWriter(int slot, int numChannels);
+
+    std::unique_ptr<Recorder[]> recorders;
+    int numRecorders = 0;
+    std::atomic<int> numActive{ 0 };
+
+    juce::AudioBuffer<float> inputScratch;
+    int capturedSamples = 0;
+    double sampleRate = 44100.0;
+
+    juce::File takeFolder;
+    juce::TimeSliceThread writerThread{ "D-Jam take writer" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LiveLooper)
+};
@@ -0,0 +1,103 @@
+#include "Metering.h"
+
+//===================== LevelAccumulator =====================
+
+void LevelAccumulator::add(const float* data, int n, float gain) noexcept
+{
+    if (n <= 0)
+        return;
+
+    const auto range = juce::FloatVectorOperations::findMinAndMax(data, n);
+    peak = juce::jmax(peak, std::abs(gain) * juce::jmax(-range.getStart(), range.getEnd()));
+
+    // Eight independent partial sums so the compiler can keep them in one register
+    constexpr int kLanes = 8;
+    float lanes[kLanes] = {};
+    int i = 0;
+
+    for (; i + kLanes <= n; i += kLanes)
+        for (int k = 0; k < kLanes; ++k)
+            lanes[k] += data[i + k] * data[i + k];
+
+    float sum = 0.0f;
+    for (int k = 0; k < kLanes; ++k)
+        sum += lanes[k];
+    for (; i < n; ++i)
+        sum += data[i] * data[i];
+
+    sumSquares += sum * gain * gain;   // scaling the reductions is cheaper than the data
+    numSamples += n;
+}
+
+void LevelAccumulator::addBuffer(const juce::AudioBuffer<float>& buffer, int start, int n) noexcept
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        add(buffer.getReadPointer(ch, start), n);
+}
+
+//===================== MeterChannel =====================
+
+void MeterChannel::publish(const LevelAccumulator& acc, double blockSeconds) noexcept
+{
+    // Peak: keep the max until the UI takes it
+    float prev = peak.load(std::memory_order_relaxed);
+    while (acc.peak > prev && !peak.compare_exchange_weak(prev, acc.peak, std::memory_order_relaxed)) {}
+
+    // RMS: one-pole average of the block mean square
+    const double blockMeanSquare = acc.numSamples > 0 ? (double)acc.sumSquares / acc.numSamples : 0.0;
+    const double a = std::exp(-blockSeconds / kRmsWindowSeconds);
+    meanSquare = a * meanSquare + (1.0 - a) * blockMeanSquare;
+
+    rms.store((float)std::sqrt(meanSquare), std::memory_order_relaxed);
+}
+
+//===================== MomentaryLoudness =====================
+
+void MomentaryLoudness::prepare(double sampleRate, int numChannels)
+{
+    filters.resize((size_t)juce::jmax(1, numChannels));
+    for (auto& f : filters)
+        f.prepare(sampleRate);
+
+    binLength = juce::jmax(1, (int)(sampleRate * 0.1));
+    binEnergy.fill(0.0);
+    currentEnergy = 0.0;
+    binFill = 0;
+    binIndex = 0;
+    lufs.store(-100.0f, std::memory_order_relaxed);
+}
+
+void MomentaryLoudness::process(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    if (!isEnabled())
+        return;
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), (int)filters.size());
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        const int n = juce::jmin(numSamples - pos, binLength - binFill);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            currentEnergy += filters[(size_t)ch].processSumSquares(buffer.getReadPointer(ch, pos), n);
+
+        pos += n;
+        binFill += n;
+
+        if (binFill == binLength)
+        {
+            binEnergy[(size_t)binIndex] = currentEnergy;
+            binIndex = (binIndex + 1) % kNumBins;
+            currentEnergy = 0.0;
+            binFill = 0;
+
+            double total = 0.0;
+            for (auto e : binEnergy)
+                total += e;
+
+            const double meanSquare = total / ((double)binLength * kNumBins);
+            lufs.store(meanSquare > 0.0 ? (float)(-0.691 + 10.0 * std::log10(meanSquare)) : -100.0f,
+                std::memory_order_relaxed);
+        }
+    }
+}
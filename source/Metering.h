@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "KWeighting.h"
+
+/**
+ * Peak and sum-of-squares gathered while a block is mixed.
+ * Both reductions run over contiguous runs and vectorise.
+ */
+struct LevelAccumulator
+{
+    float peak = 0.0f;
+    float sumSquares = 0.0f;
+    int numSamples = 0;
+
+    void reset() noexcept { peak = 0.0f; sumSquares = 0.0f; numSamples = 0; }
+
+    /** Adds one contiguous run of one channel, as heard after `gain`. */
+    void add(const float* data, int n, float gain = 1.0f) noexcept;
+
+    /** Adds [start, start + n) of every channel in `buffer`. */
+    void addBuffer(const juce::AudioBuffer<float>& buffer, int start, int n) noexcept;
+};
+
+/**
+ * Lock-free meter readout for one strip. The audio thread publishes once
+ * per block; the editor takes the peak (max since its last read) and the
+ * ~300 ms RMS without ever blocking the audio thread.
+ */
+class MeterChannel
+{
+public:
+    /** Audio thread: folds a finished block into the published values. */
+    void publish(const LevelAccumulator& acc, double blockSeconds) noexcept;
+
+    /** UI: highest peak since the previous call. */
+    float takePeak() noexcept { return peak.exchange(0.0f, std::memory_order_relaxed); }
+
+    /** UI: smoothed RMS level (linear). */
+    float getRms() const noexcept { return rms.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr double kRmsWindowSeconds = 0.3;
+
+    std::atomic<float> peak{ 0.0f }, rms{ 0.0f };
+    double meanSquare = 0.0; // audio thread only
+};
+
+/**
+ * Optional EBU R128 momentary loudness (400 ms window) for the master.
+ * Energy is kept in 100 ms bins so each block costs only the K-weighting.
+ */
+class MomentaryLoudness
+{
+public:
+    /** Message thread. */
+    void prepare(double sampleRate, int numChannels);
+
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /** Audio thread. */
+    void process(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+
+    /** UI: momentary loudness in LUFS (-inf when silent). */
+    float getLufs() const noexcept { return lufs.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kNumBins = 4; // 4 x 100 ms
+
+    std::vector<KWeightingFilter> filters;
+    std::array<double, kNumBins> binEnergy{};
+    double currentEnergy = 0.0;
+    int binFill = 0, binLength = 4410, binIndex = 0;
+
+    std::atomic<bool> enabled{ false };
+    std::atomic<float> lufs{ -100.0f };
+};
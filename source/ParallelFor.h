@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <juce_core/juce_core.h>
+
+/**
+ * Runs fn(i) for i in [0, numItems) across worker threads and returns
+ * when every item is done. Items are handed out one at a time, so uneven
+ * work (long and short clips) balances itself.
+ *
+ * Used for load-time work on the clip pack; never call from the audio thread.
+ */
+template <typename Fn>
+void parallelFor(int numItems, Fn&& fn)
+{
+    if (numItems <= 0)
+        return;
+
+    const int numThreads = juce::jmin(numItems, juce::jmax(1, juce::SystemStats::getNumCpus()));
+    if (numThreads == 1)
+    {
+        for (int i = 0; i < numItems; ++i)
+            fn(i);
+        return;
+    }
+
+    std::atomic<int> next{ 0 };
+    std::vector<std::thread> workers;
+    workers.reserve((size_t)numThreads);
+
+    for (int t = 0; t < numThreads; ++t)
+        workers.emplace_back([&]
+            {
+                for (int i = next++; i < numItems; i = next++)
+                    fn(i);
+            });
+
+    for (auto& w : workers)
+        w.join();
+}
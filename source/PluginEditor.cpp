@@ -6,7 +6,7 @@
 // DJAM0AudioProcessorEditor Implementation
 //=============================================
 DJAM0AudioProcessorEditor::DJAM0AudioProcessorEditor(DJAM0AudioProcessor& p)
-    : juce::AudioProcessorEditor(&p), processor(p)
+    : juce::AudioProcessorEditor(&p), processor(p), slotList(p), diagnostics(p.getProfiler()), browser(p)
 {
     // Window title
     titleLabel.setText("D-Jam Performance Mixer", juce::dontSendNotification);
@@ -14,11 +14,160 @@ DJAM0AudioProcessorEditor::DJAM0AudioProcessorEditor(DJAM0AudioProcessor& p)
     titleLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(titleLabel);
 
-    // Build rows dynamically from kNumSlots
-    for (int s = 0; s < DJAM0AudioProcessor::getNumSlots(); ++s)
-        slotRows.add(new SlotRow(processor, s)), addAndMakeVisible(slotRows.getLast());
+    // Slot rows: built for the visible slots only and recycled while scrolling
+    addAndMakeVisible(slotList);
 
-    setSize(650, 60 + DJAM0AudioProcessor::getNumSlots() * 36);
+    // Master strip
+    addAndMakeVisible(masterMeter);
+    lufsButton.setToggleState(processor.getMasterLoudness().isEnabled(), juce::dontSendNotification);
+    lufsButton.onClick = [this] { processor.getMasterLoudness().setEnabled(lufsButton.getToggleState()); };
+    addAndMakeVisible(lufsButton);
+    lufsLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(lufsLabel);
+    normaliseButton.setTooltip("Play clips at their load-time loudness normalisation");
+    normaliseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.getAPVTS(), paramId_normalise(), normaliseButton);
+    addAndMakeVisible(normaliseButton);
+    crossfadeButton.setTooltip("Smooth each clip's loop seam so badly cut loops don't click");
+    crossfadeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        processor.getAPVTS(), paramId_loopCrossfade(), crossfadeButton);
+    addAndMakeVisible(crossfadeButton);
+
+    // Internal clock; the controls dim while the engine follows the host
+    auto& apvts = processor.getAPVTS();
+    clockModeBox.addItemList({ "Host", "Internal", "Auto" }, 1);
+    clockModeBox.setTooltip("Clock source: host transport, internal clock, or the host when it has one");
+    clockModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        apvts, paramId_clockMode(), clockModeBox);
+    addAndMakeVisible(clockModeBox);
+
+    clockBpmSlider.setSliderStyle(juce::Slider::IncDecButtons);
+    clockBpmSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 50, 20);
+    clockBpmSlider.setTooltip("Internal clock tempo (BPM)");
+    clockBpmAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        apvts, paramId_clockBpm(), clockBpmSlider);
+    addAndMakeVisible(clockBpmSlider);
+
+    clockMeterSlider.setSliderStyle(juce::Slider::IncDecButtons);
+    clockMeterSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 30, 20);
+    clockMeterSlider.setTooltip("Internal clock beats per bar");
+    clockMeterAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        apvts, paramId_clockNumerator(), clockMeterSlider);
+    addAndMakeVisible(clockMeterSlider);
+
+    clockRunButton.setTooltip("Run the internal clock (starts from bar 1)");
+    clockRunAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        apvts, paramId_clockRun(), clockRunButton);
+    addAndMakeVisible(clockRunButton);
+
+    diagButton.setClickingTogglesState(true);
+    diagButton.setTooltip("Engine timing diagnostics");
+    diagButton.onClick = [this]
+        {
+            findButton.setToggleState(false, juce::dontSendNotification);
+            browser.setVisible(false);
+            diagnostics.setVisible(diagButton.getToggleState());
+            refreshDiagnostics();
+        };
+    addAndMakeVisible(diagButton);
+    addChildComponent(diagnostics);
+
+    takesButton.onClick = [this] { chooseTakeFolder(); };
+    addAndMakeVisible(takesButton);
+    showTakeFolder();
+
+    findButton.setClickingTogglesState(true);
+    findButton.setTooltip("Search the sample pack");
+    findButton.onClick = [this]
+        {
+            diagButton.setToggleState(false, juce::dontSendNotification);
+            diagnostics.setVisible(false);
+            browser.setVisible(findButton.getToggleState());
+        };
+    addAndMakeVisible(findButton);
+    addChildComponent(browser);
+
+    // Chrome (title, master strip, margins) plus the slot rows; taller than the full list is pointless
+    const int numSlots = DJAM0AudioProcessor::getNumSlots();
+    const int chrome = 90;
+    setResizable(true, true);
+    setResizeLimits(1060, chrome + SlotList::kRowHeight * juce::jmin(2, numSlots),
+        2400, chrome + SlotList::kRowHeight * numSlots);
+    setSize(1060, chrome + SlotList::kRowHeight * juce::jmin(numSlots, kMaxVisibleSlots));
+}
+
+void DJAM0AudioProcessorEditor::refresh()
+{
+    TraceRecorder::get().setThreadName("message");
+    DJAM_TRACE_SCOPE("ui frame")
+
+    // Off-screen slots cost nothing per frame: only the visible range is captured and refreshed
+    processor.captureSnapshot(snapshot, slotList.getVisibleSlots());
+    slotList.refresh(snapshot);
+
+    const float clockAlpha = processor.isUsingInternalClock() ? 1.0f : 0.5f;
+    if (clockBpmSlider.getAlpha() != clockAlpha)
+    {
+        clockBpmSlider.setAlpha(clockAlpha);
+        clockMeterSlider.setAlpha(clockAlpha);
+        clockRunButton.setAlpha(clockAlpha);
+    }
+
+    // A state restore can change the take folder under the editor
+    if (processor.getTakeFolder() != shownTakeFolder)
+        showTakeFolder();
+
+    auto& master = processor.getMasterMeter();
+    masterMeter.setLevels(master.takePeak(), master.getRms());
+
+    const auto& loudness = processor.getMasterLoudness();
+    const auto text = loudness.isEnabled() && loudness.getLufs() > -99.0f
+        ? juce::String(loudness.getLufs(), 1) + " LUFS-M" : juce::String();
+    if (lufsLabel.getText() != text)
+        lufsLabel.setText(text, juce::dontSendNotification);
+
+    // The report is text: a few updates a second is plenty
+    if (diagnostics.isVisible() && ++framesSinceDiagnostics >= 15)
+    {
+        framesSinceDiagnostics = 0;
+        refreshDiagnostics();
+    }
+
+    // Tempo arrives as banks load; the list itself repaints only on change
+    if (browser.isVisible() && ++framesSinceBrowser >= 15)
+    {
+        framesSinceBrowser = 0;
+        browser.refresh();
+    }
+}
+
+void DJAM0AudioProcessorEditor::chooseTakeFolder()
+{
+    const auto current = processor.getTakeFolder();
+    takeFolderChooser = std::make_unique<juce::FileChooser>("Folder for recorded takes (cancel to keep takes in memory only)",
+        current.isDirectory() ? current : juce::File::getSpecialLocation(juce::File::userMusicDirectory));
+
+    takeFolderChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories,
+        [this](const juce::FileChooser& chooser)
+        {
+            processor.setTakeFolder(chooser.getResult());
+            showTakeFolder();
+        });
+}
+
+void DJAM0AudioProcessorEditor::showTakeFolder()
+{
+    const auto folder = processor.getTakeFolder();
+    shownTakeFolder = folder;
+    takesButton.setToggleState(folder != juce::File(), juce::dontSendNotification);
+    takesButton.setTooltip(folder != juce::File() ? "Takes are also written to " + folder.getFullPathName()
+                                                  : juce::String("Takes stay in memory; click to write them to a folder too"));
+}
+
+void DJAM0AudioProcessorEditor::refreshDiagnostics()
+{
+    processor.captureSnapshot(diagnosticsSnapshot);
+    diagnostics.refresh(diagnosticsSnapshot);
 }
 
 void DJAM0AudioProcessorEditor::resized()
@@ -30,7 +179,26 @@ void DJAM0AudioProcessorEditor::resized()
     area.removeFromTop(4);
 
 
-    // Slot rows
-    for (auto* row : slotRows)
-        row->setBounds(area.removeFromTop(34));
+    // Master strip at the bottom
+    auto masterRow = area.removeFromBottom(26);
+    diagButton.setBounds(masterRow.removeFromLeft(50).reduced(0, 2));
+    masterRow.removeFromLeft(4);
+    findButton.setBounds(masterRow.removeFromLeft(50).reduced(0, 2));
+    masterRow.removeFromLeft(8);
+    clockModeBox.setBounds(masterRow.removeFromLeft(80).reduced(0, 2));
+    clockBpmSlider.setBounds(masterRow.removeFromLeft(100));
+    clockMeterSlider.setBounds(masterRow.removeFromLeft(70));
+    clockRunButton.setBounds(masterRow.removeFromLeft(55));
+    takesButton.setBounds(masterRow.removeFromLeft(64).reduced(0, 2));
+    lufsButton.setBounds(masterRow.removeFromRight(70));
+    normaliseButton.setBounds(masterRow.removeFromRight(70));
+    crossfadeButton.setBounds(masterRow.removeFromRight(70));
+    lufsLabel.setBounds(masterRow.removeFromRight(110));
+    masterMeter.setBounds(masterRow.reduced(4, 6));
+    area.removeFromBottom(4);
+
+    // Slot rows (the diagnostics page or the clip browser covers them when shown)
+    diagnostics.setBounds(area);
+    browser.setBounds(area);
+    slotList.setBounds(area);
 }
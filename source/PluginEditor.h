@@ -1,7 +1,10 @@
 #pragma once
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
-#include "SlotRow.h"
+#include "SlotList.h"
+#include "LevelMeter.h"
+#include "DiagnosticsPage.h"
+#include "ClipBrowser.h"
 
 /**
  * The main plugin editor UI for D-Jam.
@@ -10,18 +13,65 @@ class DJAM0AudioProcessorEditor : public juce::AudioProcessorEditor
 {
 public:
     explicit DJAM0AudioProcessorEditor(DJAM0AudioProcessor& p);
-    ~DJAM0AudioProcessorEditor() override = default;
 
     void resized() override;
 
+    // Window height shows up to this many slots; more scroll
+    static constexpr int kMaxVisibleSlots = 12;
+
 private:
+    /** One UI frame: capture the engine snapshot and hand each row its slice. */
+    void refresh();
+
+    /** Diagnostics cover every slot, not just the rows in view. */
+    void refreshDiagnostics();
+
     DJAM0AudioProcessor& processor;
 
     juce::Label titleLabel;
     //juce::ComboBox sceneSelect;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> sceneAttachment;
 
-    juce::OwnedArray<SlotRow> slotRows;
+    SlotList slotList;      // rows exist only for the slots in view
+
+    // Master meter + optional momentary loudness readout
+    LevelMeter masterMeter;
+    juce::ToggleButton lufsButton{ "LUFS" };
+    juce::Label lufsLabel;
+    juce::ToggleButton normaliseButton{ "Norm" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> normaliseAttachment;
+    juce::ToggleButton crossfadeButton{ "X-fade" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> crossfadeAttachment;
+
+    // Internal clock: source, tempo, beats per bar and run
+    juce::ComboBox clockModeBox;
+    juce::Slider clockBpmSlider, clockMeterSlider;
+    juce::ToggleButton clockRunButton{ "Run" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> clockModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> clockBpmAttachment, clockMeterAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> clockRunAttachment;
+
+    // Where recorded takes are also written to disk (saved with the session)
+    juce::TextButton takesButton{ "Takes..." };
+    std::unique_ptr<juce::FileChooser> takeFolderChooser;
+    juce::File shownTakeFolder;
+    void chooseTakeFolder();
+    void showTakeFolder();
+
+    // Engine timing page, shown in place of the slot rows
+    juce::TextButton diagButton{ "Diag" };
+    DiagnosticsPage diagnostics;
+    EngineSnapshot diagnosticsSnapshot;
+    int framesSinceDiagnostics = 0;
+
+    // Clip search, also shown in place of the slot rows
+    juce::TextButton findButton{ "Find" };
+    ClipBrowser browser;
+    int framesSinceBrowser = 0;
+
+    // Frame-synchronised refresh; declared last so it detaches first
+    EngineSnapshot snapshot;
+    juce::VBlankAttachment vblank{ this, [this] { refresh(); } };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DJAM0AudioProcessorEditor)
 };
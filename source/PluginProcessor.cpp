@@ -1,6 +1,25 @@
 ﻿#include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include <juce_audio_formats/juce_audio_formats.h>
+#include "ParallelFor.h"
+
+// Follow-action persistence (child of APVTS.state)
+static const juce::Identifier kFollowActionsTree("FOLLOW_ACTIONS");
+static const juce::Identifier kFollowActionNode("FOLLOW");
+static const juce::Identifier kFollowClip("clip");
+static const juce::Identifier kFollowType("type");
+static const juce::Identifier kFollowUnit("unit");
+static const juce::Identifier kFollowCount("count");
+static const juce::Identifier kFollowTarget("target");
+
+// Slice-pattern persistence (child of APVTS.state), one node per slot that has one
+static const juce::Identifier kSlicePatternsTree("SLICE_PATTERNS");
+static const juce::Identifier kSlicePatternNode("SLICES");
+static const juce::Identifier kSliceSlot("slot");
+static const juce::Identifier kSlicePattern("pattern");
+
+// Frames touched ahead of a follow-action start
+static constexpr int kFollowWarmFrames = 8192;
 
 // Factory
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -14,16 +33,67 @@ juce::AudioProcessorValueTreeState::ParameterLayout DJAM0AudioProcessor::createP
 {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
+    params.emplace_back(std::make_unique<juce::AudioParameterChoice>(
+        paramId_recBars(), "Record Bars", juce::StringArray{ "1", "2", "4", "8", "16" }, 2));
+
+    params.emplace_back(std::make_unique<juce::AudioParameterBool>(
+        paramId_normalise(), "Normalise Clips", true));
+
+    params.emplace_back(std::make_unique<juce::AudioParameterBool>(
+        paramId_loopCrossfade(), "Loop Crossfade", true));
+
+    // Internal clock: its own tempo and meter, used per clockMode
+    params.emplace_back(std::make_unique<juce::AudioParameterChoice>(
+        paramId_clockMode(), "Clock Source", juce::StringArray{ "Host", "Internal", "Auto" }, (int)ClockMode::autoSelect));
+
+    params.emplace_back(std::make_unique<juce::AudioParameterFloat>(
+        paramId_clockBpm(), "Clock Tempo", juce::NormalisableRange<float>(40.0f, 300.0f, 0.01f), 120.0f));
+
+    params.emplace_back(std::make_unique<juce::AudioParameterInt>(
+        paramId_clockNumerator(), "Clock Beats Per Bar", 1, 16, 4));
+
+    params.emplace_back(std::make_unique<juce::AudioParameterBool>(
+        paramId_clockRun(), "Clock Run", true));
+
     for (int s = 0; s < kNumSlots; ++s)
     {
         params.emplace_back(std::make_unique<juce::AudioParameterInt>(
-            paramId_slotClip(s), "Slot " + juce::String(s + 1) + " Clip", -1, 255, -1));
+            paramId_slotClip(s), "Slot " + juce::String(s + 1) + " Clip", -1, kClipsPerBank - 1, -1));
+
+        params.emplace_back(std::make_unique<juce::AudioParameterInt>(
+            paramId_slotBank(s), "Slot " + juce::String(s + 1) + " Bank", 0, ClipBankPager::kMaxBanks - 1, 0));
 
         params.emplace_back(std::make_unique<juce::AudioParameterBool>(
             paramId_slotMute(s), "Slot " + juce::String(s + 1) + " Mute", false));
 
         params.emplace_back(std::make_unique<juce::AudioParameterBool>(
             paramId_slotSolo(s), "Slot " + juce::String(s + 1) + " Solo", false));
+
+        // Insert chain
+        const juce::String fxName = "Slot " + juce::String(s + 1) + " FX ";
+
+        params.emplace_back(std::make_unique<juce::AudioParameterBool>(
+            paramId_slotFx(s), fxName + "On", false));
+
+        params.emplace_back(std::make_unique<juce::AudioParameterFloat>(
+            paramId_slotFxCutoff(s), fxName + "Cutoff",
+            juce::NormalisableRange<float>(20.0f, 20000.0f, 0.0f, 0.25f), 20000.0f));
+
+        params.emplace_back(std::make_unique<juce::AudioParameterFloat>(
+            paramId_slotFxEqGain(s), fxName + "EQ Gain",
+            juce::NormalisableRange<float>(-18.0f, 18.0f), 0.0f));
+
+        params.emplace_back(std::make_unique<juce::AudioParameterFloat>(
+            paramId_slotFxDrive(s), fxName + "Drive",
+            juce::NormalisableRange<float>(0.0f, 24.0f), 0.0f));
+
+        params.emplace_back(std::make_unique<juce::AudioParameterFloat>(
+            paramId_slotFxDelayMix(s), fxName + "Delay Mix",
+            juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
+
+        params.emplace_back(std::make_unique<juce::AudioParameterFloat>(
+            paramId_slotFxDelayTime(s), fxName + "Delay Time",
+            juce::NormalisableRange<float>(10.0f, 2000.0f, 0.0f, 0.5f), 250.0f));
     }
 
     return { params.begin(), params.end() };
@@ -31,26 +101,68 @@ juce::AudioProcessorValueTreeState::ParameterLayout DJAM0AudioProcessor::createP
 
 //===================== Processor =====================
 
-DJAM0AudioProcessor::DJAM0AudioProcessor()
-    : juce::AudioProcessor(
-        BusesProperties()
+juce::AudioProcessor::BusesProperties DJAM0AudioProcessor::createBusesProperties()
+{
+    auto props = BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
-        .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true);
+
+    // Per-slot outputs start disabled; hosts opt in to multi-output routing
+    for (int s = 0; s < kNumSlots; ++s)
+        props = props.withOutput("Slot " + juce::String(s + 1), juce::AudioChannelSet::stereo(), false);
+
+    return props;
+}
+
+DJAM0AudioProcessor::DJAM0AudioProcessor()
+    : juce::AudioProcessor(createBusesProperties()),
     apvts(*this, nullptr, "PARAMS", createParameterLayout())
 {
     DBG("Strting DJAM0AudioProcessor");
 
 
-    // Register listeners & init clip-name properties for UI labels
+    normaliseParam = apvts.getRawParameterValue(paramId_normalise());
+    loopCrossfadeParam = apvts.getRawParameterValue(paramId_loopCrossfade());
+
+    clockParams.mode = apvts.getRawParameterValue(paramId_clockMode());
+    clockParams.bpm = apvts.getRawParameterValue(paramId_clockBpm());
+    clockParams.numerator = apvts.getRawParameterValue(paramId_clockNumerator());
+    clockParams.run = apvts.getRawParameterValue(paramId_clockRun());
+
+    // Register listeners
     for (int s = 0; s < kNumSlots; ++s)
     {
         apvts.addParameterListener(paramId_slotClip(s), this);
+        apvts.addParameterListener(paramId_slotBank(s), this);
         apvts.addParameterListener(paramId_slotMute(s), this);
         apvts.addParameterListener(paramId_slotSolo(s), this);
 
-        if (!apvts.state.hasProperty(paramId_slotClipName(s)))
-            apvts.state.setProperty(paramId_slotClipName(s), juce::String(), nullptr);
+        slotParamIds[(size_t)s] = { paramId_slotClip(s), paramId_slotBank(s), paramId_slotMute(s), paramId_slotSolo(s) };
+
+        auto& sp = slotParams[(size_t)s];
+        sp.clip = apvts.getRawParameterValue(paramId_slotClip(s));
+        sp.bank = apvts.getRawParameterValue(paramId_slotBank(s));
+        sp.mute = apvts.getRawParameterValue(paramId_slotMute(s));
+        sp.solo = apvts.getRawParameterValue(paramId_slotSolo(s));
+
+        // Nothing playing until the first block publishes
+        slotPlayback[(size_t)s].store((juce::uint64)0xffffffffu << 32, std::memory_order_relaxed);
+        slotPendingLaunch[(size_t)s].store(-1, std::memory_order_relaxed);
+
+        auto& fx = fxParams[(size_t)s];
+        fx.enabled = apvts.getRawParameterValue(paramId_slotFx(s));
+        fx.cutoff = apvts.getRawParameterValue(paramId_slotFxCutoff(s));
+        fx.eqGain = apvts.getRawParameterValue(paramId_slotFxEqGain(s));
+        fx.drive = apvts.getRawParameterValue(paramId_slotFxDrive(s));
+        fx.delayMix = apvts.getRawParameterValue(paramId_slotFxDelayMix(s));
+        fx.delayTime = apvts.getRawParameterValue(paramId_slotFxDelayTime(s));
     }
+
+    // Tempo and length become searchable as each bank loads (clips not in the analysis cache yet)
+    bankPager.onClipLoaded = [this](int clip, const DJamClip& c)
+        {
+            clipSearch.setMetadata(clip, { c.getBPM(), c.getLoopLengthBars() });
+        };
 }
 
 DJAM0AudioProcessor::~DJAM0AudioProcessor()
@@ -58,9 +170,17 @@ DJAM0AudioProcessor::~DJAM0AudioProcessor()
     for (int s = 0; s < kNumSlots; ++s)
     {
         apvts.removeParameterListener(paramId_slotClip(s), this);
+        apvts.removeParameterListener(paramId_slotBank(s), this);
         apvts.removeParameterListener(paramId_slotMute(s), this);
         apvts.removeParameterListener(paramId_slotSolo(s), this);
     }
+
+    // The writer thread must not outlive the plugin binary
+    TraceRecorder::get().stop();
+
+    delete pendingRestore.exchange(nullptr);
+    for (auto& retired : retiredRestores)
+        delete retired.exchange(nullptr);
 }
 
 bool DJAM0AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -70,7 +190,52 @@ bool DJAM0AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) con
     if (out != juce::AudioChannelSet::mono() && out != juce::AudioChannelSet::stereo()) return false;
 
     auto in = layouts.getMainInputChannelSet();
-    return in.isDisabled() || in == out;
+    if (!in.isDisabled() && in != out) return false;
+
+    // Slot buses: any subset may be enabled, each stereo
+    if (layouts.outputBuses.size() > 1 + kNumSlots) return false;
+
+    for (int b = 1; b < layouts.outputBuses.size(); ++b)
+    {
+        const auto& set = layouts.outputBuses.getReference(b);
+        if (!set.isDisabled() && set != juce::AudioChannelSet::stereo()) return false;
+    }
+
+    return true;
+}
+
+bool DJAM0AudioProcessor::canAddBus(bool isInput) const
+{
+    return !isInput && getBusCount(false) < 1 + kNumSlots;
+}
+
+bool DJAM0AudioProcessor::canRemoveBus(bool isInput) const
+{
+    return !isInput && getBusCount(false) > 1;
+}
+
+void DJAM0AudioProcessor::processorLayoutsChanged()
+{
+    updateSlotRouting();
+}
+
+void DJAM0AudioProcessor::updateSlotRouting()
+{
+    for (int s = 0; s < kNumSlots; ++s)
+    {
+        const auto* bus = getBus(false, slotOutputBus(s));
+        auto& route = slotRoutes[(size_t)s];
+
+        if (bus != nullptr && bus->isEnabled())
+        {
+            route.firstChannel = getChannelIndexInProcessBlockBuffer(false, slotOutputBus(s), 0);
+            route.numChannels = bus->getNumberOfChannels();
+        }
+        else
+        {
+            route = {};
+        }
+    }
 }
 
 void DJAM0AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
@@ -78,12 +243,10 @@ void DJAM0AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     DBG("prepareToPlay");
 
 
-    //playhead hooks
+    //playhead hooks (invoked on the audio thread: no allocation, logging or locks)
     playHead.onStart = [this](const juce::AudioPlayHead::CurrentPositionInfo& info)
         {
-            DBG("Transport started");
-
-            // Reset timing and schedule base
+            // New timing base; launches queued while stopped stay queued for the first bar
             scheduler.resetToHostPosition(info.ppqPosition);
 
             // Resume playback of active clips
@@ -93,8 +256,6 @@ void DJAM0AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 
     playHead.onStop = [this]()
         {
-            DBG("Transport stopped");
-
             // Cancel any future starts
             scheduler.stopAll();
 
@@ -103,14 +264,13 @@ void DJAM0AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
                 s.stopPlayback();
         };
 
-    playHead.onJump = [this](double oldPPQ, double newPPQ)
+    playHead.onJump = [this](double /*oldPPQ*/, double newPPQ)
         {
-            DBG("Transport jumped: " << oldPPQ << " → " << newPPQ);
+            DJAM_TRACE_INSTANT("transport jump", (juce::int64)(newPPQ * 1000.0))
 
-            // Cancel future starts (optional, depending on clip model)
+            // Pending launches survive a locate or cycle wrap and land on the next bar
             scheduler.realignTo(newPPQ);
 
-            // You may want to optionally reset or drop playback here too
             for (auto& s : slots)
                 s.jumpTo(newPPQ);
         };
@@ -119,24 +279,27 @@ void DJAM0AudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 
 
 
-    juce::ignoreUnused(samplesPerBlock);
-
     hostPhase.sampleRate = sampleRate;
+    clock.prepare(sampleRate);
+#if DJAM_PROFILE
+    profiler.prepare(sampleRate, kNumSlots);
+#endif
+
+    // Insert chains and the scratch a main-mix slot is isolated in
+    const juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)juce::jmax(1, samplesPerBlock), 2 };
+    insertScratch.setSize(2, juce::jmax(1, samplesPerBlock));
+    for (auto& chain : inserts)
+        chain.prepare(spec);
+
+    looper.prepare(sampleRate, samplesPerBlock);
+    masterLoudness.prepare(sampleRate, getMainBusNumOutputChannels());
 
+    updateSlotRouting();
     loadSamplePack();
 
     // Give slots a pointer to the bank
     for (auto& s : slots)
         s.setClipBank(&pack);
-
-    // Optional: seed UI labels from current params (intent)
-    for (int i = 0; i < kNumSlots; ++i)
-    {
-        const int idx = (int)apvts.getRawParameterValue(paramId_slotClip(i))->load();
-        const juce::String name = (idx >= 0 && idx < (int)pack.size())
-            ? pack[(size_t)idx].getName() : juce::String();
-        setSlotClipName(i, name);
-    }
 }
 
 void DJAM0AudioProcessor::releaseResources() {}
@@ -145,24 +308,52 @@ void DJAM0AudioProcessor::releaseResources() {}
 
 void DJAM0AudioProcessor::parameterChanged(const juce::String& paramID, float newValue)
 {
+    // A state restore hands slot state to the audio thread itself; other parameters (host automation) go on
+    const auto* restoring = restoringParam.load(std::memory_order_relaxed);
+    if (restoring != nullptr && restoring->paramID == paramID)
+        return;
+
+    // Hosts may call this from the audio thread: compare against the cached IDs (no allocation)
     for (int s = 0; s < kNumSlots; ++s)
     {
-        if (paramID == paramId_slotClip(s)) { onSlotClipParamChanged(s, (int)newValue); return; }
-        if (paramID == paramId_slotMute(s)) { onSlotMuteParamChanged(s, newValue > 0.5f); return; }
-        if (paramID == paramId_slotSolo(s)) { onSlotSoloParamChanged(s, newValue > 0.5f); return; }
+        const auto& ids = slotParamIds[(size_t)s];
+        if (paramID == ids.clip) { onSlotClipParamChanged(s, (int)newValue); return; }
+        if (paramID == ids.bank) { onSlotBankParamChanged(s, (int)newValue); return; }
+        if (paramID == ids.mute) { onSlotMuteParamChanged(s, newValue > 0.5f); return; }
+        if (paramID == ids.solo) { onSlotSoloParamChanged(s, newValue > 0.5f); return; }
     }
 }
 
 void DJAM0AudioProcessor::onSlotClipParamChanged(int slot, int newClipIdx)
 {
-    // Queue for next bar (quantized)
+    // Queue for next bar (quantized); the editor shows the request from the param itself
     if (newClipIdx >= 0)
-        scheduler.request({ slot, newClipIdx });
+        scheduler.request({ slot, (int)slotParams[(size_t)slot].bank->load() * kClipsPerBank + newClipIdx });
+}
+
+void DJAM0AudioProcessor::onSlotBankParamChanged(int slot, int newBank)
+{
+    // Fetch in the background; the same position in the new bank launches on the first bar it is ready for
+    bankPager.setWantedBank(slot, newBank);
 
-    // Update label immediately (reflect intent)
-    const juce::String name = (newClipIdx >= 0 && newClipIdx < (int)pack.size())
-        ? pack[(size_t)newClipIdx].getName() : juce::String();
-    setSlotClipName(slot, name);
+    if (const int clip = requestedClipIndex(slot); clip >= 0)
+        scheduler.request({ slot, clip });
+}
+
+int DJAM0AudioProcessor::requestedClipIndex(int slot) const noexcept
+{
+    const auto& params = slotParams[(size_t)slot];
+    const int clip = (int)params.clip->load();
+    return clip >= 0 ? (int)params.bank->load() * kClipsPerBank + clip : -1;
+}
+
+bool DJAM0AudioProcessor::armSlot(int slot, int clip) noexcept
+{
+    if (!bankPager.claim(slot, ClipBankPager::nextClaim, bankPager.bankOf(clip)))
+        return false;
+
+    slots[(size_t)slot].armStart(clip);
+    return true;
 }
 
 void DJAM0AudioProcessor::onSlotMuteParamChanged(int slot, bool mute)
@@ -180,55 +371,157 @@ void DJAM0AudioProcessor::onSlotSoloParamChanged(int slot, bool solo)
 
 void DJAM0AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
+    DJAM_RT_AUDIO_CALLBACK_SCOPE
+    DJAM_PROFILE_BLOCK(profiler, buffer.getNumSamples())
+    DJAM_PROFILE_MARK(setupStart)
+    TraceRecorder::get().setThreadName("audio");
+    DJAM_TRACE_SCOPE("processBlock", buffer.getNumSamples())
     juce::ScopedNoDenormals noDenormals;
+
+    // Keep the input for live looping before the buffer becomes the output
+    const bool looping = looper.isActive();
+    if (looping)
+        looper.captureInput(getBusBuffer(buffer, true, 0), buffer.getNumSamples());
+
     buffer.clear();
     juce::ignoreUnused(midi);
 
-    if (!getHostPhase(getPlayHead(), hostPhase))
+    // Launch requests from other threads (editor, parameter callbacks) join the audio thread's queue here
+    scheduler.collect();
+
+    // The host's transport or the internal clock; either is read as a play head from here on
+    clock.setTempo(clockParams.bpm->load(), (int)clockParams.numerator->load());
+    clock.setRunning(clockParams.run->load() > 0.5f);
+    auto* transport = selectTransport();
+    usingInternalClock.store(transport == &clock, std::memory_order_relaxed);
+
+    if (!getHostPhase(transport, hostPhase))
         hostPhase.isPlaying = false;
 
     hostPhase.sampleRate = getSampleRate();
 
+    // Transport edges (start / stop / locate) fire the hooks set up in prepareToPlay
+    playHead.update(transport, buffer.getNumSamples(), hostPhase.sampleRate);
+
+    // A restored state goes in after the edge hooks, so a start or stop in this block can't undo it
+    applyPendingRestore();
+
     const bool anySolo = std::any_of(slots.begin(), slots.end(),
         [](const Slot& s) { return s.isSolo(); });
 
+    const bool normalise = normaliseParam->load() > 0.5f;
+    const bool loopCrossfade = loopCrossfadeParam->load() > 0.5f;
+    for (auto& s : slots)
+    {
+        s.setNormalise(normalise);
+        s.setLoopCrossfade(loopCrossfade);
+    }
+
+    // Slice patterns: copied into a slot only when the editor changed one
+    for (int i = 0; i < kNumSlots; ++i)
+        if (slicePatterns.readIfChanged(i, slicePatternVersions[(size_t)i], slicePatternScratch))
+            slots[(size_t)i].setSlicePattern(slicePatternScratch);
+
+    // Pull insert-chain targets once per block (smoothed inside the chain)
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        const auto& fx = fxParams[(size_t)i];
+        SlotInsertChain::Params p;
+        p.enabled = fx.enabled->load() > 0.5f;
+        p.cutoffHz = fx.cutoff->load();
+        p.eqGainDb = fx.eqGain->load();
+        p.driveDb = fx.drive->load();
+        p.delayMix = fx.delayMix->load();
+        p.delayMs = fx.delayTime->load();
+        inserts[(size_t)i].setParams(p);
+    }
+
+    // Bus views are just channel pointers into `buffer` (no copy)
+    auto mainOut = getBusBuffer(buffer, false, 0);
+    DJAM_PROFILE_STAGE(blockSetup, setupStart)
+
+    for (auto& level : slotLevels)
+        level.reset();
+
     const int total = buffer.getNumSamples();
     int remaining = total;
     int blockOffset = 0;
+    int segments = 0;
 
     while (remaining > 0)
     {
-        const int toNextBar = (hostPhase.isPlaying ? samplesToNextBar(hostPhase) : remaining);
-        const int step = std::min(remaining, std::max(1, toNextBar));
-        const bool crosses = hostPhase.isPlaying && (step == toNextBar);
-
-        juce::AudioBuffer<float> sub(buffer.getArrayOfWritePointers(),
-            buffer.getNumChannels(),
-            blockOffset, step);
-
+        // Split at bar lines; an unusable phase (or a runaway split count) renders the rest in one piece
+        const bool barSync = hostPhase.isPlaying && segments < kMaxSegmentsPerBlock;
+        const int toNextBar = barSync ? samplesToNextBar(hostPhase) : 0;
+        const int step = toNextBar > 0 ? std::min(remaining, toNextBar) : remaining;
+        const bool crosses = toNextBar > 0 && step == toNextBar;
+        ++segments;
+
+        DJAM_PROFILE_MARK(renderStart)
         for (int i = 0; i < kNumSlots; ++i)
         {
+            DJAM_PROFILE_MARK(slotStart)
             if (anySolo && !slots[(size_t)i].isSolo()) continue;
             if (slots[(size_t)i].isMuted())           continue;
 
-            slots[(size_t)i].render(sub, 0, step, 0, hostPhase);
+            // Render straight into the slot's own bus when the host enabled it
+            const auto& route = slotRoutes[(size_t)i];
+            const bool ownBus = route.firstChannel >= 0;
+            juce::AudioBuffer<float> sub(ownBus ? buffer.getArrayOfWritePointers() + route.firstChannel
+                                                : mainOut.getArrayOfWritePointers(),
+                ownBus ? route.numChannels : mainOut.getNumChannels(),
+                blockOffset, step);
+
+            if (inserts[(size_t)i].isActive())
+                renderSlotWithInserts(i, sub, step, ownBus);
+            else
+                slots[(size_t)i].render(sub, 0, step, 0, hostPhase, &slotLevels[(size_t)i]);
+
+            DJAM_PROFILE_SLOT(i, slotStart)
+        }
+        DJAM_PROFILE_STAGE(slotRender, renderStart)
+
+        if (looping)
+        {
+            DJAM_PROFILE_MARK(recordStart)
+            looper.record(blockOffset, step);
+            DJAM_PROFILE_STAGE(looperRecord, recordStart)
         }
 
         if (crosses)
         {
+            DJAM_PROFILE_MARK(barStart)
+            DJAM_TRACE_INSTANT("bar", hostPhase.currentSample + step)
+
+            // Follow actions first, so an explicit launch on the same bar wins
+            advanceFollowActions();
+
+            // Finished live takes launch on the bar they end on
+            if (looping)
+                looper.onBarBoundary((float)hostPhase.bpm, [this](int slot, int take)
+                    {
+                        armSlot(slot, take);
+                    });
+
             // Commit requests exactly at bar boundary
-            scheduler.flushAtBar([this](const StartRequest& r)
-                {
-                    if (r.slot >= 0 && r.slot < kNumSlots)
-                        slots[(size_t)r.slot].armStart(r.clip);
-                });
+            {
+                DJAM_TRACE_SCOPE("flushAtBar")
+                // A clip whose bank is still loading stays queued for a later bar
+                scheduler.flushAtBar([this](const StartRequest& r)
+                    {
+                        return r.slot < 0 || r.slot >= kNumSlots || armSlot(r.slot, r.clip);
+                    });
+            }
 
             // Apply armed starts
-            for (auto& s : slots) s.applyArmedStart();
-
-            // Reflect "reality" in labels (now actually playing)
-            for (int i = 0; i < kNumSlots; ++i)
-                setSlotClipName(i, slots[(size_t)i].getActiveClipName());
+            {
+                DJAM_TRACE_SCOPE("applyArmedStart")
+                for (auto& s : slots) s.applyArmedStart();
+            }
+
+            // Resolve and warm follow targets due at the next boundary
+            prepareFollowActions();
+            DJAM_PROFILE_STAGE(barScheduling, barStart)
         }
 
         if (hostPhase.isPlaying)
@@ -236,11 +529,386 @@ void DJAM0AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::M
             hostPhase.currentSample += step;
             const double spb = hostPhase.sampleRate * 60.0 / hostPhase.bpm;
             hostPhase.ppqPosition += step / spb;
+
+            // Land exactly on the bar line, so rounding can't leave a sliver that crosses it twice
+            if (crosses)
+                hostPhase.ppqPosition = std::round(hostPhase.ppqPosition / hostPhase.numerator) * hostPhase.numerator;
         }
 
         remaining -= step;
         blockOffset += step;
     }
+
+    lastBlockSegments.store(segments, std::memory_order_relaxed);
+    clock.advance(total);
+
+    DJAM_PROFILE_MARK(publishStart)
+    const double blockSeconds = total / juce::jmax(1.0, getSampleRate());
+    for (auto& chain : inserts)
+        chain.publishLoad(blockSeconds); // idle chains decay to zero
+
+    // Meters: slots were measured while mixing; the master is measured once here
+    for (int i = 0; i < kNumSlots; ++i)
+        slotMeters[(size_t)i].publish(slotLevels[(size_t)i], blockSeconds);
+
+    LevelAccumulator masterLevel;
+    masterLevel.addBuffer(mainOut, 0, total);
+    masterMeter.publish(masterLevel, blockSeconds);
+    masterLoudness.process(mainOut, total);
+
+    publishedBpm.store(hostPhase.bpm, std::memory_order_relaxed);
+    publishedNumerator.store(hostPhase.numerator, std::memory_order_relaxed);
+
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        const auto& st = slots[(size_t)i].state();
+        slotPlayback[(size_t)i].store(((juce::uint64)(juce::uint32)st.activeClip << 32)
+            | (juce::uint32)st.phaseSamples, std::memory_order_relaxed);
+
+        // A launch really waiting for its bar: queued, or armed for the boundary
+        const int queued = scheduler.getPendingClip(i);
+        slotPendingLaunch[(size_t)i].store(queued >= 0 ? queued : (st.armedStart ? st.pendingClip : -1),
+            std::memory_order_relaxed);
+
+        // Hold only the banks still in use, so the loader may evict the rest
+        bankPager.keepClaim(i, ClipBankPager::activeClaim, bankPager.bankOf(st.activeClip));
+        bankPager.keepClaim(i, ClipBankPager::nextClaim,
+            bankPager.bankOf(st.armedStart ? st.pendingClip : st.followClip));
+    }
+    DJAM_PROFILE_STAGE(publish, publishStart)
+}
+
+juce::AudioPlayHead* DJAM0AudioProcessor::selectTransport() noexcept
+{
+    auto* host = getPlayHead();
+
+    switch ((ClockMode)(int)clockParams.mode->load())
+    {
+        case ClockMode::host:     return host;
+        case ClockMode::internal: return &clock;
+        case ClockMode::autoSelect:
+        default:                  break;
+    }
+
+    // Follow the host whenever it reports a usable position, stopped or not
+    if (host != nullptr)
+        if (const auto position = host->getPosition(); position.hasValue() && position->getPpqPosition().hasValue())
+            return host;
+
+    return &clock;
+}
+
+void DJAM0AudioProcessor::renderSlotWithInserts(int slot, juce::AudioBuffer<float>& sub, int numSamples, bool ownBus)
+{
+    auto& chain = inserts[(size_t)slot];
+
+    // Only chain.process is timed, so the insert load leaves out the clip render itself
+    const auto processTimed = [&chain](juce::AudioBuffer<float>& buffer, int startSample, int num)
+    {
+        const auto t0 = juce::Time::getHighResolutionTicks();
+        chain.process(buffer, startSample, num);
+        chain.addTicks(juce::Time::getHighResolutionTicks() - t0);
+    };
+
+    if (ownBus)
+    {
+        // The slot's bus is already isolated: process in place
+        slots[(size_t)slot].render(sub, 0, numSamples, 0, hostPhase);
+        processTimed(sub, 0, numSamples);
+        slotLevels[(size_t)slot].addBuffer(sub, 0, numSamples);
+    }
+    else
+    {
+        const int numChannels = juce::jmin(sub.getNumChannels(), insertScratch.getNumChannels());
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int n = juce::jmin(numSamples - done, insertScratch.getNumSamples());
+            juce::AudioBuffer<float> scratch(insertScratch.getArrayOfWritePointers(), numChannels, 0, n);
+            scratch.clear();
+
+            slots[(size_t)slot].render(scratch, 0, n, 0, hostPhase);
+            processTimed(scratch, 0, n);
+            slotLevels[(size_t)slot].addBuffer(scratch, 0, n);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                sub.addFrom(ch, done, scratch, ch, 0, n);
+
+            done += n;
+        }
+    }
+}
+
+float DJAM0AudioProcessor::getSlotInsertLoad(int slot) const noexcept
+{
+    return (slot >= 0 && slot < kNumSlots) ? inserts[(size_t)slot].getLoad() : 0.0f;
+}
+
+//===================== Editor queries =====================
+
+void DJAM0AudioProcessor::captureSnapshot(EngineSnapshot& snapshot, juce::Range<int> slotRange) const
+{
+    snapshot.slots.resize((size_t)kNumSlots);
+    slotRange = slotRange.getIntersectionWith({ 0, kNumSlots });
+
+    for (int i = slotRange.getStart(); i < slotRange.getEnd(); ++i)
+    {
+        auto& slot = snapshot.slots[(size_t)i];
+        const auto bits = slotPlayback[(size_t)i].load(std::memory_order_relaxed);
+        const auto& params = slotParams[(size_t)i];
+
+        slot.activeClip = (int)(juce::uint32)(bits >> 32);
+        slot.phaseSamples = (int)(juce::uint32)bits;
+        slot.requestedClip = requestedClipIndex(i);
+        slot.pendingClip = slotPendingLaunch[(size_t)i].load(std::memory_order_relaxed);
+        slot.pendingReady = slot.pendingClip < 0 || bankPager.bankOf(slot.pendingClip) == ClipBankPager::kNoBank
+            || bankPager.isResident(bankPager.bankOf(slot.pendingClip));
+        slot.muted = params.mute->load() > 0.5f;
+        slot.soloed = params.solo->load() > 0.5f;
+        slot.record = looper.getState(i);
+        slot.insertLoad = inserts[(size_t)i].getLoad();
+    }
+}
+
+DJAM0AudioProcessor::ClipInfo DJAM0AudioProcessor::getClipInfo(int clipIndex) const
+{
+    if (clipIndex < 0 || clipIndex >= (int)pack.size())
+        return {};
+
+    const auto& clip = pack[(size_t)clipIndex];
+    const int bank = bankPager.bankOf(clipIndex);
+    if (bank == ClipBankPager::kNoBank)
+        return { clip.getName(), clip.getLoopLengthBars(), clip.getNumSamples(), clip.getOverview() };
+
+    // Pack clips: the name comes from the catalogue; the rest only while the bank is in memory
+    ClipInfo info;
+    info.name = bankPager.getClipName(clipIndex);
+
+    const juce::ScopedLock sl(bankPager.getEvictionLock());
+    if (bankPager.isResident(bank))
+    {
+        info.loopBars = clip.getLoopLengthBars();
+        info.numSamples = clip.getNumSamples();
+        info.overview = clip.getOverview();
+    }
+
+    return info;
+}
+
+//===================== Live looping =====================
+
+bool DJAM0AudioProcessor::armSlotRecording(int slot)
+{
+    if (slot < 0 || slot >= kNumSlots || pack.size() < (size_t)takeClipIndex(kNumSlots, 0))
+        return false;
+
+    // Alternate takes, never re-recording one that a slot is playing or about to play.
+    // Slot state belongs to the audio thread: read what processBlock published instead
+    auto inUse = [this](int clip)
+        {
+            for (int i = 0; i < kNumSlots; ++i)
+            {
+                const auto bits = slotPlayback[(size_t)i].load(std::memory_order_relaxed);
+                if ((int)(juce::uint32)(bits >> 32) == clip
+                    || slotPendingLaunch[(size_t)i].load(std::memory_order_relaxed) == clip
+                    || requestedClipIndex(i) == clip)
+                    return true;
+            }
+            return false;
+        };
+
+    int take = (lastTake[(size_t)slot] + 1) % kTakesPerSlot;
+    if (inUse(takeClipIndex(slot, take)))
+        take = lastTake[(size_t)slot];
+    if (inUse(takeClipIndex(slot, take)))
+        return false;
+
+    const int index = takeClipIndex(slot, take);
+    auto* recBars = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(paramId_recBars()));
+    const int numBars = recBars != nullptr ? recBars->getCurrentChoiceName().getIntValue() : 4;
+
+    if (!looper.arm(slot, pack[(size_t)index], index, numBars,
+            publishedBpm.load(std::memory_order_relaxed), publishedNumerator.load(std::memory_order_relaxed),
+            getChannelCountOfBus(true, 0)))
+        return false;
+
+    lastTake[(size_t)slot] = take;
+    return true;
+}
+
+void DJAM0AudioProcessor::cancelSlotRecording(int slot)
+{
+    looper.cancel(slot);
+}
+
+LiveLooper::State DJAM0AudioProcessor::getSlotRecordState(int slot) const noexcept
+{
+    return looper.getState(slot);
+}
+
+void DJAM0AudioProcessor::setTakeFolder(const juce::File& folder)
+{
+    looper.setTakeFolder(folder);
+}
+
+//===================== Follow actions =====================
+
+void DJAM0AudioProcessor::setFollowSeed(juce::int64 seed)
+{
+    for (int i = 0; i < kNumSlots; ++i)
+        followRandom[(size_t)i].setSeed(seed + i);
+}
+
+void DJAM0AudioProcessor::advanceFollowActions()
+{
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        auto& s = slots[(size_t)i];
+        s.advanceBar();
+
+        const int clip = s.getActiveClipIndex();
+        if (clip < 0)
+            continue;
+
+        const FollowAction action = followActions.get(clip);
+        if (!action.isActive() || s.getBarsPlayed() < action.barsUntilFollow(s.getBarsLength()))
+            continue;
+
+        if (action.type == FollowActionType::stop)
+        {
+            s.stopPlayback();
+            continue;
+        }
+
+        int target = s.getFollowClip();
+        if (target < 0)
+            target = followActions.resolveTarget(action, clip, followRandom[(size_t)i],
+                bankPager.bankOf(clip) * kClipsPerBank, kClipsPerBank);
+
+        // A target in a bank that isn't loaded is skipped; the clip keeps looping
+        if (target >= 0)
+            armSlot(i, target);
+    }
+}
+
+void DJAM0AudioProcessor::prepareFollowActions()
+{
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        auto& s = slots[(size_t)i];
+        const int clip = s.getActiveClipIndex();
+        if (clip < 0 || s.getFollowClip() >= 0)
+            continue;
+
+        const FollowAction action = followActions.get(clip);
+        if (!action.isActive() || action.type == FollowActionType::stop)
+            continue;
+
+        // One bar ahead: pick the target now so the warmed clip is the one that plays
+        if (s.getBarsPlayed() + 1 < action.barsUntilFollow(s.getBarsLength()))
+            continue;
+
+        const int target = followActions.resolveTarget(action, clip, followRandom[(size_t)i],
+            bankPager.bankOf(clip) * kClipsPerBank, kClipsPerBank);
+        if (target < 0 || target >= (int)pack.size()
+            || !bankPager.claim(i, ClipBankPager::nextClaim, bankPager.bankOf(target)))
+            continue;
+
+        s.setFollowClip(target);
+        pack[(size_t)target].warm(kFollowWarmFrames);
+    }
+}
+
+void DJAM0AudioProcessor::setClipFollowAction(int clipIndex, const FollowAction& action)
+{
+    auto tree = apvts.state.getOrCreateChildWithName(kFollowActionsTree, nullptr);
+    auto node = tree.getChildWithProperty(kFollowClip, clipIndex);
+
+    if (!action.isActive())
+    {
+        tree.removeChild(node, nullptr);
+    }
+    else
+    {
+        if (!node.isValid())
+        {
+            node = juce::ValueTree(kFollowActionNode);
+            tree.appendChild(node, nullptr);
+        }
+
+        node.setProperty(kFollowClip, clipIndex, nullptr);
+        node.setProperty(kFollowType, (int)action.type, nullptr);
+        node.setProperty(kFollowUnit, (int)action.unit, nullptr);
+        node.setProperty(kFollowCount, action.count, nullptr);
+        node.setProperty(kFollowTarget, action.targetClip, nullptr);
+    }
+
+    followActions.set(clipIndex, action);
+}
+
+FollowAction DJAM0AudioProcessor::getClipFollowAction(int clipIndex) const
+{
+    return followActions.get(clipIndex);
+}
+
+void DJAM0AudioProcessor::syncFollowActionsFromState()
+{
+    for (int i = 0; i < followActions.size(); ++i)
+        followActions.set(i, {});
+
+    const auto tree = apvts.state.getChildWithName(kFollowActionsTree);
+    for (const auto& node : tree)
+    {
+        FollowAction a;
+        a.type = (FollowActionType)(int)node.getProperty(kFollowType, 0);
+        a.unit = (FollowUnit)(int)node.getProperty(kFollowUnit, 1);
+        a.count = (int)node.getProperty(kFollowCount, 1);
+        a.targetClip = (int)node.getProperty(kFollowTarget, -1);
+        followActions.set((int)node.getProperty(kFollowClip, -1), a);
+    }
+}
+
+void DJAM0AudioProcessor::setSlicePattern(int slot, const SlicePattern& pattern)
+{
+    if (slot < 0 || slot >= kNumSlots)
+        return;
+
+    auto tree = apvts.state.getOrCreateChildWithName(kSlicePatternsTree, nullptr);
+    auto node = tree.getChildWithProperty(kSliceSlot, slot);
+
+    if (!pattern.isActive())
+    {
+        tree.removeChild(node, nullptr);
+    }
+    else
+    {
+        if (!node.isValid())
+        {
+            node = juce::ValueTree(kSlicePatternNode);
+            tree.appendChild(node, nullptr);
+        }
+
+        node.setProperty(kSliceSlot, slot, nullptr);
+        node.setProperty(kSlicePattern, pattern.toString(), nullptr);
+    }
+
+    slicePatterns.set(slot, pattern);
+}
+
+SlicePattern DJAM0AudioProcessor::getSlicePattern(int slot) const
+{
+    return slicePatterns.get(slot);
+}
+
+void DJAM0AudioProcessor::syncSlicePatternsFromState()
+{
+    for (int i = 0; i < kNumSlots; ++i)
+        slicePatterns.set(i, {});
+
+    const auto tree = apvts.state.getChildWithName(kSlicePatternsTree);
+    for (const auto& node : tree)
+        slicePatterns.set((int)node.getProperty(kSliceSlot, -1),
+            SlicePattern::fromString(node.getProperty(kSlicePattern).toString()));
 }
 
 //===================== Clip pack helpers =====================
@@ -249,6 +917,9 @@ juce::File DJAM0AudioProcessor::findResourceSamplesRoot() const
 {
     DBG("findResourceSamplesRoot");
 
+    if (samplesFolder != juce::File())
+        return samplesFolder;
+
 #if JUCE_MAC || JUCE_IOS
     auto resources = juce::File::getSpecialLocation(juce::File::currentApplicationFile)
         .getChildFile("Contents").getChildFile("Resources");
@@ -266,56 +937,425 @@ juce::File DJAM0AudioProcessor::findResourceSamplesRoot() const
 void DJAM0AudioProcessor::loadSamplePack()
 {
     DBG("loadSamplePack");
+    bankPager.release();
     pack.clear();
+    followActions.resize(0);
 
     const auto root = findResourceSamplesRoot();
-       
-    if (!root.isDirectory())
-        return;
+    juce::Array<juce::File> files;
+
+    if (root.isDirectory())
+    {
+        DBG("loading sample pack in folder: " + root.getFullPathName());
+        root.findChildFiles(files, juce::File::findFiles, true, "*.wav");
 
-    DBG("loading sample pack in folder: " + root.getFullPathName());
+        // Directory order differs between file systems; clip indices must not
+        files.sort();
 
-    juce::Array<juce::File> files;
-    root.findChildFiles(files, juce::File::findFiles, true, "*.wav");
-    pack.reserve((size_t)files.size());
+        const int maxFiles = kMaxClips - kNumSlots * kTakesPerSlot;
+        if (files.size() > maxFiles)
+        {
+            DBG("sample pack truncated to " + juce::String(maxFiles) + " clips");
+            files.removeRange(maxFiles, files.size() - maxFiles);
+        }
+    }
+
+    // One entry per file, audio loaded per bank by the pager; live-looping takes sit after them
+    numFileClips = files.size();
+    pack.resize((size_t)numFileClips + (size_t)(kNumSlots * kTakesPerSlot));
 
-    for (auto& f : files)
+    // Names and folders (relative to the pack root) are searchable straight away
+    clipSearch.clear(numFileClips);
+    for (int i = 0; i < numFileClips; ++i)
     {
-        DJamClip c;
-        c.loadFromFile(f, getSampleRate());
-        if (c.isLoaded())
-            pack.emplace_back(std::move(c));
+        const auto folders = files[i].getParentDirectory().getRelativePathFrom(root);
+        juce::StringArray tags;
+        if (files[i].getParentDirectory() != root)
+            tags.addTokens(folders, "/\\", {});
+        tags.removeEmptyStrings();
+
+        clipSearch.addClip(i, files[i].getFileNameWithoutExtension(), tags);
     }
 
+    // Content IDs for the whole catalogue (sessions resolve through them); hashing reads each file, so it is cached.
+    // Tempo / bars of clips analysed before come from the clip index too, without loading the audio.
+    parallelFor(numFileClips, [&](int i)
+        {
+            if (ClipAnalysis analysis; analysis.load(clipCache.getEntryFile(files[i], ".djan")) && analysis.valid)
+                clipSearch.setMetadata(i, { analysis.bpm, analysis.bars });
+
+            const auto idFile = clipCache.getEntryFile(files[i], ".djid");
+            ClipId id;
+
+            if (!id.load(idFile))
+            {
+                id = ClipId::fromFileContent(files[i]);
+                id.save(idFile);
+            }
+
+            pack[(size_t)i].setId(id);
+        });
+
+    // Identical files share an ID; the first one in pack order wins
+    clipIndexById.clear();
+    clipIndexById.reserve((size_t)numFileClips);
+    for (int i = 0; i < numFileClips; ++i)
+        if (const auto id = pack[(size_t)i].getId(); id.isValid())
+            clipIndexById.emplace(id, i);
+
     // Rebind slots to the bank (in case 'pack' reallocated)
     for (auto& s : slots)
         s.setClipBank(&pack);
+
+    // Slots keep playing across a reload: their clips' banks are claimed and loaded with the wanted ones
+    bankPager.prepare(pack, files, getSampleRate());
+    for (int s = 0; s < kNumSlots; ++s)
+    {
+        const auto& st = slots[(size_t)s].state();
+        bankPager.setWantedBank(s, (int)slotParams[(size_t)s].bank->load());
+        bankPager.keepClaim(s, ClipBankPager::activeClaim, bankPager.bankOf(st.activeClip));
+        bankPager.keepClaim(s, ClipBankPager::nextClaim, bankPager.bankOf(st.followClip));
+    }
+
+    // Chain table covers the file clips (takes have no follow actions)
+    followActions.resize(numFileClips);
+    syncFollowActionsFromState();
+
+    // A session restored before there was a pack to resolve its clip IDs against
+    if (deferredState.getSize() > 0)
+    {
+        const auto state = std::move(deferredState);
+        setStateInformation(state.getData(), (int)state.getSize());
+    }
+
+    // The slots' banks load here, so playback can start at once; later switches load in the background
+    bankPager.loadWantedBanks();
+}
+
+int DJAM0AudioProcessor::findClipById(ClipId id) const
+{
+    const auto it = clipIndexById.find(id);
+    return it != clipIndexById.end() ? it->second : -1;
+}
+
+ClipId DJAM0AudioProcessor::getClipId(int clipIndex) const
+{
+    if (clipIndex < 0 || clipIndex >= numFileClips)
+        return {};
+
+    return pack[(size_t)clipIndex].getId();
+}
+
+void DJAM0AudioProcessor::requestClip(int slot, int clipIndex)
+{
+    if (slot < 0 || slot >= kNumSlots || clipIndex < 0 || clipIndex >= numFileClips)
+        return;
+
+    // Bank first: its callback re-requests the old position in the new bank, which the clip change then replaces
+    auto setParam = [this](const juce::String& id, int value)
+        {
+            auto* param = apvts.getParameter(id);
+            param->beginChangeGesture();
+            param->setValueNotifyingHost(param->convertTo0to1((float)value));
+            param->endChangeGesture();
+        };
+
+    setParam(paramId_slotBank(slot), clipIndex / kClipsPerBank);
+    setParam(paramId_slotClip(slot), clipIndex % kClipsPerBank);
 }
 
 //===================== State save/restore =====================
 
 void DJAM0AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    juce::MemoryOutputStream mos(destData, true);
-    state.writeToStream(mos);
+    // Still waiting for the pack: hand back what we were given rather than defaults
+    if (deferredState.getSize() > 0)
+    {
+        destData = deferredState;
+        return;
+    }
+
+    // Straight from the parameters and engine atomics: no ValueTree copy, cheap enough for undo snapshots
+    SessionState state;
+
+    const auto& params = getParameters();
+    state.params.reserve((size_t)params.size());
+    for (auto* p : params)
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p))
+            state.params.push_back({ SessionState::hashParamID(ranged->getParameterID()),
+                                     ranged->convertFrom0to1(ranged->getValue()) });
+
+    for (int clip = 0; clip < followActions.size(); ++clip)
+        if (const auto action = followActions.get(clip); action.isActive())
+            state.followActions.push_back({ clip, action });
+
+    for (int slot = 0; slot < kNumSlots; ++slot)
+        if (const auto pattern = slicePatterns.get(slot); pattern.isActive())
+            state.slicePatterns.push_back({ slot, pattern.toString() });
+
+    state.sampleRate = getSampleRate();
+    state.slots.resize((size_t)kNumSlots);
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        const auto bits = slotPlayback[(size_t)i].load(std::memory_order_relaxed);
+        state.slots[(size_t)i] = { (int)(juce::uint32)(bits >> 32), (int)(juce::uint32)bits };
+    }
+
+    if (const auto folder = looper.getTakeFolder(); folder != juce::File())
+        state.takeFolder = folder.getFullPathName();
+
+    addClipIds(state);
+    state.writeTo(destData);
 }
 
 void DJAM0AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    deferredState.reset();
+
+    if (SessionState::isSessionState(data, (size_t)sizeInBytes))
+    {
+        SessionState state;
+        if (!state.readFrom(data, (size_t)sizeInBytes))
+            return;
+
+        // Clip IDs can only be resolved against a loaded pack (prepareToPlay)
+        if (state.hasClipIds() && pack.empty())
+        {
+            deferredState.replaceAll(data, (size_t)sizeInBytes);
+            return;
+        }
+
+        remapClipIndices(state);
+        applySessionState(state);
+        return;
+    }
+
+    // Sessions saved before the binary format
     juce::ValueTree tree = juce::ValueTree::readFromData(data, (size_t)sizeInBytes);
     if (tree.isValid())
+    {
         apvts.replaceState(tree);
+        syncFollowActionsFromState();
+        syncSlicePatternsFromState();
+    }
 }
 
-//===================== Utilities =====================
+void DJAM0AudioProcessor::applySessionState(const SessionState& state)
+{
+    // Parameters: only changed values notify, and the engine ignores each one's own callback
+    std::vector<std::pair<juce::uint32, juce::RangedAudioParameter*>> byHash;
+    for (auto* p : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p))
+            byHash.push_back({ SessionState::hashParamID(ranged->getParameterID()), ranged });
+
+    std::sort(byHash.begin(), byHash.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& saved : state.params)
+    {
+        const auto it = std::lower_bound(byHash.begin(), byHash.end(), saved.idHash,
+            [](const auto& entry, juce::uint32 hash) { return entry.first < hash; });
+        if (it == byHash.end() || it->first != saved.idHash)
+            continue;
+
+        auto* param = it->second;
+        const float normalised = param->convertTo0to1(saved.value);
+        if (normalised != param->getValue())
+        {
+            restoringParam.store(param, std::memory_order_relaxed);
+            param->setValueNotifyingHost(normalised);
+            restoringParam.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    // Follow actions: the ValueTree stays their editable store
+    auto tree = apvts.state.getOrCreateChildWithName(kFollowActionsTree, nullptr);
+    tree.removeAllChildren(nullptr);
+    for (int i = 0; i < followActions.size(); ++i)
+        followActions.set(i, {});
+    for (const auto& f : state.followActions)
+        setClipFollowAction(f.clip, f.action);
+
+    // Slice patterns likewise
+    apvts.state.getOrCreateChildWithName(kSlicePatternsTree, nullptr).removeAllChildren(nullptr);
+    for (int i = 0; i < kNumSlots; ++i)
+        slicePatterns.set(i, {});
+    for (const auto& p : state.slicePatterns)
+        setSlicePattern(p.slot, SlicePattern::fromString(p.pattern));
+
+    // Take folder: a session without one keeps takes in memory only
+    setTakeFolder(juce::File::isAbsolutePath(state.takeFolder) ? juce::File(state.takeFolder) : juce::File());
+
+    // Slot playback, rescaled if the state was saved at another rate
+    auto packet = std::make_unique<RestorePacket>();
+    const double rateScale = state.sampleRate > 0.0 && getSampleRate() > 0.0 ? getSampleRate() / state.sampleRate : 1.0;
+
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        auto& entry = packet->slots[(size_t)i];
+        const int requestedClip = requestedClipIndex(i);
+
+        if (i < (int)state.slots.size())
+        {
+            entry.activeClip = state.slots[(size_t)i].activeClip;
+            entry.phaseSamples = (int)(state.slots[(size_t)i].phaseSamples * rateScale);
+        }
+
+        // The parameter callbacks were skipped: point the loader at the banks the slots need
+        const int activeBank = bankPager.bankOf(entry.activeClip);
+        bankPager.setWantedBank(i, requestedClip < 0 && activeBank != ClipBankPager::kNoBank
+            ? activeBank : (int)slotParams[(size_t)i].bank->load());
+    }
+
+    // Free the applied packets, then replace any not yet taken (it never will be now)
+    for (auto& retired : retiredRestores)
+        delete retired.exchange(nullptr, std::memory_order_acq_rel);
+    delete pendingRestore.exchange(packet.release(), std::memory_order_acq_rel);
+}
+
+static SessionState::Param* findStateParam(SessionState& state, const juce::String& paramID)
+{
+    const auto hash = SessionState::hashParamID(paramID);
+    const auto it = std::find_if(state.params.begin(), state.params.end(),
+        [hash](const SessionState::Param& p) { return p.idHash == hash; });
+    return it != state.params.end() ? &*it : nullptr;
+}
+
+void DJAM0AudioProcessor::addClipIds(SessionState& state) const
+{
+    // Only the indices the state mentions, so a huge pack doesn't bloat every save
+    std::vector<int> referenced;
+    auto refer = [&](int clip)
+        {
+            if (clip >= 0 && clip < numFileClips)
+                referenced.push_back(clip);
+        };
+
+    for (const auto& ids : slotParamIds)
+    {
+        const auto* clip = findStateParam(state, ids.clip);
+        const auto* bank = findStateParam(state, ids.bank);
+        if (clip != nullptr && clip->value >= 0.0f)
+            refer((bank != nullptr ? juce::roundToInt(bank->value) : 0) * kClipsPerBank + juce::roundToInt(clip->value));
+    }
+
+    for (const auto& f : state.followActions)
+    {
+        refer(f.clip);
+        refer(f.action.targetClip);
+    }
+
+    for (const auto& slot : state.slots)
+        refer(slot.activeClip);
+
+    std::sort(referenced.begin(), referenced.end());
+    referenced.erase(std::unique(referenced.begin(), referenced.end()), referenced.end());
+
+    state.numPackClips = numFileClips;
+    state.clipIds.clear();
+    for (const int clip : referenced)
+        if (const auto id = getClipId(clip); id.isValid())
+            state.clipIds.push_back({ clip, id });
+}
+
+void DJAM0AudioProcessor::remapClipIndices(SessionState& state) const
+{
+    if (!state.hasClipIds())
+        return;
+
+    // Pack clips go through their ID (gone = -1); takes keep their place after the pack
+    auto remap = [&](int clip) -> int
+        {
+            if (clip < 0)
+                return -1;
+
+            if (clip >= state.numPackClips)
+            {
+                const int take = numFileClips + (clip - state.numPackClips);
+                return take < (int)pack.size() ? take : -1;
+            }
+
+            const auto it = std::lower_bound(state.clipIds.begin(), state.clipIds.end(), clip,
+                [](const SessionState::ClipRef& ref, int index) { return ref.index < index; });
+            return it != state.clipIds.end() && it->index == clip ? findClipById(it->id) : -1;
+        };
+
+    // Slot clip params pick within the bank param: remap the pair, moving the bank along with the clip
+    for (const auto& ids : slotParamIds)
+    {
+        auto* clip = findStateParam(state, ids.clip);
+        auto* bank = findStateParam(state, ids.bank);
+        if (clip == nullptr || clip->value < 0.0f)
+            continue;
+
+        const int saved = (bank != nullptr ? juce::roundToInt(bank->value) : 0) * kClipsPerBank + juce::roundToInt(clip->value);
+        if (saved >= state.numPackClips)
+            continue;
+
+        const int now = remap(saved);
+        clip->value = now >= 0 ? (float)(now % kClipsPerBank) : -1.0f;
+        if (now >= 0 && bank != nullptr)
+            bank->value = (float)(now / kClipsPerBank);
+    }
+
+    // Follow actions whose clip is gone are dropped; a missing target becomes -1
+    std::vector<SessionState::Follow> follows;
+    for (auto f : state.followActions)
+    {
+        f.clip = remap(f.clip);
+        if (f.clip < 0)
+            continue;
+
+        if (f.action.targetClip >= 0)
+            f.action.targetClip = remap(f.action.targetClip);
+        follows.push_back(f);
+    }
+    state.followActions = std::move(follows);
+
+    for (auto& slot : state.slots)
+    {
+        slot.activeClip = remap(slot.activeClip);
+        if (slot.activeClip < 0)
+            slot.phaseSamples = 0;
+    }
+}
 
-void DJAM0AudioProcessor::setSlotClipName(int slotIndex, const juce::String& name)
+void DJAM0AudioProcessor::applyPendingRestore() noexcept
 {
-    if (slotIndex >= 0 && slotIndex < kNumSlots)
-        apvts.state.setProperty(paramId_slotClipName(slotIndex), name, nullptr);
+    // Only this thread fills the retired slots, so one found free stays free. At most two packets
+    // wait to be freed (one taken as the message thread freed the rest, and the one it then sent)
+    const auto retired = std::find_if(retiredRestores.begin(), retiredRestores.end(),
+        [](const auto& r) { return r.load(std::memory_order_acquire) == nullptr; });
+    if (retired == retiredRestores.end())
+        return;
+
+    auto* packet = pendingRestore.exchange(nullptr, std::memory_order_acq_rel);
+    if (packet == nullptr)
+        return;
+
+    scheduler.stopAll();
+
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        const auto& entry = packet->slots[(size_t)i];
+        const auto& params = slotParams[(size_t)i];
+
+        // Resume only from a bank in memory; otherwise the clip relaunches on a bar once it is loaded
+        const bool resumable = bankPager.claim(i, ClipBankPager::activeClaim, bankPager.bankOf(entry.activeClip));
+        slots[(size_t)i].restore(resumable ? entry.activeClip : -1, entry.phaseSamples,
+            params.mute->load() > 0.5f, params.solo->load() > 0.5f);
+
+        // Or a launch that was waiting for its bar when the state was saved (or requested since)
+        const int requestedClip = requestedClipIndex(i);
+        const int launch = requestedClip >= 0 ? requestedClip : entry.activeClip;
+        if (launch >= 0 && launch != slots[(size_t)i].getActiveClipIndex())
+            scheduler.request({ i, launch });
+    }
+
+    retired->store(packet, std::memory_order_release);
 }
 
+//===================== Utilities =====================
+
 void DJAM0AudioProcessor::toneGen(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
     juce::ignoreUnused(midi);
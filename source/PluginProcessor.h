@@ -2,6 +2,7 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <array>
+#include <unordered_map>
 #include <vector>
 
 #include "DJamHostSync.h"
@@ -9,17 +10,46 @@
 #include "DJamClip.h"
 #include "Slot.h"
 #include "DJamPlayHead.h"
+#include "InternalClock.h"
+#include "FollowActions.h"
+#include "SlicePattern.h"
+#include "SlotInsertChain.h"
+#include "LiveLooper.h"
+#include "Metering.h"
+#include "ClipCache.h"
+#include "ClipBankPager.h"
+#include "ClipSearchIndex.h"
+#include "EngineSnapshot.h"
+#include "RealtimeCheck.h"
+#include "EngineProfiler.h"
+#include "TraceRecorder.h"
+#include "SessionState.h"
+
+#ifndef DJAM_NUM_SLOTS
+ #define DJAM_NUM_SLOTS 8
+#endif
 
 // Forward-declare the editor
 class DJAM0AudioProcessorEditor;
 
 // -------- Shared parameter IDs --------
 static inline juce::String paramId_slotClip(int i) { return "slot" + juce::String(i) + "_clip"; }
-static inline juce::String paramId_slotClipName(int i) { return "slot" + juce::String(i) + "_clipName"; }
-static inline juce::String paramId_slotClipLenBars(int i) { return "slot" + juce::String(i) + "_clipLenBars"; }
-static inline juce::String paramId_slotClipSamplesAt(int i) { return "slot" + juce::String(i) + "_clipSamplesAt"; }
+static inline juce::String paramId_slotBank(int i) { return "slot" + juce::String(i) + "_bank"; }
 static inline juce::String paramId_slotMute(int i) { return "slot" + juce::String(i) + "_mute"; }
 static inline juce::String paramId_slotSolo(int i) { return "slot" + juce::String(i) + "_solo"; }
+static inline juce::String paramId_recBars() { return "recBars"; }
+static inline juce::String paramId_normalise() { return "normalise"; }
+static inline juce::String paramId_loopCrossfade() { return "loopCrossfade"; }
+static inline juce::String paramId_clockMode() { return "clockMode"; }
+static inline juce::String paramId_clockBpm() { return "clockBpm"; }
+static inline juce::String paramId_clockNumerator() { return "clockNumerator"; }
+static inline juce::String paramId_clockRun() { return "clockRun"; }
+static inline juce::String paramId_slotFx(int i) { return "slot" + juce::String(i) + "_fx"; }
+static inline juce::String paramId_slotFxCutoff(int i) { return "slot" + juce::String(i) + "_fxCutoff"; }
+static inline juce::String paramId_slotFxEqGain(int i) { return "slot" + juce::String(i) + "_fxEqGain"; }
+static inline juce::String paramId_slotFxDrive(int i) { return "slot" + juce::String(i) + "_fxDrive"; }
+static inline juce::String paramId_slotFxDelayMix(int i) { return "slot" + juce::String(i) + "_fxDelayMix"; }
+static inline juce::String paramId_slotFxDelayTime(int i) { return "slot" + juce::String(i) + "_fxDelayTime"; }
 
 class DJAM0AudioProcessor
     : public juce::AudioProcessor
@@ -34,6 +64,9 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+    bool canAddBus(bool isInput) const override;
+    bool canRemoveBus(bool isInput) const override;
+    void processorLayoutsChanged() override;
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     void toneGen(juce::AudioBuffer<float>&, juce::MidiBuffer&);
@@ -59,35 +92,225 @@ public:
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
     static constexpr int getNumSlots() { return kNumSlots; }
 
-    // UI label sync (stores to APVTS.state property)
-    void setSlotClipName(int slotIndex, const juce::String& name);
+    // Where the clip pack is loaded from on the next prepareToPlay (tools, tests).
+    // An empty File goes back to the platform default.
+    void setSamplesFolder(const juce::File& folder) { samplesFolder = folder; }
+
+    /** Backstop for bar splitting; the host tempo limits keep real blocks far below it. */
+    static constexpr int kMaxSegmentsPerBlock = 256;
+
+    /** Bar-split render segments in the last processBlock (tools and tests). */
+    int getLastBlockSegments() const noexcept { return lastBlockSegments.load(std::memory_order_relaxed); }
+
+    /** Reseeds the follow-action dice (slot i gets seed + i) for reproducible renders. Call before playback. */
+    void setFollowSeed(juce::int64 seed);
+
+    /**
+     * What the engine keeps time with (clockMode parameter): the host's
+     * transport, the internal clock, or the host when it reports a position
+     * and the internal clock when it doesn't (Standalone, play-head-less hosts).
+     */
+    enum class ClockMode { host = 0, internal, autoSelect };
+
+    /** True when the last block ran on the internal clock (any thread). */
+    bool isUsingInternalClock() const noexcept { return usingInternalClock.load(std::memory_order_relaxed); }
+
+    /** Clips loaded from the pack (live takes come after these). */
+    int getNumPackClips() const noexcept { return numFileClips; }
+
+    /** Pack clips plus takes. Files past this are not loaded. */
+    static constexpr int kMaxClips = ClipBankPager::kMaxBanks * ClipBankPager::kClipsPerBank;
+
+    // A slot's clip parameter picks within its bank parameter: clip index = bank * kClipsPerBank + clip
+    static constexpr int kClipsPerBank = ClipBankPager::kClipsPerBank;
+
+    /** Banks in the loaded pack, and how many are in memory right now (any thread). */
+    int getNumBanks() const noexcept { return bankPager.getNumBanks(); }
+    int getNumResidentBanks() const noexcept { return bankPager.getNumResidentBanks(); }
+
+    /** Pack index of the clip with this content ID, or -1 (message thread; O(1)). */
+    int findClipById(ClipId id) const;
+
+    /** Content ID of a pack clip; invalid for takes and out-of-range indices. */
+    ClipId getClipId(int clipIndex) const;
+
+    /** Name / folder / tempo index over the pack, filled while it loads (search on the message thread). */
+    const ClipSearchIndex& getClipSearch() const noexcept { return clipSearch; }
+
+    /** Message thread: points a slot at a pack clip through its bank and clip parameters (queued like a host change). */
+    void requestClip(int slot, int clipIndex);
+
+    // Insert chain CPU, as a fraction of the block's real-time budget (any thread)
+    float getSlotInsertLoad(int slot) const noexcept;
+
+    // Meters (lock-free; written once per block, read by the editor)
+    MeterChannel& getSlotMeter(int slot) noexcept { return slotMeters[(size_t)slot]; }
+    MeterChannel& getMasterMeter() noexcept { return masterMeter; }
+    MomentaryLoudness& getMasterLoudness() noexcept { return masterLoudness; }
 
-    
+    // processBlock timing (populated only when built with DJAM_PROFILE=1)
+    EngineProfiler& getProfiler() noexcept { return profiler; }
+
+    // Editor refresh (message thread): fills `snapshot` from lock-free state, for the slots in `slotRange` only
+    // (the rest keep their previous values; the vector always holds every slot)
+    void captureSnapshot(EngineSnapshot& snapshot, juce::Range<int> slotRange = { 0, kNumSlots }) const;
+
+    // Clip info for the editor (message thread)
+    struct ClipInfo
+    {
+        juce::String name;
+        int loopBars = 0;
+        int numSamples = 0;
+        std::shared_ptr<const WaveformOverview> overview;
+    };
+    ClipInfo getClipInfo(int clipIndex) const;
+
+    // Live looping (message thread). Arming records `recBars` bars from the
+    // input bus, starting at the next bar, then launches the take in the slot.
+    bool armSlotRecording(int slot);
+    void cancelSlotRecording(int slot);
+    LiveLooper::State getSlotRecordState(int slot) const noexcept;
+    void setTakeFolder(const juce::File& folder);   // saved with the session
+    juce::File getTakeFolder() const { return looper.getTakeFolder(); }
+
+    // Follow actions (message thread; persisted in APVTS.state)
+    void setClipFollowAction(int clipIndex, const FollowAction& action);
+    FollowAction getClipFollowAction(int clipIndex) const;
+
+    // Slice sequences (message thread; persisted in APVTS.state). An inactive pattern plays the clip straight.
+    void setSlicePattern(int slot, const SlicePattern& pattern);
+    SlicePattern getSlicePattern(int slot) const;
+    juce::uint32 getSlicePatternVersion(int slot) const noexcept { return slicePatterns.getVersion(slot); }
 
     // APVTS param change listener
     void parameterChanged(const juce::String& paramID, float newValue) override;
 
 private:
     //==========================================================================
-    static constexpr int kNumSlots = 8;
+    static constexpr int kNumSlots = DJAM_NUM_SLOTS;
+    static constexpr int kTakesPerSlot = 2;   // ping-pong: record one while the other plays
+
+    // Buses: main in/out plus one optional stereo output per slot
+    static BusesProperties createBusesProperties();
+    static constexpr int slotOutputBus(int slot) noexcept { return 1 + slot; }
 
     // Params
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     // Engine
-    std::vector<DJamClip>           pack;   // loaded clips (bank)
+    std::vector<DJamClip>           pack;   // pack clips (audio resident per bank), then takes
     std::array<Slot, kNumSlots>     slots;  // performer channels
-    QuantizedScheduler              scheduler;
+    QuantizedScheduler<kNumSlots>   scheduler;
     HostPhase                       hostPhase{};
     DJamPlayHead                    playHead;
+    struct SlotRoute { int firstChannel = -1; int numChannels = 0; }; // -1 = main mix
+    std::array<SlotRoute, kNumSlots> slotRoutes{};    // host-enabled per-slot outputs
+    std::array<SlotInsertChain, kNumSlots> inserts;    // per-slot FX
+    juce::AudioBuffer<float>        insertScratch;    // isolates a slot for its inserts
+    std::array<LevelAccumulator, kNumSlots> slotLevels; // audio thread, per block
+    std::array<MeterChannel, kNumSlots> slotMeters;
+    MeterChannel                    masterMeter;
+    MomentaryLoudness               masterLoudness;
+    std::array<std::atomic<juce::uint64>, kNumSlots> slotPlayback{}; // packed active clip + phase
+    std::array<std::atomic<int>, kNumSlots> slotPendingLaunch{};     // clip starting on a coming bar, -1 = none
+    std::atomic<int>                lastBlockSegments{ 0 };
+    std::atomic<double>             publishedBpm{ 120.0 };      // hostPhase tempo and meter for the message thread
+    std::atomic<int>                publishedNumerator{ 4 };
+    InternalClock                   clock;          // transport when the host's isn't used
+    std::atomic<bool>               usingInternalClock{ false };
+    ClipCache                       clipCache;
+    ClipBankPager                   bankPager{ kNumSlots, clipCache };  // pack audio, loaded per bank
+    ClipSearchIndex                 clipSearch;     // pack clips by name, tags and tempo
+    EngineProfiler                  profiler;
+    LiveLooper                      looper{ kNumSlots };
+    int                             numFileClips = 0;   // takes follow the file clips in `pack`
+    std::unordered_map<ClipId, int> clipIndexById;      // file clips only; rebuilt by loadSamplePack()
+    std::array<int, kNumSlots>      lastTake{};
+    FollowActionTable               followActions;  // chain table, one entry per clip
+    std::array<juce::Random, kNumSlots> followRandom; // per slot, so slots stay independent; audio thread only
+    SlicePatternTable               slicePatterns{ kNumSlots };
+    std::array<juce::uint32, kNumSlots> slicePatternVersions{}; // audio thread: last copy handed to each slot
+    SlicePattern                    slicePatternScratch;        // audio thread
+
+    // Raw insert-chain params, cached for the audio thread
+    struct SlotFxParams
+    {
+        std::atomic<float>* enabled = nullptr;
+        std::atomic<float>* cutoff = nullptr;
+        std::atomic<float>* eqGain = nullptr;
+        std::atomic<float>* drive = nullptr;
+        std::atomic<float>* delayMix = nullptr;
+        std::atomic<float>* delayTime = nullptr;
+    };
+    std::array<SlotFxParams, kNumSlots> fxParams{};
+
+    // Raw slot params, cached so snapshots skip the ID lookups
+    struct SlotParams
+    {
+        std::atomic<float>* clip = nullptr;
+        std::atomic<float>* bank = nullptr;
+        std::atomic<float>* mute = nullptr;
+        std::atomic<float>* solo = nullptr;
+    };
+    std::array<SlotParams, kNumSlots> slotParams{};
+
+    // Slot param IDs, built once so parameterChanged() never allocates
+    struct SlotParamIds { juce::String clip, bank, mute, solo; };
+    std::array<SlotParamIds, kNumSlots> slotParamIds;
+    std::atomic<float>* normaliseParam = nullptr;
+    std::atomic<float>* loopCrossfadeParam = nullptr;
+
+    // Internal clock params (audio thread)
+    struct ClockParams
+    {
+        std::atomic<float>* mode = nullptr;
+        std::atomic<float>* bpm = nullptr;
+        std::atomic<float>* numerator = nullptr;
+        std::atomic<float>* run = nullptr;
+    };
+    ClockParams clockParams;
+    juce::AudioPlayHead* selectTransport() noexcept;
+    juce::File samplesFolder;   // overrides findResourceSamplesRoot() when set
 
     // Helpers
     juce::File findResourceSamplesRoot() const;
     void loadSamplePack();
+    void syncFollowActionsFromState();
+    void syncSlicePatternsFromState();
+
+    // State restore: parameters and follow actions on the message thread, slot playback
+    // handed to the audio thread as one packet and applied in the next block, after its transport edges
+    // (clip requests, mute and solo are read from the parameters then, so automation since isn't lost)
+    struct RestorePacket
+    {
+        struct SlotEntry { int activeClip = -1, phaseSamples = 0; };
+        std::array<SlotEntry, kNumSlots> slots{};
+    };
+
+    void applySessionState(const SessionState& state);
+    void addClipIds(SessionState& state) const;
+    void remapClipIndices(SessionState& state) const;
+    void applyPendingRestore() noexcept;
+
+    std::atomic<RestorePacket*>     pendingRestore{ nullptr };  // message thread -> audio thread
+    std::array<std::atomic<RestorePacket*>, 4> retiredRestores{}; // applied; freed by the message thread
+    std::atomic<const juce::RangedAudioParameter*> restoringParam{ nullptr }; // its callback is ignored
+    juce::MemoryBlock               deferredState;  // set before the pack was loaded; applied once it is
+
+    void updateSlotRouting();
+    int takeClipIndex(int slot, int take) const noexcept { return numFileClips + slot * kTakesPerSlot + take; }
+    void renderSlotWithInserts(int slot, juce::AudioBuffer<float>& sub, int numSamples, bool ownBus);
+
+    // Bar-boundary follow-action evaluation (audio thread, no allocation)
+    void advanceFollowActions();
+    void prepareFollowActions();
 
     // Param reactions (working-state only)
     void onSlotClipParamChanged(int slot, int newClipIdx);
+    void onSlotBankParamChanged(int slot, int newBank);
+    int requestedClipIndex(int slot) const noexcept;    // bank and clip params as a pack index; -1 = none
+    bool armSlot(int slot, int clip) noexcept;          // claims the clip's bank first; false if not resident
     void onSlotMuteParamChanged(int slot, bool mute);
     void onSlotSoloParamChanged(int slot, bool solo);
 
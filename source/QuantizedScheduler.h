@@ -1,5 +1,7 @@
 #pragma once
-#include <vector>
+#include <array>
+#include <atomic>
+#include <cstddef>
 
 /**
  * Represents a single queued start request for a clip.
@@ -15,55 +17,99 @@ struct StartRequest
  * Clip start scheduler that queues launch requests and applies them
  * atomically at quantized boundaries (e.g., start of next bar).
  *
- * Typically used in processBlock to commit new clip starts in sync.
+ * request() may be called from any thread (editor, parameter callbacks,
+ * host automation on the audio thread): each slot has one atomic inbox
+ * word, and a newer request for a slot replaces its older one, which is
+ * also what applying both would do. Everything else belongs to the audio
+ * thread, which moves the inboxes into its own pending table in collect().
+ * Storage is fixed, one entry per slot, so nothing allocates or drops.
  */
+template <int NumSlots>
 class QuantizedScheduler
 {
 public:
-    /** Queue a start request to trigger on the next quantized boundary. */
-    void request(const StartRequest& r)
+    QuantizedScheduler() noexcept
     {
-        pending.emplace_back(r);
+        for (auto& word : inbox)
+            word.store(kNone, std::memory_order_relaxed);
+        pending.fill(kNone);
+    }
+
+    /** Queue a start request to trigger on the next quantized boundary (any thread). */
+    void request(const StartRequest& r) noexcept
+    {
+        if (r.slot >= 0 && r.slot < NumSlots && r.clip >= 0)
+            inbox[(size_t)r.slot].store(r.clip, std::memory_order_release);
+    }
+
+    /** Audio thread: takes in the requests made since the last call (top of processBlock). */
+    void collect() noexcept
+    {
+        for (int s = 0; s < NumSlots; ++s)
+        {
+            const int clip = inbox[(size_t)s].exchange(kNone, std::memory_order_acquire);
+            if (clip != kNone)
+                pending[(size_t)s] = clip;
+        }
     }
 
     /**
      * Flush all pending requests.
      * Should be called at the quantization boundary (e.g. start of bar).
-     * The provided lambda `apply` will be invoked for each request.
+     * The provided lambda `apply` will be invoked for each request; it
+     * returns false to keep the request for the next boundary (e.g. its
+     * clip isn't loaded yet).
      */
     template <typename ApplyFn>
     void flushAtBar(ApplyFn&& apply)
     {
-        for (const auto& r : pending)
-            apply(r);
-        pending.clear();
+        collect();
+
+        for (int s = 0; s < NumSlots; ++s)
+            if (pending[(size_t)s] != kNone && apply(StartRequest{ s, pending[(size_t)s] }))
+                pending[(size_t)s] = kNone;
     }
 
-    /** Cancels all pending requests (e.g. on stop or transport jump). */
-    void stopAll()
+    /** Cancels all pending requests, including ones not collected yet (explicit transport stop). */
+    void stopAll() noexcept
     {
-        pending.clear();
+        for (auto& word : inbox)
+            word.store(kNone, std::memory_order_relaxed);
+        pending.fill(kNone);
     }
 
-    /** Clears state and optionally resets scheduler position. */
-    void resetToHostPosition(double ppq)
+    /**
+     * Re-anchors on transport start. Pending requests are kept: launches
+     * queued while stopped land on the first bar of playback.
+     */
+    void resetToHostPosition(double ppq) noexcept
     {
-        pending.clear();
         currentPPQ = ppq;
     }
 
-    /** Realigns without flushing (e.g. during host jump). */
-    void realignTo(double ppq)
+    /** Re-anchors after a locate or cycle wrap; pending requests still land on the next bar. */
+    void realignTo(double ppq) noexcept
     {
         currentPPQ = ppq;
-        // Optionally drop pending requests, or preserve?
-        pending.clear();
     }
 
-    /** Returns true if there are any queued requests. */
+    /** Clip queued for `slot`, or -1 (audio thread). */
+    int getPendingClip(int slot) const noexcept
+    {
+        if (slot < 0 || slot >= NumSlots)
+            return kNone;
+
+        const int fresh = inbox[(size_t)slot].load(std::memory_order_acquire);
+        return fresh != kNone ? fresh : pending[(size_t)slot];
+    }
+
+    /** Returns true if there are any queued requests (audio thread). */
     bool hasPending() const noexcept
     {
-        return !pending.empty();
+        for (int s = 0; s < NumSlots; ++s)
+            if (getPendingClip(s) != kNone)
+                return true;
+        return false;
     }
 
     /** (Optional) Get the internal PPQ position. */
@@ -71,6 +117,9 @@ public:
 
 
 private:
-    std::vector<StartRequest> pending;
+    static constexpr int kNone = -1;
+
+    std::array<std::atomic<int>, NumSlots> inbox;   // any thread -> audio thread, one request per slot
+    std::array<int, NumSlots> pending{};             // audio thread only
     double currentPPQ = 0.0;
 };
@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * Marks the audio callback for the real-time safety checker (tools/rtcheck).
+ *
+ * Compiled out unless DJAM_RT_CHECK is defined. When it is, the checker's
+ * interposed malloc/free, lock and blocking-syscall hooks report every call
+ * they see while a thread's callback depth is non-zero.
+ */
+#if DJAM_RT_CHECK
+
+namespace djam::rt
+{
+    inline thread_local int callbackDepth = 0;
+
+    struct ScopedAudioCallback
+    {
+        ScopedAudioCallback() noexcept { ++callbackDepth; }
+        ~ScopedAudioCallback() noexcept { --callbackDepth; }
+    };
+}
+
+ #define DJAM_RT_AUDIO_CALLBACK_SCOPE const djam::rt::ScopedAudioCallback djamRtAudioCallbackScope;
+
+#else
+
+ #define DJAM_RT_AUDIO_CALLBACK_SCOPE
+
+#endif
@@ -0,0 +1,229 @@
+#include "SessionState.h"
+
+static constexpr juce::uint32 makeTag(char a, char b, char c, char d) noexcept
+{
+    return (juce::uint32)(juce::uint8)a | ((juce::uint32)(juce::uint8)b << 8)
+         | ((juce::uint32)(juce::uint8)c << 16) | ((juce::uint32)(juce::uint8)d << 24);
+}
+
+static constexpr juce::uint32 kParamsChunk = makeTag('P', 'A', 'R', 'M');
+static constexpr juce::uint32 kFollowChunk = makeTag('F', 'O', 'L', 'W');
+static constexpr juce::uint32 kPlaybackChunk = makeTag('P', 'L', 'A', 'Y');
+static constexpr juce::uint32 kClipIdChunk = makeTag('C', 'L', 'I', 'D');
+static constexpr juce::uint32 kSlicesChunk = makeTag('S', 'L', 'C', 'E');
+static constexpr juce::uint32 kTakeFolderChunk = makeTag('T', 'A', 'K', 'E');
+
+juce::uint32 SessionState::hashParamID(const juce::String& paramID) noexcept
+{
+    // FNV-1a over the UTF-8 bytes: stable across runs and platforms, unlike String::hash()
+    juce::uint32 h = 0x811c9dc5u;
+    for (auto* p = paramID.toRawUTF8(); *p != 0; ++p)
+        h = (h ^ (juce::uint8)*p) * 0x01000193u;
+    return h;
+}
+
+//===================== Writing =====================
+
+template <typename WriteFn>
+static void writeChunk(juce::MemoryOutputStream& out, juce::uint32 tag, WriteFn&& write)
+{
+    juce::MemoryOutputStream payload;
+    write(payload);
+
+    out.writeInt((int)tag);
+    out.writeInt((int)payload.getDataSize());
+    out.write(payload.getData(), payload.getDataSize());
+}
+
+void SessionState::writeTo(juce::MemoryBlock& dest) const
+{
+    juce::MemoryOutputStream out(dest, false);
+
+    out.writeInt((int)kMagic);
+    out.writeInt((int)kVersion);
+
+    writeChunk(out, kParamsChunk, [this](juce::MemoryOutputStream& s)
+        {
+            s.writeInt((int)params.size());
+            for (const auto& p : params)
+            {
+                s.writeInt((int)p.idHash);
+                s.writeFloat(p.value);
+            }
+        });
+
+    if (!followActions.empty())
+        writeChunk(out, kFollowChunk, [this](juce::MemoryOutputStream& s)
+            {
+                s.writeInt((int)followActions.size());
+                for (const auto& f : followActions)
+                {
+                    s.writeInt(f.clip);
+                    s.writeByte((char)f.action.type);
+                    s.writeByte((char)f.action.unit);
+                    s.writeShort((short)juce::jlimit(0, 32767, f.action.count));
+                    s.writeInt(f.action.targetClip);
+                }
+            });
+
+    writeChunk(out, kPlaybackChunk, [this](juce::MemoryOutputStream& s)
+        {
+            s.writeDouble(sampleRate);
+            s.writeInt((int)slots.size());
+            for (const auto& slot : slots)
+            {
+                s.writeInt(slot.activeClip);
+                s.writeInt(slot.phaseSamples);
+            }
+        });
+
+    if (hasClipIds())
+        writeChunk(out, kClipIdChunk, [this](juce::MemoryOutputStream& s)
+            {
+                s.writeInt(numPackClips);
+                s.writeInt((int)clipIds.size());
+                for (const auto& ref : clipIds)
+                {
+                    s.writeInt(ref.index);
+                    s.writeInt64((juce::int64)ref.id.value);
+                }
+            });
+
+    if (!slicePatterns.empty())
+        writeChunk(out, kSlicesChunk, [this](juce::MemoryOutputStream& s)
+            {
+                s.writeInt((int)slicePatterns.size());
+                for (const auto& p : slicePatterns)
+                {
+                    s.writeInt(p.slot);
+                    s.writeString(p.pattern);
+                }
+            });
+
+    if (takeFolder.isNotEmpty())
+        writeChunk(out, kTakeFolderChunk, [this](juce::MemoryOutputStream& s) { s.writeString(takeFolder); });
+}
+
+//===================== Reading =====================
+
+bool SessionState::isSessionState(const void* data, size_t size) noexcept
+{
+    return size >= 8 && juce::ByteOrder::littleEndianInt(data) == kMagic;
+}
+
+bool SessionState::readFrom(const void* data, size_t size)
+{
+    if (!isSessionState(data, size))
+        return false;
+
+    juce::MemoryInputStream in(data, size, false);
+    in.readInt();
+    if ((juce::uint32)in.readInt() != kVersion)
+        return false;
+
+    params.clear();
+    followActions.clear();
+    slots.clear();
+    clipIds.clear();
+    numPackClips = -1;
+    slicePatterns.clear();
+    takeFolder.clear();
+
+    while (in.getNumBytesRemaining() >= 8)
+    {
+        const auto tag = (juce::uint32)in.readInt();
+        const auto chunkSize = (juce::int64)(juce::uint32)in.readInt();
+        if (chunkSize > in.getNumBytesRemaining())
+            return false;
+
+        const auto chunkEnd = in.getPosition() + chunkSize;
+
+        // Counts are checked against the chunk size before anything is reserved
+        if (tag == kParamsChunk)
+        {
+            const int count = in.readInt();
+            if (count < 0 || (juce::int64)count * 8 > chunkSize - 4)
+                return false;
+
+            params.reserve((size_t)count);
+            for (int i = 0; i < count; ++i)
+            {
+                const auto idHash = (juce::uint32)in.readInt();
+                params.push_back({ idHash, in.readFloat() });
+            }
+        }
+        else if (tag == kFollowChunk)
+        {
+            const int count = in.readInt();
+            if (count < 0 || (juce::int64)count * 12 > chunkSize - 4)
+                return false;
+
+            followActions.reserve((size_t)count);
+            for (int i = 0; i < count; ++i)
+            {
+                Follow f;
+                f.clip = in.readInt();
+                f.action.type = (FollowActionType)(juce::uint8)in.readByte();
+                f.action.unit = (FollowUnit)(juce::uint8)in.readByte();
+                f.action.count = in.readShort();
+                f.action.targetClip = in.readInt();
+
+                if (f.action.type <= FollowActionType::stop && f.action.unit <= FollowUnit::loops)
+                    followActions.push_back(f);
+            }
+        }
+        else if (tag == kPlaybackChunk)
+        {
+            sampleRate = in.readDouble();
+            const int count = in.readInt();
+            if (count < 0 || (juce::int64)count * 8 > chunkSize - 12)
+                return false;
+
+            slots.resize((size_t)count);
+            for (auto& slot : slots)
+            {
+                slot.activeClip = in.readInt();
+                slot.phaseSamples = juce::jmax(0, in.readInt());
+            }
+        }
+        else if (tag == kClipIdChunk)
+        {
+            const int packClips = in.readInt();
+            const int count = in.readInt();
+            if (packClips < 0 || count < 0 || (juce::int64)count * 12 > chunkSize - 8)
+                return false;
+
+            clipIds.reserve((size_t)count);
+            for (int i = 0; i < count; ++i)
+            {
+                const int index = in.readInt();
+                clipIds.push_back({ index, { (juce::uint64)in.readInt64() } });
+            }
+
+            std::sort(clipIds.begin(), clipIds.end(), [](const auto& a, const auto& b) { return a.index < b.index; });
+            numPackClips = packClips;
+        }
+        else if (tag == kSlicesChunk)
+        {
+            // Slot plus at least a string terminator per entry
+            const int count = in.readInt();
+            if (count < 0 || (juce::int64)count * 5 > chunkSize - 4)
+                return false;
+
+            slicePatterns.reserve((size_t)count);
+            for (int i = 0; i < count; ++i)
+            {
+                const int slot = in.readInt();
+                slicePatterns.push_back({ slot, in.readString() });
+            }
+        }
+        else if (tag == kTakeFolderChunk)
+        {
+            takeFolder = in.readString();
+        }
+
+        in.setPosition(chunkEnd);
+    }
+
+    return true;
+}
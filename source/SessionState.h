@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <juce_core/juce_core.h>
+#include "FollowActions.h"
+#include "ClipId.h"
+
+/**
+ * Compact binary plugin state.
+ *
+ * Layout: "DJST" magic, format version, then tagged chunks (tag, byte size,
+ * payload), little-endian. Readers skip chunks they don't know, so new data
+ * gets a new chunk rather than a version bump; the version only changes when
+ * an existing chunk's layout does.
+ *
+ *   PARM  parameter values, keyed by the hash of the parameter ID
+ *   FOLW  follow actions, one entry per clip that has one
+ *   PLAY  per-slot playing clip and loop position, with the sample rate
+ *   CLID  content ID of every pack clip index the other chunks refer to
+ *   SLCE  per-slot slice patterns (text form), one entry per slot that has one
+ *   TAKE  folder live-looped takes are written to (absent = not written)
+ *
+ * Clip indices are positions in the pack at save time; CLID lets the reader
+ * map them to wherever those clips sit now (see DJAM0AudioProcessor). States
+ * without it keep their indices as they are.
+ *
+ * A parameter that is missing from the state keeps its current value.
+ */
+struct SessionState
+{
+    static constexpr juce::uint32 kMagic = 0x54534a44; // "DJST"
+    static constexpr juce::uint32 kVersion = 1;
+
+    struct Param { juce::uint32 idHash; float value; };
+    struct Follow { int clip; FollowAction action; };
+    struct SlotPlayback { int activeClip = -1; int phaseSamples = 0; };
+    struct ClipRef { int index; ClipId id; };
+    struct Slices { int slot; juce::String pattern; };
+
+    std::vector<Param> params;          // plain (denormalised) values
+    std::vector<Follow> followActions;
+    std::vector<SlotPlayback> slots;
+    double sampleRate = 0.0;            // what phaseSamples were counted at
+    std::vector<ClipRef> clipIds;       // sorted by index
+    int numPackClips = -1;              // pack size the indices were saved against; -1 = no CLID chunk
+    std::vector<Slices> slicePatterns;
+    juce::String takeFolder;            // full path; empty = takes stay in memory
+
+    bool hasClipIds() const noexcept { return numPackClips >= 0; }
+
+    /** Stable key for a parameter ID. */
+    static juce::uint32 hashParamID(const juce::String& paramID) noexcept;
+
+    void writeTo(juce::MemoryBlock& dest) const;
+
+    /** False if `data` isn't this format (or is truncated); the state is then left partially filled. */
+    bool readFrom(const void* data, size_t size);
+
+    /** Cheap check for the magic, to tell this format from older ValueTree states. */
+    static bool isSessionState(const void* data, size_t size) noexcept;
+};
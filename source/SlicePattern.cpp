@@ -0,0 +1,189 @@
+#include "SlicePattern.h"
+
+//===================== Text form =====================
+
+SlicePattern SlicePattern::fromString(const juce::String& text)
+{
+    SlicePattern p;
+    auto body = text.trim().toLowerCase();
+
+    if (body.startsWith("t:") || body.startsWith("b:"))
+    {
+        p.source = body[0] == 't' ? SliceSource::transients : SliceSource::beats;
+        body = body.substring(2);
+    }
+
+    for (const auto& word : juce::StringArray::fromTokens(body, " \t,", ""))
+    {
+        if (word.isEmpty() || p.numSteps == kMaxSteps)
+            continue;
+
+        SliceStep step;
+
+        if (word == "-" || word == ".")
+        {
+            step.slice = SliceStep::kRest;
+        }
+        else
+        {
+            const auto digits = word.initialSectionContainingOnly("0123456789");
+            if (digits.isEmpty())
+                continue;
+
+            step.slice = juce::jlimit(1, SliceTable::kMaxSlices, digits.getIntValue()) - 1;
+
+            for (auto rest = word.substring(digits.length()); rest.isNotEmpty();)
+            {
+                if (rest[0] == 'r')
+                {
+                    step.reverse = true;
+                    rest = rest.substring(1);
+                }
+                else if (rest[0] == 'x')
+                {
+                    const auto count = rest.substring(1).initialSectionContainingOnly("0123456789");
+                    step.repeats = juce::jlimit(1, SliceStep::kMaxRepeats, count.getIntValue());
+                    rest = rest.substring(1 + count.length());
+                }
+                else
+                {
+                    break;  // rest of the word unreadable: keep what was read
+                }
+            }
+        }
+
+        p.steps[(size_t)p.numSteps++] = step;
+    }
+
+    return p;
+}
+
+juce::String SlicePattern::toString() const
+{
+    if (!isActive())
+        return {};
+
+    juce::StringArray words;
+    for (int i = 0; i < numSteps; ++i)
+    {
+        const auto& s = steps[(size_t)i];
+        if (s.slice == SliceStep::kRest)
+        {
+            words.add("-");
+            continue;
+        }
+
+        auto word = juce::String(s.slice + 1);
+        if (s.reverse)
+            word << "r";
+        if (s.repeats > 1)
+            word << "x" << s.repeats;
+        words.add(word);
+    }
+
+    return (source == SliceSource::transients ? "t: " : "") + words.joinIntoString(" ");
+}
+
+//===================== Slot table =====================
+
+SlicePatternTable::SlicePatternTable(int numSlots)
+    : entries(new Entry[(size_t)juce::jmax(0, numSlots)]),
+      numEntries(juce::jmax(0, numSlots))
+{
+}
+
+// Layout: [11..9] repeats - 1 | [8] reverse | [7..0] slice + 1 (0 = rest)
+juce::uint16 SlicePatternTable::packStep(const SliceStep& s) noexcept
+{
+    const int slice = s.slice == SliceStep::kRest ? 0 : juce::jlimit(0, 254, s.slice) + 1;
+    return (juce::uint16)(slice
+         | (s.reverse ? 1 << 8 : 0)
+         | ((juce::jlimit(1, SliceStep::kMaxRepeats, s.repeats) - 1) << 9));
+}
+
+SliceStep SlicePatternTable::unpackStep(juce::uint16 bits) noexcept
+{
+    SliceStep s;
+    s.slice = (int)(bits & 0xff) - 1;
+    s.reverse = (bits & (1 << 8)) != 0;
+    s.repeats = ((bits >> 9) & 0x7) + 1;
+    return s;
+}
+
+void SlicePatternTable::set(int slot, const SlicePattern& pattern) noexcept
+{
+    if (slot < 0 || slot >= numEntries)
+        return;
+
+    auto& e = entries[(size_t)slot];
+    e.sequence.fetch_add(1);
+
+    const int numSteps = juce::jlimit(0, SlicePattern::kMaxSteps, pattern.numSteps);
+    e.header.store((juce::uint32)numSteps | ((juce::uint32)pattern.source << 8));
+
+    for (int w = 0; w < kNumWords; ++w)
+    {
+        juce::uint64 word = 0;
+        for (int i = 0; i < kStepsPerWord; ++i)
+            word |= (juce::uint64)packStep(pattern.steps[(size_t)(w * kStepsPerWord + i)]) << (16 * i);
+
+        e.words[(size_t)w].store(word);
+    }
+
+    e.sequence.fetch_add(1);
+}
+
+void SlicePatternTable::readEntry(const Entry& e, SlicePattern& pattern) noexcept
+{
+    const auto header = e.header.load();
+    pattern.numSteps = juce::jmin(SlicePattern::kMaxSteps, (int)(header & 0xff));
+    pattern.source = (SliceSource)((header >> 8) & 0xff);
+
+    for (int w = 0; w < kNumWords; ++w)
+    {
+        const auto word = e.words[(size_t)w].load();
+        for (int i = 0; i < kStepsPerWord; ++i)
+            pattern.steps[(size_t)(w * kStepsPerWord + i)] = unpackStep((juce::uint16)(word >> (16 * i)));
+    }
+}
+
+SlicePattern SlicePatternTable::get(int slot) const noexcept
+{
+    SlicePattern p;
+    if (slot < 0 || slot >= numEntries)
+        return p;
+
+    // Retried until no write overlapped the read (host state saves may come from another thread)
+    const auto& e = entries[(size_t)slot];
+    for (;;)
+    {
+        const auto before = e.sequence.load();
+        if ((before & 1) != 0)
+            continue;
+
+        readEntry(e, p);
+        if (e.sequence.load() == before)
+            return p;
+    }
+}
+
+bool SlicePatternTable::readIfChanged(int slot, juce::uint32& version, SlicePattern& pattern) const noexcept
+{
+    if (slot < 0 || slot >= numEntries)
+        return false;
+
+    const auto& e = entries[(size_t)slot];
+    const auto before = e.sequence.load();
+    if ((before & 1) != 0 || before == version)
+        return false;
+
+    SlicePattern copy;
+    readEntry(e, copy);
+
+    if (e.sequence.load() != before)
+        return false;
+
+    pattern = copy;
+    version = before;
+    return true;
+}
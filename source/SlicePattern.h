@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <juce_core/juce_core.h>
+#include "SliceTable.h"
+
+/** One step of a slice sequence. */
+struct SliceStep
+{
+    static constexpr int kRest = -1;
+    static constexpr int kMaxRepeats = 8;
+
+    int slice = 0;          // slice index, wrapped to the clip's table; kRest = silence
+    bool reverse = false;
+    int repeats = 1;        // stutter: the step is split into this many retriggers of the slice
+};
+
+/**
+ * Per-slot slice sequence: the loop is split into numSteps equal steps and
+ * each plays one slice of the active clip (reordered, repeated, reversed or
+ * stuttered) instead of the clip straight through. numSteps == 0 is off.
+ *
+ * Text form, as typed in the editor: an optional "b:" (beat grid, default)
+ * or "t:" (transients) prefix, then one word per step. Slices count from 1;
+ * "r" reverses, "x<n>" retriggers n times, "-" rests:
+ *
+ *     t: 1 1 3r 4x4 - 2
+ */
+struct SlicePattern
+{
+    static constexpr int kMaxSteps = 32;
+
+    SliceSource source = SliceSource::beats;
+    int numSteps = 0;
+    std::array<SliceStep, kMaxSteps> steps {};
+
+    bool isActive() const noexcept { return numSteps > 0; }
+
+    /** Parses the text form; words it can't read are skipped (empty text = off). */
+    static SlicePattern fromString(const juce::String& text);
+    juce::String toString() const;
+};
+
+/**
+ * The slots' slice patterns, editable from the message thread while the
+ * audio thread plays them, without locks or allocation.
+ *
+ * A pattern doesn't fit one atomic, so each slot's steps are packed four to a
+ * word behind a sequence counter (a seqlock): the writer makes it odd while
+ * it stores, and a reader keeps its previous copy if the counter was odd or
+ * moved during the read, picking the new one up on a later block.
+ */
+class SlicePatternTable
+{
+public:
+    explicit SlicePatternTable(int numSlots);
+
+    /** Message thread (the only writer). Out-of-range slots are ignored. */
+    void set(int slot, const SlicePattern& pattern) noexcept;
+
+    /** The slot's current pattern (any thread but the audio thread: waits out a concurrent set()). */
+    SlicePattern get(int slot) const noexcept;
+
+    /**
+     * Audio thread: if the slot's pattern changed since `version`, copies it
+     * into `pattern`, updates `version` and returns true.
+     */
+    bool readIfChanged(int slot, juce::uint32& version, SlicePattern& pattern) const noexcept;
+
+    /** Changes with every set() of the slot, so views can tell when to re-read it. */
+    juce::uint32 getVersion(int slot) const noexcept
+    {
+        return slot >= 0 && slot < numEntries ? entries[(size_t)slot].sequence.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    static constexpr int kStepsPerWord = 4;
+    static constexpr int kNumWords = SlicePattern::kMaxSteps / kStepsPerWord;
+
+    struct Entry
+    {
+        std::atomic<juce::uint32> sequence { 0 };     // even = stable
+        std::atomic<juce::uint32> header { 0 };       // numSteps | source << 8
+        std::array<std::atomic<juce::uint64>, kNumWords> words {};
+    };
+
+    static juce::uint16 packStep(const SliceStep& s) noexcept;
+    static SliceStep unpackStep(juce::uint16 bits) noexcept;
+    static void readEntry(const Entry& e, SlicePattern& pattern) noexcept;
+
+    std::unique_ptr<Entry[]> entries;
+    int numEntries = 0;
+};
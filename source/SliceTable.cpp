@@ -0,0 +1,34 @@
+#include <algorithm>
+#include "SliceTable.h"
+
+void SliceTable::setBeatGrid(int length, int numSlices)
+{
+    loopLength = juce::jmax(0, length);
+    numSlices = juce::jlimit(1, juce::jmin(kMaxSlices, juce::jmax(1, loopLength)), numSlices);
+
+    starts.resize(loopLength > 0 ? (size_t)numSlices : 0);
+    for (int i = 0; i < (int)starts.size(); ++i)
+        starts[(size_t)i] = (int)((juce::int64)i * loopLength / numSlices);
+}
+
+void SliceTable::setStarts(std::vector<int> newStarts, int length)
+{
+    loopLength = juce::jmax(0, length);
+    if (loopLength == 0)
+    {
+        starts.clear();
+        return;
+    }
+
+    newStarts.erase(std::remove_if(newStarts.begin(), newStarts.end(),
+        [this](int s) { return s < 0 || s >= loopLength; }), newStarts.end());
+    newStarts.push_back(0);
+
+    std::sort(newStarts.begin(), newStarts.end());
+    newStarts.erase(std::unique(newStarts.begin(), newStarts.end()), newStarts.end());
+
+    if ((int)newStarts.size() > kMaxSlices)
+        newStarts.resize((size_t)kMaxSlices);
+
+    starts = std::move(newStarts);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <juce_core/juce_core.h>
+
+/** Which of a clip's slice tables a pattern plays from. */
+enum class SliceSource : juce::uint8
+{
+    beats = 0,      // one slice per beat of the analysed grid
+    transients      // one slice per detected hit (falls back to beats when there are none)
+};
+
+/**
+ * Slice points of one clip, as loop positions (samples from the downbeat,
+ * ascending, the first at 0). Slice i runs to the next start, the last one
+ * to the end of the loop. Built off the audio thread when the clip loads;
+ * the audio thread only reads it.
+ */
+class SliceTable
+{
+public:
+    static constexpr int kMaxSlices = 64;
+
+    /** `numSlices` equal slices over `loopLength` samples. Doesn't allocate once reserve() was called. */
+    void setBeatGrid(int loopLength, int numSlices);
+
+    /** Slices at `starts` (loop positions, any order; duplicates and out-of-range ones dropped, 0 added). */
+    void setStarts(std::vector<int> starts, int loopLength);
+
+    void reserve() { starts.reserve((size_t)kMaxSlices); }
+    void clear() noexcept { starts.clear(); loopLength = 0; }
+
+    bool isEmpty() const noexcept { return starts.empty(); }
+    int getNumSlices() const noexcept { return (int)starts.size(); }
+    int getStart(int slice) const noexcept { return starts[(size_t)slice]; }
+
+    int getLength(int slice) const noexcept
+    {
+        return (slice + 1 < getNumSlices() ? starts[(size_t)slice + 1] : loopLength) - starts[(size_t)slice];
+    }
+
+private:
+    std::vector<int> starts;
+    int loopLength = 0;
+};
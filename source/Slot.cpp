@@ -1,50 +1,243 @@
 #include "Slot.h"
 
-void Slot::loadClip(const juce::File& file)
+// Set the shared clip bank pointer
+void Slot::setClipBank(const std::vector<DJamClip>* bank)
 {
-    clip = std::make_unique<DJamClip>();
-    clip->loadFromFile(file);
-    // No longer sets loop length  DJamClip is now read-only
+    _clips = bank;
 }
 
-void Slot::render(juce::AudioBuffer<float>& output,
-    int startSample, int numSamples,
-    const HostPhase& hp)
+// Schedule a clip to start at the next quantized boundary
+void Slot::armStart(int clipIndex)
 {
-    if (!clip || !clip->isLoaded())
-        return;
+    _slotState.armedStart = true;
+    _slotState.pendingClip = clipIndex;
+}
+
+// Commit the armed start (called at bar boundary)
+void Slot::applyArmedStart()
+{
+    if (_slotState.armedStart && _clips != nullptr)
+    {
+        const int clipIndex = _slotState.pendingClip;
 
-    const int totalSamples = totalSamplesAtHostPhase(hp.sampleRate, hp);
-    const double samplesPerBeat = (60.0 / hp.bpm) * hp.sampleRate;
+        if (clipIndex >= 0 && clipIndex < (int)_clips->size())
+        {
+            _slotState.activeClip = clipIndex;
+            _slotState.phaseSamples = 0;
+            barsLength = (*_clips)[(size_t)clipIndex].getLoopLengthBars();
+            _slotState.barsPlayed = 0;
+            _slotState.followClip = -1;
+        }
+    }
 
-    int startBeat = static_cast<int>(std::floor(playheadPositionBeats));
-    int beatCount = static_cast<int>(std::ceil((double)numSamples / samplesPerBeat));
+    _slotState.armedStart = false;
+    _slotState.pendingClip = -1;
+}
+
+void Slot::stopPlayback()
+{
+    _slotState.activeClip = -1;
+    _slotState.phaseSamples = 0;
+    _slotState.barsPlayed = 0;
+    _slotState.followClip = -1;
+}
 
-    clip->render(output, startSample, numSamples, startBeat, beatCount);
+void Slot::restore(int clipIndex, int phaseSamples, bool mute, bool solo) noexcept
+{
+    stopPlayback();
+    _slotState.armedStart = false;
+    _slotState.pendingClip = -1;
+    _slotState.mute = mute;
+    _slotState.solo = solo;
 
-    // Update playhead position
-    playheadPositionBeats += ((double)numSamples / samplesPerBeat);
-    while (playheadPositionBeats >= barsLength * hp.beatsPerBar)
-        playheadPositionBeats -= barsLength * hp.beatsPerBar;
+    if (_clips != nullptr && clipIndex >= 0 && clipIndex < (int)_clips->size())
+    {
+        _slotState.activeClip = clipIndex;
+        _slotState.phaseSamples = juce::jmax(0, phaseSamples);
+        barsLength = (*_clips)[(size_t)clipIndex].getLoopLengthBars();
+    }
 }
 
-void Slot::jumpTo(double hostPPQ)
+void Slot::jumpTo(double ppq)
 {
-    if (!clip || !clip->isLoaded())
+    if (getActiveClip() == nullptr || _slotState.samplesPerBeat <= 0.0)
+        return;
+
+    const double totalBeats = (double)barsLength * _slotState.beatsPerBar;
+    if (totalBeats <= 0.0 || !std::isfinite(ppq))
         return;
 
-    const double beatsPerBar = clip->getBeatsPerBar();
-    const double totalBeats = barsLength * beatsPerBar;
+    // Pre-roll positions are negative: wrap them into the loop too
+    double beats = std::fmod(ppq, totalBeats);
+    if (beats < 0.0)
+        beats += totalBeats;
+
+    _slotState.phaseSamples = (int)(beats * _slotState.samplesPerBeat);
+}
 
-    playheadPositionBeats = std::fmod(hostPPQ, totalBeats);
+void Slot::advanceBar() noexcept
+{
+    if (_slotState.activeClip >= 0)
+        ++_slotState.barsPlayed;
 }
 
-int Slot::totalSamplesAtHostPhase(double sampleRate, const HostPhase& hp) const
+void Slot::toggleMute()
 {
-    if (!clip || !clip->isLoaded())
-        return 0;
+    _slotState.mute = !_slotState.mute;
+}
+
+void Slot::setSolo(bool v)
+{
+    _slotState.solo = v;
+}
+
+bool Slot::isMuted() const noexcept { return _slotState.mute; }
+bool Slot::isSolo() const noexcept { return _slotState.solo; }
+bool Slot::isArmed() const noexcept { return _slotState.armedStart; }
+
+int Slot::getActiveClipIndex() const noexcept { return _slotState.activeClip; }
+int Slot::getPendingClipIndex() const noexcept { return _slotState.pendingClip; }
+
+const DJamClip* Slot::getActiveClip() const noexcept
+{
+    if (!_clips || _slotState.activeClip < 0 || _slotState.activeClip >= (int)_clips->size())
+        return nullptr;
+
+    return &(*_clips)[(size_t)_slotState.activeClip];
+}
+
+const DJamClip* Slot::getPendingClip() const noexcept
+{
+    if (!_clips || _slotState.pendingClip < 0 || _slotState.pendingClip >= (int)_clips->size())
+        return nullptr;
+
+    return &(*_clips)[(size_t)_slotState.pendingClip];
+}
+
+juce::String Slot::getActiveClipName() const noexcept
+{
+    const DJamClip* c = getActiveClip();
+    return c ? c->getName() : juce::String();
+}
+
+juce::String Slot::getPendingClipName() const noexcept
+{
+    const DJamClip* c = getPendingClip();
+    return c ? c->getName() : juce::String();
+}
+
+bool Slot::render(juce::AudioBuffer<float>& out,
+    int startSample,
+    int numSamples,
+    int destOffset,
+    const HostPhase& hp,
+    LevelAccumulator* meter)
+{
+    const DJamClip* clip = getActiveClip();
+    if (!clip || !clip->isLoaded() || numSamples <= 0) return false;
+
+    const double samplesPerBeat = hp.sampleRate * 60.0 / hp.bpm;
+    const int loopSamples = (int)(barsLength * hp.numerator * samplesPerBeat);
+    if (loopSamples <= 0)
+    {
+        // Zero-length loop (empty clip length or a broken tempo): nothing sensible to play
+        _slotState.phaseSamples = 0;
+        return false;
+    }
+
+    _slotState.samplesPerBeat = samplesPerBeat;
+    _slotState.beatsPerBar = hp.numerator;
+
+    // Render from the exact phase; the clip wraps inside the call if the block runs past its end
+    const float gain = normalise ? clip->getNormalisationGain() : 1.0f;
+
+    // The seam only covers the end of the file; off tempo the slot wraps somewhere else
+    const bool offTempo = std::abs(loopSamples - clip->getNumSamples()) > 1;
+    if (slicePattern.isActive() && loopSamples >= slicePattern.numSteps * SliceStep::kMaxRepeats)
+        renderSlices(*clip, out, startSample + destOffset, numSamples, loopSamples, meter, gain);
+    else if (loopCrossfade && offTempo && loopSamples >= 8)
+        renderWrapFaded(*clip, out, startSample + destOffset, numSamples, loopSamples,
+            juce::jlimit(1, loopSamples / 4, juce::roundToInt(hp.sampleRate * kWrapFadeSeconds)), meter, gain);
+    else
+        clip->render(out, startSample + destOffset, numSamples, _slotState.phaseSamples, meter, gain, loopCrossfade);
+
+    // Advance phase
+    _slotState.phaseSamples = (_slotState.phaseSamples + numSamples) % loopSamples;
+
+    return true;
+}
+
+// Floor of i * length / parts: step and retrigger boundaries, exact however the loop divides
+static int splitPoint(int i, int length, int parts) noexcept
+{
+    return (int)((juce::int64)i * length / parts);
+}
+
+// The part of [0, length) split `parts` ways that holds `pos`
+static int partAt(int pos, int length, int parts) noexcept
+{
+    int i = juce::jmin(parts - 1, (int)((juce::int64)pos * parts / length));
+    while (i + 1 < parts && splitPoint(i + 1, length, parts) <= pos)
+        ++i;
+    return i;
+}
+
+void Slot::renderWrapFaded(const DJamClip& clip, juce::AudioBuffer<float>& out,
+    int startSample, int numSamples, int loopSamples, int fade,
+    LevelAccumulator* meter, float gain) const noexcept
+{
+    // Fade in, hold, fade out over the loop: each part is one straight gain line
+    const auto gainAt = [=](int p) noexcept
+    {
+        return gain * (float)juce::jmin(fade, p, loopSamples - p) / (float)fade;
+    };
+
+    int pos = _slotState.phaseSamples % loopSamples;
+    for (int done = 0; done < numSamples;)
+    {
+        const int partEnd = pos < fade ? fade : (pos < loopSamples - fade ? loopSamples - fade : loopSamples);
+        const int n = juce::jmin(numSamples - done, partEnd - pos);
+
+        clip.renderRamped(out, startSample + done, n, pos, gainAt(pos), gainAt(pos + n), meter, loopCrossfade);
+
+        done += n;
+        pos += n;
+        if (pos == loopSamples)
+            pos = 0;
+    }
+}
+
+void Slot::renderSlices(const DJamClip& clip, juce::AudioBuffer<float>& out,
+    int startSample, int numSamples, int loopSamples,
+    LevelAccumulator* meter, float gain) const noexcept
+{
+    const auto& slices = clip.getSlices(slicePattern.source);
+    const int numSlices = slices.getNumSlices();
+    const int numSteps = slicePattern.numSteps;
+    if (numSlices == 0)
+        return;
+
+    // Segment by segment (a step, or one retrigger of it); none crosses the loop end
+    int pos = _slotState.phaseSamples % loopSamples;
+    for (int done = 0; done < numSamples;)
+    {
+        const int step = partAt(pos, loopSamples, numSteps);
+        const int stepStart = splitPoint(step, loopSamples, numSteps);
+        const int stepLength = splitPoint(step + 1, loopSamples, numSteps) - stepStart;
+        const auto& s = slicePattern.steps[(size_t)step];
+
+        const int sub = partAt(pos - stepStart, stepLength, s.repeats);
+        const int segmentStart = stepStart + splitPoint(sub, stepLength, s.repeats);
+        const int segmentLength = stepStart + splitPoint(sub + 1, stepLength, s.repeats) - segmentStart;
+        const int n = juce::jmin(numSamples - done, segmentStart + segmentLength - pos);
+
+        if (s.slice != SliceStep::kRest)
+            clip.renderSlice(out, startSample + done, n, slices, s.slice % numSlices,
+                pos - segmentStart, segmentLength, s.reverse, meter, gain, loopCrossfade);
 
-    const double beats = barsLength * hp.beatsPerBar;
-    const double seconds = (60.0 * beats) / hp.bpm;
-    return static_cast<int>(seconds * sampleRate);
+        done += n;
+        pos += n;
+        if (pos == loopSamples)
+            pos = 0;
+    }
 }
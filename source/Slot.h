@@ -1,41 +1,116 @@
 #pragma once
 
-#include <memory>
+#include <vector>
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 
 #include "DJamClip.h"
 #include "DJamHostSync.h"
+#include "SlicePattern.h"
+
+/** Playback state for one slot */
+struct SlotState
+{
+    int  activeClip = -1;
+    bool mute = false;
+    bool solo = false;
+    int  phaseSamples = 0;    // current position within clip
+    bool armedStart = false;
+    int  pendingClip = -1;    // clip to activate when armed
+    int  barsPlayed = 0;      // whole bars since activeClip started
+    int  followClip = -1;     // follow-action target resolved ahead of its boundary
+    double samplesPerBeat = 0.0; // tempo seen by the last render (for jumps)
+    int  beatsPerBar = 4;        // meter seen by the last render (for jumps)
+};
 
 /**
- * A single audio slot that holds one clip and renders it
- * during scheduled playback, quantized to bars/beats.
+ * A single performer slot that plays one clip at a time out of a
+ * shared clip bank, switching clips only at quantized boundaries.
  */
 class Slot
 {
 public:
     Slot() = default;
 
-    /** Loads an audio clip into this slot. */
-    void loadClip(const juce::File& file);
-
-    /** Renders the clip at the specified host phase into the output buffer. */
-    void render(juce::AudioBuffer<float>& output,
-        int startSample, int numSamples,
-        const HostPhase& hp);
+    void setClipBank(const std::vector<DJamClip>* bank);
 
     /** Sets the loop length of this slot (in bars). */
     void setBarsLength(int bars) noexcept { barsLength = bars; }
+    int getBarsLength() const noexcept { return barsLength; }
+
+    void armStart(int clipIndex);
+    void applyArmedStart();
+
+    void stopPlayback();
+    void jumpTo(double ppq);
+
+    /** Puts the slot straight into a saved state (state restore; audio thread). Invalid clips stop it. */
+    void restore(int clipIndex, int phaseSamples, bool mute, bool solo) noexcept;
+
+    /** Counts one completed bar for the active clip (call at bar boundaries). */
+    void advanceBar() noexcept;
+
+    /** Remembers the follow-action target so it is resolved once per loop. */
+    void setFollowClip(int clipIndex) noexcept { _slotState.followClip = clipIndex; }
+
+    void toggleMute();
+    void setSolo(bool v);
+
+    /** Applies each clip's load-time loudness normalisation when rendering. */
+    void setNormalise(bool shouldNormalise) noexcept { normalise = shouldNormalise; }
 
-    /** Called to sync this slot to a new playhead position. */
-    void jumpTo(double hostPPQ);
+    /**
+     * Plays each clip's precomputed loop-seam crossfade where it wraps. When
+     * the host tempo doesn't match the clip, the slot wraps away from the end
+     * of the file: it then fades out and back in over kWrapFadeSeconds there.
+     */
+    void setLoopCrossfade(bool shouldCrossfade) noexcept { loopCrossfade = shouldCrossfade; }
 
-    /** Returns the number of samples this clip will occupy at the given host phase. */
-    int totalSamplesAtHostPhase(double sampleRate, const HostPhase& hp) const;
+    /** Plays the active clip through a slice sequence instead of straight (an inactive pattern turns it off). */
+    void setSlicePattern(const SlicePattern& pattern) noexcept { slicePattern = pattern; }
+    const SlicePattern& getSlicePattern() const noexcept { return slicePattern; }
+
+    bool isMuted()   const noexcept;
+    bool isSolo()    const noexcept;
+    bool isArmed()   const noexcept;
+
+    int getActiveClipIndex()  const noexcept;
+    int getPendingClipIndex() const noexcept;
+    int getBarsPlayed()       const noexcept { return _slotState.barsPlayed; }
+    int getFollowClip()       const noexcept { return _slotState.followClip; }
+
+    const DJamClip* getActiveClip()  const noexcept;
+    const DJamClip* getPendingClip() const noexcept;
+
+    juce::String getActiveClipName()  const noexcept;
+    juce::String getPendingClipName() const noexcept;
+
+    bool render(juce::AudioBuffer<float>& out,
+        int startSample,
+        int numSamples,
+        int destOffset,
+        const HostPhase& hp,
+        LevelAccumulator* meter = nullptr);
+
+    const SlotState& state() const noexcept { return _slotState; }
 
 private:
-    std::unique_ptr<DJamClip> clip;
-    int barsLength = 1;
+    /** Slice-sequence rendering of [phase, phase + numSamples) of a loop of `loopSamples`. */
+    void renderSlices(const DJamClip& clip, juce::AudioBuffer<float>& out,
+        int startSample, int numSamples, int loopSamples,
+        LevelAccumulator* meter, float gain) const noexcept;
+
+    /** Straight rendering with a short fade out and in around the slot's own wrap at `loopSamples`. */
+    void renderWrapFaded(const DJamClip& clip, juce::AudioBuffer<float>& out,
+        int startSample, int numSamples, int loopSamples, int fade,
+        LevelAccumulator* meter, float gain) const noexcept;
 
-    double playheadPositionBeats = 0.0;
+    static constexpr double kWrapFadeSeconds = 0.003;
+
+    const std::vector<DJamClip>* _clips = nullptr;
+    SlotState _slotState;
+    int barsLength = 1;
+    bool normalise = true;
+    bool loopCrossfade = true;
+    SlicePattern slicePattern;
 };
@@ -0,0 +1,134 @@
+#include "SlotInsertChain.h"
+
+//===================== SlotFeedbackDelay =====================
+
+void SlotFeedbackDelay::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+
+    line.prepare(spec);
+    line.setMaximumDelayInSamples((int)(kMaxDelaySeconds * sampleRate));
+
+    mix.reset(sampleRate, 0.05);
+    delaySamples.reset(sampleRate, 0.2);
+    reset();
+}
+
+void SlotFeedbackDelay::reset() noexcept
+{
+    line.reset();
+    mix.setCurrentAndTargetValue(mix.getTargetValue());
+    delaySamples.setCurrentAndTargetValue(delaySamples.getTargetValue());
+}
+
+//===================== SlotInsertChain =====================
+
+void SlotInsertChain::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+
+    // Biquad coefficients before prepare, so the filters size their state once
+    *chain.get<eqIndex>().state = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(
+        sampleRate, kEqFrequency, kEqQ, 1.0f);
+
+    chain.prepare(spec);
+
+    auto& filter = chain.get<filterIndex>();
+    filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+    filter.setResonance(1.0f / juce::MathConstants<float>::sqrt2);
+
+    chain.get<driveIndex>().setRampDurationSeconds(0.05);
+    chain.get<shaperIndex>().functionToUse = [](float x) { return std::tanh(x); };
+    chain.get<delayIndex>().setFeedback(0.35f);
+
+    cutoff.reset(sampleRate, 0.05);
+    eqGainDb.reset(sampleRate, 0.05);
+
+    reset();
+}
+
+void SlotInsertChain::reset() noexcept
+{
+    chain.reset();
+
+    cutoff.setCurrentAndTargetValue(cutoff.getTargetValue() > 0.0f ? cutoff.getTargetValue() : 20000.0f);
+    eqGainDb.setCurrentAndTargetValue(eqGainDb.getTargetValue());
+
+    chain.get<filterIndex>().setCutoffFrequency(cutoff.getCurrentValue());
+    updateEQ(eqGainDb.getCurrentValue());
+}
+
+void SlotInsertChain::setParams(const Params& p) noexcept
+{
+    const float nyquistSafe = (float)(sampleRate * 0.45);
+    cutoff.setTargetValue(juce::jlimit(20.0f, nyquistSafe, p.cutoffHz));
+    eqGainDb.setTargetValue(p.eqGainDb);
+    chain.get<driveIndex>().setGainDecibels(p.driveDb);
+    chain.get<delayIndex>().setMix(p.delayMix);
+    chain.get<delayIndex>().setDelayMs(p.delayMs);
+
+    if (p.enabled && !active)
+        reset(); // start clean from the current targets, no sweep
+
+    active = p.enabled;
+
+    // Neutral stages drop out of the chain entirely
+    chain.setBypassed<filterIndex>(!cutoff.isSmoothing() && cutoff.getTargetValue() >= nyquistSafe);
+    chain.setBypassed<eqIndex>(!eqGainDb.isSmoothing() && std::abs(eqGainDb.getTargetValue()) < 0.01f);
+    chain.setBypassed<driveIndex>(p.driveDb <= 0.0f && !chain.get<driveIndex>().isSmoothing());
+    chain.setBypassed<shaperIndex>(p.driveDb <= 0.0f && !chain.get<driveIndex>().isSmoothing());
+
+    // The delay drops out only after its mix has faded to zero, and comes back with an empty line,
+    // so neither the wet tail cutting off nor the stale feedback reappearing can click
+    auto& delay = chain.get<delayIndex>();
+    const bool delayIdle = p.delayMix <= 0.0f && delay.isMixSilent();
+    if (!delayIdle && chain.isBypassed<delayIndex>())
+        delay.clearLine();
+    chain.setBypassed<delayIndex>(delayIdle);
+}
+
+void SlotInsertChain::updateEQ(float gainDb) noexcept
+{
+    // ArrayCoefficients fills the existing coefficient storage, no allocation
+    *chain.get<eqIndex>().state = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(
+        sampleRate, kEqFrequency, kEqQ, juce::Decibels::decibelsToGain(gainDb));
+}
+
+void SlotInsertChain::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    juce::dsp::AudioBlock<float> block(buffer);
+    block = block.getSubBlock((size_t)startSample, (size_t)numSamples);
+
+    const bool smoothing = cutoff.isSmoothing() || eqGainDb.isSmoothing();
+    if (!smoothing)
+    {
+        chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+        return;
+    }
+
+    // Step the smoothed filter settings in short sub-blocks
+    for (int pos = 0; pos < numSamples; pos += kSmoothingChunk)
+    {
+        const int n = juce::jmin(kSmoothingChunk, numSamples - pos);
+
+        if (cutoff.isSmoothing())
+            chain.get<filterIndex>().setCutoffFrequency(cutoff.skip(n));
+        if (eqGainDb.isSmoothing())
+            updateEQ(eqGainDb.skip(n));
+
+        auto sub = block.getSubBlock((size_t)pos, (size_t)n);
+        chain.process(juce::dsp::ProcessContextReplacing<float>(sub));
+    }
+}
+
+void SlotInsertChain::publishLoad(double blockSeconds) noexcept
+{
+    if (blockSeconds <= 0.0)
+        return;
+
+    const double used = juce::Time::highResolutionTicksToSeconds(blockTicks);
+    blockTicks = 0;
+
+    smoothedLoad += 0.1f * ((float)(used / blockSeconds) - smoothedLoad);
+    load.store(smoothedLoad, std::memory_order_relaxed);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * Feedback delay stage for the slot insert chain.
+ * Mix and delay time are smoothed per sample; the line is sized in prepare().
+ */
+class SlotFeedbackDelay
+{
+public:
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept;
+
+    void setMix(float newMix) noexcept { mix.setTargetValue(newMix); }
+    void setDelayMs(float ms) noexcept { delaySamples.setTargetValue((float)(ms * 0.001 * sampleRate)); }
+    void setFeedback(float fb) noexcept { feedback = fb; }
+
+    /** True once the mix has smoothed all the way down to zero (only then may the stage be bypassed). */
+    bool isMixSilent() const noexcept { return !mix.isSmoothing() && mix.getCurrentValue() <= 0.0f; }
+
+    /** Empties the line, keeping the smoothed mix and time where they are. */
+    void clearLine() noexcept { line.reset(); }
+
+    template <typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        if (context.isBypassed)
+            return;
+
+        auto block = context.getOutputBlock();
+        const size_t numChannels = juce::jmin(block.getNumChannels(), (size_t)kMaxChannels);
+        const size_t numSamples = block.getNumSamples();
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const float d = delaySamples.getNextValue();
+            const float m = mix.getNextValue();
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                float* io = block.getChannelPointer(ch);
+                const float dry = io[i];
+                const float wet = line.popSample((int)ch, d);
+                line.pushSample((int)ch, dry + wet * feedback);
+                io[i] = dry + m * wet;
+            }
+        }
+    }
+
+private:
+    static constexpr int kMaxChannels = 2;
+    static constexpr double kMaxDelaySeconds = 2.0;
+
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> line{ 1 };
+    juce::SmoothedValue<float> mix, delaySamples;
+    float feedback = 0.35f;
+    double sampleRate = 44100.0;
+};
+
+/**
+ * Per-slot insert chain: filter -> peak EQ -> drive -> delay.
+ *
+ * Built on juce::dsp::ProcessorChain and processed block-wise. Stages whose
+ * settings are neutral are bypassed, and the whole chain is skipped by the
+ * caller while isActive() is false, so an unused chain costs nothing.
+ * Filter cutoff and EQ gain are smoothed in short sub-blocks; drive and
+ * delay smooth internally.
+ */
+class SlotInsertChain
+{
+public:
+    /** Target settings, read from the slot's parameters once per block. */
+    struct Params
+    {
+        bool  enabled = false;
+        float cutoffHz = 20000.0f;
+        float eqGainDb = 0.0f;
+        float driveDb = 0.0f;
+        float delayMix = 0.0f;
+        float delayMs = 250.0f;
+    };
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept;
+
+    /** Applies new targets (audio thread). Enabling snaps smoothers to avoid sweeps. */
+    void setParams(const Params& p) noexcept;
+
+    bool isActive() const noexcept { return active; }
+
+    /** Processes `numSamples` of `buffer` in place, starting at `startSample`. */
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    /** Adds time spent in process() during the current block. */
+    void addTicks(juce::int64 ticks) noexcept { blockTicks += ticks; }
+
+    /**
+     * Publishes the share of the block's real-time budget this chain used
+     * (smoothed). Call once per processBlock.
+     */
+    void publishLoad(double blockSeconds) noexcept;
+
+    /** Last published CPU load as a fraction of the block budget (any thread). */
+    float getLoad() const noexcept { return load.load(std::memory_order_relaxed); }
+
+private:
+    enum { filterIndex, eqIndex, driveIndex, shaperIndex, delayIndex };
+
+    using PeakEQ = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
+                                                  juce::dsp::IIR::Coefficients<float>>;
+
+    juce::dsp::ProcessorChain<juce::dsp::StateVariableTPTFilter<float>,
+                              PeakEQ,
+                              juce::dsp::Gain<float>,
+                              juce::dsp::WaveShaper<float>,
+                              SlotFeedbackDelay> chain;
+
+    void updateEQ(float gainDb) noexcept;
+
+    static constexpr int kSmoothingChunk = 32;
+    static constexpr float kEqFrequency = 1000.0f;
+    static constexpr float kEqQ = 0.9f;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> cutoff;
+    juce::SmoothedValue<float> eqGainDb;
+    double sampleRate = 44100.0;
+    bool active = false;
+
+    juce::int64 blockTicks = 0;
+    float smoothedLoad = 0.0f;
+    std::atomic<float> load{ 0.0f };
+};
@@ -0,0 +1,54 @@
+#include "SlotList.h"
+
+SlotList::SlotList(DJAM0AudioProcessor& p)
+    : processor(p)
+{
+    list.setRowHeight(kRowHeight);
+    list.setMultipleSelectionEnabled(false);
+    list.setColour(juce::ListBox::backgroundColourId, juce::Colours::transparentBlack);
+    list.getViewport()->setScrollBarsShown(true, false);
+    addAndMakeVisible(list);
+}
+
+juce::Range<int> SlotList::getVisibleSlots() const
+{
+    const auto* viewport = list.getViewport();
+    const int top = viewport->getViewPositionY();
+    const int first = top / kRowHeight;
+    const int last = (top + juce::jmax(1, viewport->getViewHeight()) - 1) / kRowHeight;
+
+    return juce::Range<int>(first, last + 1).getIntersectionWith({ 0, DJAM0AudioProcessor::getNumSlots() });
+}
+
+void SlotList::refresh(const EngineSnapshot& snapshot)
+{
+    const auto visible = getVisibleSlots();
+
+    for (int s = visible.getStart(); s < visible.getEnd(); ++s)
+        if (auto* row = dynamic_cast<SlotRow*>(list.getComponentForRowNumber(s)); row != nullptr && row->getSlot() == s)
+            row->refresh(snapshot.slots[(size_t)s]);
+}
+
+juce::Component* SlotList::refreshComponentForRow(int row, bool, juce::Component* existing)
+{
+    if (row < 0 || row >= DJAM0AudioProcessor::getNumSlots())
+    {
+        delete existing;
+        return nullptr;
+    }
+
+    // Recycle the row that scrolled away; only a row without one builds a new strip
+    if (auto* slotRow = dynamic_cast<SlotRow*>(existing))
+    {
+        slotRow->setSlot(row);
+        return slotRow;
+    }
+
+    delete existing;
+    return new SlotRow(processor, row);
+}
+
+void SlotList::resized()
+{
+    list.setBounds(getLocalBounds());
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "PluginProcessor.h"
+#include "SlotRow.h"
+
+/**
+ * Scrolling list of slot rows. Only the rows in view exist: the ListBox
+ * hands rows that scroll out back to refreshComponentForRow(), which rebinds
+ * them to the slots scrolling in. Opening the editor and refreshing it
+ * therefore cost the same for 8 slots or 256.
+ */
+class SlotList : public juce::Component,
+                 private juce::ListBoxModel
+{
+public:
+    static constexpr int kRowHeight = 36;
+
+    explicit SlotList(DJAM0AudioProcessor& processor);
+
+    /** Slots with a row on screen; the editor only captures these. */
+    juce::Range<int> getVisibleSlots() const;
+
+    /** Hands each visible row its slice of `snapshot` (editor frame callback). */
+    void refresh(const EngineSnapshot& snapshot);
+
+    void resized() override;
+
+private:
+    // ListBoxModel
+    int getNumRows() override { return DJAM0AudioProcessor::getNumSlots(); }
+    void paintListBoxItem(int, juce::Graphics&, int, int, bool) override {}
+    juce::Component* refreshComponentForRow(int row, bool selected, juce::Component* existing) override;
+
+    DJAM0AudioProcessor& processor;
+    juce::ListBox list{ "Slots", this };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SlotList)
+};
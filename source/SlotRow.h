@@ -1,33 +1,55 @@
 #pragma once
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include "LevelMeter.h"
+#include "WaveformView.h"
 
-class SlotRow : public juce::Component,
-    public juce::Value::Listener
+/**
+ * One slot's strip: clip, bank, mute / solo / record, meter and waveform.
+ * Rows are recycled by SlotList as the view scrolls, so a row is bound to a
+ * slot with setSlot() rather than for its lifetime.
+ */
+class SlotRow : public juce::Component
 {
 public:
     SlotRow(DJAM0AudioProcessor& proc, int slotIndex);
-    ~SlotRow() override;
+
+    /** Rebinds the row (parameter attachments, labels, meter) to another slot. */
+    void setSlot(int slotIndex);
+    int getSlot() const noexcept { return slot; }
 
     void resized() override;
 
+    /**
+     * Called once per editor frame with this slot's fresh snapshot.
+     * Labels are only touched when the snapshot differs from the last one
+     * drawn; the meter and playhead repaint only when they visibly move.
+     */
+    void refresh(const SlotSnapshot& snapshot);
+
 private:
-    void valueChanged(juce::Value& v) override; // from Value::Listener
-    void updateClipLoopInfoText();
+    void updateLabels(const SlotSnapshot& snapshot);
+    static void setTextIfChanged(juce::Label& label, const juce::String& text);
 
     DJAM0AudioProcessor& processor;
-    int slot = 0;
+    int slot = -1;
 
     juce::Label titleLabel, clipNameLabel, clipLoopInfoLabel;
-    juce::Slider clipIndexSlider;
+    juce::Slider clipIndexSlider, bankSlider;
     juce::ToggleButton muteButton, soloButton;
+    juce::TextButton recButton{ "R" };
+    juce::TextEditor slicesEditor;    // slice pattern, text form (see SlicePattern)
+    LevelMeter meter;
+    WaveformView waveform;
+
+    SlotSnapshot shown;           // what the labels currently show
+    bool hasShown = false;
+    juce::uint32 shownSliceVersion = 0;
+
+    void commitSlicePattern();
+    void showSlicePattern();
 
     // Bindings
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> clipAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> clipAttachment, bankAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> muteAttachment, soloAttachment;
-
-    // Values for binding/combining
-    juce::Value clipLenBarsValue;     // refers to paramId_slotClipLenBars(slot)
-    juce::Value clipSamplesValue;     // refers to paramId_slotClipSamplesAt(slot)
-    juce::Value clipLoopInfoValue;    // combined -> label refers to this
 };
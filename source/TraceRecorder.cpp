@@ -0,0 +1,206 @@
+#include "TraceRecorder.h"
+
+//===================== Writer thread =====================
+
+class TraceRecorder::Writer : public juce::Thread
+{
+public:
+    explicit Writer(TraceRecorder& t) : juce::Thread("D-Jam trace writer"), owner(t) {}
+
+    void run() override
+    {
+        owner.setThreadName("trace writer");
+
+        while (!threadShouldExit())
+        {
+            owner.drain();
+            wait(50);
+        }
+    }
+
+private:
+    TraceRecorder& owner;
+};
+
+//===================== TraceRecorder =====================
+
+TraceRecorder& TraceRecorder::get()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::TraceRecorder()
+    : ring(new Event[kCapacity])
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    stop();
+}
+
+int TraceRecorder::currentThreadIndex() noexcept
+{
+    static std::atomic<int> nextIndex{ 0 };
+    thread_local const int index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void TraceRecorder::record(Phase phase, const char* name, juce::int64 arg) noexcept
+{
+    if (!recording.load(std::memory_order_relaxed))
+        return;
+
+    const auto index = head.fetch_add(1, std::memory_order_relaxed);
+    auto& e = ring[(size_t)(index & (kCapacity - 1))];
+
+    // Unpublished while the fields change, so a drain copying them can tell
+    e.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    e.name = name;
+    e.ticks = juce::Time::getHighResolutionTicks();
+    e.arg = arg;
+    e.thread = currentThreadIndex();
+    e.phase = phase;
+    e.sequence.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::setThreadName(const char* name) noexcept
+{
+    // Cheap enough to call every block: only a new name is recorded
+    const int index = currentThreadIndex();
+    if (index < kMaxThreads && threadNames[(size_t)index].exchange(name, std::memory_order_relaxed) == name)
+        return;
+
+    record(Phase::threadName, name);
+}
+
+bool TraceRecorder::start(const juce::File& file)
+{
+    stop();
+
+    const juce::ScopedLock sl(writerLock);
+
+    file.deleteFile();
+    out = std::make_unique<juce::FileOutputStream>(file);
+    if (out->failedToOpen())
+    {
+        out.reset();
+        return false;
+    }
+
+    out->writeText("{\"traceEvents\":[\n", false, false, nullptr);
+    firstEvent = true;
+    startTicks = juce::Time::getHighResolutionTicks();
+    tail = head.load(std::memory_order_acquire);
+    dropped.store(0, std::memory_order_relaxed);
+
+    // Threads named before the trace started
+    for (int i = 0; i < kMaxThreads; ++i)
+        if (auto* name = threadNames[(size_t)i].load(std::memory_order_relaxed))
+            writeEvent(name, Phase::threadName, startTicks, i, 0);
+
+    recording.store(true, std::memory_order_release);
+
+    writer = std::make_unique<Writer>(*this);
+    writer->startThread(juce::Thread::Priority::low);
+    return true;
+}
+
+void TraceRecorder::stop()
+{
+    if (writer != nullptr)
+    {
+        recording.store(false, std::memory_order_release);
+        writer->stopThread(2000);
+        writer.reset();
+    }
+
+    const juce::ScopedLock sl(writerLock);
+    if (out == nullptr)
+        return;
+
+    drain();
+    out->writeText("\n],\"displayTimeUnit\":\"ms\"}\n", false, false, nullptr);
+    out->flush();
+    out.reset();
+}
+
+void TraceRecorder::drain()
+{
+    const juce::ScopedLock sl(writerLock);
+    if (out == nullptr)
+        return;
+
+    const auto end = head.load(std::memory_order_acquire);
+
+    while (tail < end)
+    {
+        // Lapped by the producers: everything older than one ring is gone
+        if (end - tail > (juce::uint64)kCapacity)
+        {
+            dropped.fetch_add(end - kCapacity - tail, std::memory_order_relaxed);
+            tail = end - kCapacity;
+        }
+
+        auto& e = ring[(size_t)(tail & (kCapacity - 1))];
+        const auto seq = e.sequence.load(std::memory_order_acquire);
+
+        if (seq < tail + 1)
+            break; // claimed but not yet published; next drain picks it up
+
+        if (seq > tail + 1)
+        {
+            // Overwritten while we were getting here
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            ++tail;
+            continue;
+        }
+
+        // Copy, then check nothing overwrote the event meanwhile (a seqlock read)
+        const auto name = e.name;
+        const auto phase = e.phase;
+        const auto ticks = e.ticks;
+        const auto thread = e.thread;
+        const auto arg = e.arg;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (e.sequence.load(std::memory_order_relaxed) != seq)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            ++tail;
+            continue;
+        }
+
+        writeEvent(name, phase, ticks, thread, arg);
+        ++tail;
+    }
+}
+
+void TraceRecorder::writeEvent(const char* name, Phase phase, juce::int64 ticks, int thread, juce::int64 arg)
+{
+    const double us = juce::Time::highResolutionTicksToSeconds(ticks - startTicks) * 1.0e6;
+
+    juce::String json;
+    json << (firstEvent ? "" : ",\n") << "{\"pid\":1,\"tid\":" << thread
+         << ",\"ph\":\"" << juce::String::charToString((juce::juce_wchar)(char)phase) << "\"";
+
+    if (phase == Phase::threadName)
+    {
+        json << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << name << "\"}}";
+    }
+    else
+    {
+        json << ",\"name\":\"" << name << "\",\"ts\":" << juce::String(juce::jmax(0.0, us), 3);
+        if (phase == Phase::instant)
+            json << ",\"s\":\"t\"";
+        if (arg != 0)
+            json << ",\"args\":{\"value\":" << arg << "}";
+        json << "}";
+    }
+
+    out->writeText(json, false, false, nullptr);
+    firstEvent = false;
+}
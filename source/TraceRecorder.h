@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <juce_core/juce_core.h>
+
+/**
+ * Timestamped event trace for the audio, loader and UI threads, exported as
+ * Chrome / Perfetto trace JSON (load it in ui.perfetto.dev or chrome://tracing).
+ *
+ * Producers write into a preallocated ring with one atomic fetch-add and a
+ * release store; nothing allocates, locks or makes a syscall, so it is safe
+ * in processBlock. A background thread drains the ring to disk while tracing
+ * is running. When tracing is off each event costs one relaxed load.
+ *
+ * Event names must be string literals (only the pointer is stored).
+ */
+class TraceRecorder
+{
+public:
+    enum class Phase : char { begin = 'B', end = 'E', instant = 'i', threadName = 'M' };
+
+    static TraceRecorder& get();
+
+    ~TraceRecorder();
+
+    /** Message thread: starts draining to `file` (overwritten). */
+    bool start(const juce::File& file);
+
+    /** Message thread: drains what is left, closes the JSON and stops. */
+    void stop();
+
+    bool isRecording() const noexcept { return recording.load(std::memory_order_relaxed); }
+
+    /** Any thread. `arg` shows up as args.value in the trace. */
+    void record(Phase phase, const char* name, juce::int64 arg = 0) noexcept;
+
+    /** Labels the calling thread in the trace; remembered for traces started later. */
+    void setThreadName(const char* name) noexcept;
+
+    /** Events lost because the writer fell a full ring behind. */
+    juce::uint64 getDroppedCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    TraceRecorder();
+
+    static constexpr int kCapacity = 1 << 16;   // power of two
+    static constexpr int kMaxThreads = 64;
+
+    struct Event
+    {
+        std::atomic<juce::uint64> sequence{ 0 }; // index + 1 once published, 0 while written
+        const char* name = nullptr;
+        juce::int64 ticks = 0;
+        juce::int64 arg = 0;
+        int thread = 0;
+        Phase phase = Phase::instant;
+    };
+
+    static int currentThreadIndex() noexcept;
+    void drain();
+    void writeEvent(const char* name, Phase phase, juce::int64 ticks, int thread, juce::int64 arg);
+
+    class Writer;
+
+    std::unique_ptr<Event[]> ring;
+    std::atomic<juce::uint64> head{ 0 };
+    juce::uint64 tail = 0;                                  // writer thread only
+    std::atomic<juce::uint64> dropped{ 0 };
+    std::atomic<bool> recording{ false };
+
+    std::array<std::atomic<const char*>, kMaxThreads> threadNames{};
+
+    juce::CriticalSection writerLock;                       // start/stop vs. the writer thread
+    std::unique_ptr<juce::FileOutputStream> out;
+    std::unique_ptr<Writer> writer;
+    juce::int64 startTicks = 0;
+    bool firstEvent = true;
+};
+
+/** RAII begin/end pair on the calling thread. */
+struct ScopedTrace
+{
+    explicit ScopedTrace(const char* eventName, juce::int64 arg = 0) noexcept : name(eventName)
+    {
+        TraceRecorder::get().record(TraceRecorder::Phase::begin, name, arg);
+    }
+
+    ~ScopedTrace() noexcept { TraceRecorder::get().record(TraceRecorder::Phase::end, name); }
+
+    const char* name;
+};
+
+#define DJAM_TRACE_JOIN_(a, b) a##b
+#define DJAM_TRACE_JOIN(a, b) DJAM_TRACE_JOIN_(a, b)
+
+/** Traces the enclosing scope as one slice. */
+#define DJAM_TRACE_SCOPE(name, ...) const ScopedTrace DJAM_TRACE_JOIN(djamTrace, __LINE__)(name, ##__VA_ARGS__);
+
+/** A single point in time on the calling thread. */
+#define DJAM_TRACE_INSTANT(name, arg) TraceRecorder::get().record(TraceRecorder::Phase::instant, name, arg);
@@ -0,0 +1,156 @@
+#include "WaveformOverview.h"
+
+static juce::int8 toBinValue(float v) noexcept
+{
+    return (juce::int8)juce::roundToInt(juce::jlimit(-1.0f, 1.0f, v) * 127.0f);
+}
+
+void WaveformOverview::build(const juce::AudioBuffer<float>& audio)
+{
+    levels.clear();
+    numSamples = audio.getNumSamples();
+
+    if (numSamples <= 0 || audio.getNumChannels() <= 0)
+        return;
+
+    // Level 0 straight from the audio
+    const int numBins = (int)((numSamples + kBaseBucket - 1) / kBaseBucket);
+    std::vector<Bin> base((size_t)numBins);
+
+    for (int b = 0; b < numBins; ++b)
+    {
+        const int start = b * kBaseBucket;
+        const int n = juce::jmin(kBaseBucket, (int)numSamples - start);
+
+        auto range = juce::FloatVectorOperations::findMinAndMax(audio.getReadPointer(0, start), n);
+        for (int ch = 1; ch < audio.getNumChannels(); ++ch)
+            range = range.getUnionWith(juce::FloatVectorOperations::findMinAndMax(audio.getReadPointer(ch, start), n));
+
+        base[(size_t)b] = { toBinValue(range.getStart()), toBinValue(range.getEnd()) };
+    }
+
+    levels.push_back(std::move(base));
+
+    // Each coarser level folds pairs of the one below
+    while (levels.back().size() > 1)
+    {
+        const auto& below = levels.back();
+        std::vector<Bin> next((below.size() + 1) / 2);
+
+        for (size_t i = 0; i < next.size(); ++i)
+        {
+            const Bin a = below[i * 2];
+            const Bin b = (i * 2 + 1 < below.size()) ? below[i * 2 + 1] : a;
+            next[i] = { juce::jmin(a.min, b.min), juce::jmax(a.max, b.max) };
+        }
+
+        levels.push_back(std::move(next));
+    }
+}
+
+void WaveformOverview::getColumns(juce::int64 startSample, juce::int64 endSample,
+    int numPixels, float* mins, float* maxs) const noexcept
+{
+    if (numPixels <= 0)
+        return;
+
+    if (levels.empty() || endSample <= startSample)
+    {
+        std::fill(mins, mins + numPixels, 0.0f);
+        std::fill(maxs, maxs + numPixels, 0.0f);
+        return;
+    }
+
+    // Coarsest level whose bins are still no wider than a pixel
+    const double samplesPerPixel = (double)(endSample - startSample) / numPixels;
+    int level = 0;
+    while (level + 1 < (int)levels.size() && (double)(kBaseBucket << (level + 1)) <= samplesPerPixel)
+        ++level;
+
+    const auto& bins = levels[(size_t)level];
+    const juce::int64 bucket = (juce::int64)kBaseBucket << level;
+    const juce::int64 lastBin = (juce::int64)bins.size() - 1;
+
+    for (int p = 0; p < numPixels; ++p)
+    {
+        const juce::int64 s0 = startSample + (juce::int64)(samplesPerPixel * p);
+        const juce::int64 s1 = startSample + (juce::int64)(samplesPerPixel * (p + 1));
+
+        juce::int64 b0 = juce::jlimit((juce::int64)0, lastBin, s0 / bucket);
+        const juce::int64 b1 = juce::jlimit(b0, lastBin, (s1 - 1) / bucket);
+
+        if (s0 >= numSamples || s0 < 0)
+        {
+            mins[p] = maxs[p] = 0.0f;
+            continue;
+        }
+
+        juce::int8 mn = bins[(size_t)b0].min, mx = bins[(size_t)b0].max;
+        for (++b0; b0 <= b1; ++b0)
+        {
+            mn = juce::jmin(mn, bins[(size_t)b0].min);
+            mx = juce::jmax(mx, bins[(size_t)b0].max);
+        }
+
+        mins[p] = mn / 127.0f;
+        maxs[p] = mx / 127.0f;
+    }
+}
+
+bool WaveformOverview::save(const juce::File& file) const
+{
+    if (levels.empty() || !file.getParentDirectory().createDirectory())
+        return false;
+
+    juce::FileOutputStream out(file);
+    if (out.failedToOpen())
+        return false;
+
+    out.setPosition(0);
+    out.truncate();
+
+    out.writeInt((int)kMagic);
+    out.writeInt((int)kVersion);
+    out.writeInt64(numSamples);
+    out.writeInt((int)levels.size());
+
+    for (const auto& level : levels)
+    {
+        out.writeInt((int)level.size());
+        out.write(level.data(), level.size() * sizeof(Bin));
+    }
+
+    return out.getStatus().wasOk();
+}
+
+bool WaveformOverview::load(const juce::File& file, juce::int64 expectedSamples)
+{
+    juce::FileInputStream in(file);
+    if (in.failedToOpen())
+        return false;
+
+    if ((juce::uint32)in.readInt() != kMagic || (juce::uint32)in.readInt() != kVersion)
+        return false;
+
+    const auto storedSamples = in.readInt64();
+    const int numLevels = in.readInt();
+    if (storedSamples != expectedSamples || numLevels <= 0 || numLevels > 64)
+        return false;
+
+    std::vector<std::vector<Bin>> loaded((size_t)numLevels);
+    for (auto& level : loaded)
+    {
+        const int size = in.readInt();
+        if (size <= 0)
+            return false;
+
+        level.resize((size_t)size);
+        const auto bytes = (int)(level.size() * sizeof(Bin));
+        if (in.read(level.data(), bytes) != bytes)
+            return false;
+    }
+
+    levels = std::move(loaded);
+    numSamples = storedSamples;
+    return true;
+}
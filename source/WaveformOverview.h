@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * Multi-resolution min/max pyramid of a clip for drawing.
+ *
+ * Level 0 holds one min/max pair per kBaseBucket samples (all channels
+ * folded together); each further level halves the resolution. Drawing picks
+ * the coarsest level that still has at least one bin per pixel, so a repaint
+ * touches O(pixels) bins at any zoom. Bins are stored as signed bytes, which
+ * is plenty for a row a few dozen pixels tall and keeps the cache files small.
+ */
+class WaveformOverview
+{
+public:
+    static constexpr int kBaseBucket = 64;
+
+    struct Bin { juce::int8 min = 0, max = 0; };
+
+    /** Builds all levels from `audio`. */
+    void build(const juce::AudioBuffer<float>& audio);
+
+    bool isEmpty() const noexcept { return levels.empty(); }
+    juce::int64 getNumSamples() const noexcept { return numSamples; }
+    int getNumLevels() const noexcept { return (int)levels.size(); }
+
+    /**
+     * Fills `mins`/`maxs` (numPixels each, range -1..1) for samples
+     * [startSample, endSample) spread over numPixels columns.
+     */
+    void getColumns(juce::int64 startSample, juce::int64 endSample,
+        int numPixels, float* mins, float* maxs) const noexcept;
+
+    /** Cache I/O. load() rejects files that don't match `expectedSamples`. */
+    bool save(const juce::File& file) const;
+    bool load(const juce::File& file, juce::int64 expectedSamples);
+
+private:
+    static constexpr juce::uint32 kMagic = 0x564f4a44; // "DJOV"
+    static constexpr juce::uint32 kVersion = 1;
+
+    std::vector<std::vector<Bin>> levels;
+    juce::int64 numSamples = 0;
+};
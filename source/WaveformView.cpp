@@ -0,0 +1,119 @@
+#include "WaveformView.h"
+
+// Zoom in no further than this many samples across the view
+static constexpr juce::int64 kMinViewSamples = 256;
+
+void WaveformView::setOverview(std::shared_ptr<const WaveformOverview> newOverview)
+{
+    if (newOverview == overview)
+        return;
+
+    overview = std::move(newOverview);
+    viewStart = 0;
+    viewEnd = overview != nullptr ? overview->getNumSamples() : 0;
+    rebuildImage();
+}
+
+void WaveformView::setPlayhead(juce::int64 samplePosition)
+{
+    playhead = samplePosition;
+
+    const int x = sampleToX(samplePosition);
+    if (x == drawnPlayheadX)
+        return;
+
+    // Only the strips under the old and new line need repainting
+    if (drawnPlayheadX >= 0) repaint(drawnPlayheadX - 1, 0, 3, getHeight());
+    if (x >= 0)              repaint(x - 1, 0, 3, getHeight());
+}
+
+int WaveformView::sampleToX(juce::int64 sample) const noexcept
+{
+    if (sample < viewStart || sample >= viewEnd || viewEnd <= viewStart)
+        return -1;
+
+    return (int)((double)(sample - viewStart) * getWidth() / (double)(viewEnd - viewStart));
+}
+
+void WaveformView::resized()
+{
+    rebuildImage();
+}
+
+void WaveformView::rebuildImage()
+{
+    const int w = getWidth(), h = getHeight();
+    if (w <= 0 || h <= 0)
+    {
+        image = {};
+        return;
+    }
+
+    image = juce::Image(juce::Image::ARGB, w, h, true);
+
+    if (overview != nullptr && !overview->isEmpty())
+    {
+        mins.resize((size_t)w);
+        maxs.resize((size_t)w);
+        overview->getColumns(viewStart, viewEnd, w, mins.data(), maxs.data());
+
+        juce::Graphics g(image);
+        g.setColour(juce::Colours::lightblue.withAlpha(0.8f));
+
+        const float mid = h * 0.5f;
+        for (int x = 0; x < w; ++x)
+        {
+            const float top = mid - maxs[(size_t)x] * mid;
+            const float bottom = mid - mins[(size_t)x] * mid;
+            g.fillRect((float)x, top, 1.0f, juce::jmax(1.0f, bottom - top));
+        }
+    }
+
+    repaint();
+}
+
+void WaveformView::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black.withAlpha(0.4f));
+
+    if (image.isValid())
+        g.drawImageAt(image, 0, 0);
+
+    drawnPlayheadX = sampleToX(playhead);
+    if (drawnPlayheadX >= 0)
+    {
+        g.setColour(juce::Colours::white);
+        g.fillRect(drawnPlayheadX, 0, 1, getHeight());
+    }
+}
+
+void WaveformView::mouseWheelMove(const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel)
+{
+    if (overview == nullptr || getWidth() <= 0)
+        return;
+
+    const juce::int64 total = overview->getNumSamples();
+    const double span = (double)(viewEnd - viewStart);
+    const double anchor = viewStart + span * e.position.x / getWidth();
+
+    const double newSpan = juce::jlimit((double)juce::jmin(kMinViewSamples, total), (double)total,
+        span * std::pow(0.5, wheel.deltaY * 4.0));
+
+    // Keep the sample under the pointer where it is
+    const double ratio = (anchor - viewStart) / span;
+    const double start = juce::jlimit(0.0, (double)total - newSpan, anchor - newSpan * ratio);
+
+    viewStart = (juce::int64)start;
+    viewEnd = viewStart + (juce::int64)newSpan;
+    rebuildImage();
+}
+
+void WaveformView::mouseDoubleClick(const juce::MouseEvent&)
+{
+    if (overview == nullptr)
+        return;
+
+    viewStart = 0;
+    viewEnd = overview->getNumSamples();
+    rebuildImage();
+}
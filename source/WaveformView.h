@@ -0,0 +1,41 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "WaveformOverview.h"
+
+/**
+ * Draws a clip's WaveformOverview with a playhead line.
+ *
+ * The waveform is rendered into a cached image only when the clip, the zoom
+ * or the size changes; playhead updates just repaint the one-pixel strips
+ * that moved. Mouse wheel zooms around the pointer, double-click resets.
+ */
+class WaveformView : public juce::Component
+{
+public:
+    WaveformView() = default;
+
+    /** Shows `overview` (null clears the view) and resets the zoom. */
+    void setOverview(std::shared_ptr<const WaveformOverview> overview);
+
+    /** Playhead in clip samples; negative hides it. */
+    void setPlayhead(juce::int64 samplePosition);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void mouseWheelMove(const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel) override;
+    void mouseDoubleClick(const juce::MouseEvent& e) override;
+
+private:
+    void rebuildImage();
+    int sampleToX(juce::int64 sample) const noexcept;
+
+    std::shared_ptr<const WaveformOverview> overview;
+    juce::Image image;
+    std::vector<float> mins, maxs;
+
+    juce::int64 viewStart = 0, viewEnd = 0;
+    juce::int64 playhead = -1;
+    int drawnPlayheadX = -1;
+};
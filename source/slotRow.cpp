@@ -2,11 +2,8 @@
 #include "PluginProcessor.h"
 
 SlotRow::SlotRow(DJAM0AudioProcessor& proc, int slotIndex)
-    : processor(proc), slot(slotIndex)
+    : processor(proc)
 {
-    auto& apvts = processor.getAPVTS();
-    auto& vt = apvts.state;
-
     // Title
     titleLabel.setJustificationType(juce::Justification::centredLeft);
     addAndMakeVisible(titleLabel);
@@ -16,9 +13,8 @@ SlotRow::SlotRow(DJAM0AudioProcessor& proc, int slotIndex)
     clipNameLabel.setEditable(false, false, false);
     addAndMakeVisible(clipNameLabel);
 
-    // Loop info label (bind to our *combined* Value)
+    // Loop info label (filled by refresh())
     clipLoopInfoLabel.setJustificationType(juce::Justification::centredLeft);
-    clipLoopInfoLabel.getTextValue().referTo(clipLoopInfoValue);
     addAndMakeVisible(clipLoopInfoLabel);
 
     // Slider & buttons
@@ -26,77 +22,168 @@ SlotRow::SlotRow(DJAM0AudioProcessor& proc, int slotIndex)
     clipIndexSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 60, 20);
     addAndMakeVisible(clipIndexSlider);
 
+    // Bank the clip index picks from; a switch loads in the background and lands on a bar
+    bankSlider.setSliderStyle(juce::Slider::IncDecButtons);
+    bankSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 40, 20);
+    bankSlider.setTooltip("Bank");
+    addAndMakeVisible(bankSlider);
+
     muteButton.setTooltip("Mute");
     soloButton.setTooltip("Solo");
     addAndMakeVisible(muteButton);
     addAndMakeVisible(soloButton);
 
-    // Attach parameters
+    // Live looping: arm records the input from the next bar; click again to cancel
+    recButton.setTooltip("Record input into this slot");
+    recButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::red);
+    recButton.onClick = [this]
+        {
+            if (processor.getSlotRecordState(slot) == LiveLooper::State::idle)
+                recButton.setToggleState(processor.armSlotRecording(slot), juce::dontSendNotification);
+            else
+            {
+                processor.cancelSlotRecording(slot);
+                recButton.setToggleState(false, juce::dontSendNotification);
+            }
+        };
+    addAndMakeVisible(recButton);
+
+    // Slice sequence: applied on return or when focus leaves, then shown as understood
+    slicesEditor.setTextToShowWhenEmpty("slices", juce::Colours::grey);
+    slicesEditor.setTooltip("Slice pattern: 1 2 3r 4x4 - (b: beat grid, t: transients)");
+    slicesEditor.onReturnKey = [this] { commitSlicePattern(); };
+    slicesEditor.onFocusLost = [this] { commitSlicePattern(); };
+    slicesEditor.onEscapeKey = [this] { showSlicePattern(); };
+    addAndMakeVisible(slicesEditor);
+
+    addAndMakeVisible(meter);
+    addAndMakeVisible(waveform);
+
+    setSlot(slotIndex);
+}
+
+void SlotRow::setSlot(int slotIndex)
+{
+    if (slotIndex == slot)
+        return;
+
+    slot = slotIndex;
+    auto& apvts = processor.getAPVTS();
+
+    // Old attachments go first, so the controls never drive the previous slot's parameters
+    clipAttachment.reset();
+    bankAttachment.reset();
+    muteAttachment.reset();
+    soloAttachment.reset();
+
     clipAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         apvts, paramId_slotClip(slot), clipIndexSlider);
+    bankAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        apvts, paramId_slotBank(slot), bankSlider);
     muteAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         apvts, paramId_slotMute(slot), muteButton);
     soloAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         apvts, paramId_slotSolo(slot), soloButton);
 
-    // Bind the clip name label to the ValueTree property (auto-updates)
-    clipNameLabel.getTextValue().referTo(vt.getPropertyAsValue(paramId_slotClipName(slot), nullptr));
-
-    // Bind the *sources* we want to combine
-    clipLenBarsValue.referTo(vt.getPropertyAsValue(paramId_slotClipLenBars(slot), nullptr));
-    clipSamplesValue.referTo(vt.getPropertyAsValue(paramId_slotClipSamplesAt(slot), nullptr));
+    titleLabel.setText("Slot " + juce::String(slot + 1) + ": (empty)", juce::dontSendNotification);
 
-    // Listen for changes on both sources
-    clipLenBarsValue.addListener(this);
-    clipSamplesValue.addListener(this);
+    showSlicePattern();
 
-    // Set initial title & combined text
-    auto clipName = vt.getProperty(paramId_slotClipName(slot)).toString();
-    if (clipName.isEmpty()) clipName = "(empty)";
-    titleLabel.setText("Slot " + juce::String(slot + 1) + ": " + clipName, juce::dontSendNotification);
-
-    updateClipLoopInfoText(); // initialize combined label
+    // The next refresh redraws everything; the meter starts from silence, not the last slot's peak
+    hasShown = false;
+    processor.getSlotMeter(slot).takePeak();
+    meter.reset();
 }
 
-SlotRow::~SlotRow()
+void SlotRow::setTextIfChanged(juce::Label& label, const juce::String& text)
 {
-    // Remove listeners to avoid dangling callbacks
-    clipLenBarsValue.removeListener(this);
-    clipSamplesValue.removeListener(this);
+    if (label.getText() != text)
+        label.setText(text, juce::dontSendNotification);
 }
 
-void SlotRow::valueChanged(juce::Value& /*v*/)
+void SlotRow::refresh(const SlotSnapshot& snapshot)
 {
-    updateClipLoopInfoText();
+    if (!hasShown || snapshot.labelsDiffer(shown))
+        updateLabels(snapshot);
+
+    shown = snapshot;
+    hasShown = true;
+
+    auto& m = processor.getSlotMeter(slot);
+    meter.setLevels(m.takePeak(), m.getRms());
+
+    waveform.setPlayhead(snapshot.activeClip >= 0 ? snapshot.phaseSamples : -1);
+
+    // Changed elsewhere (state restore, another view): follow it unless it is being typed into
+    if (processor.getSlicePatternVersion(slot) != shownSliceVersion && !slicesEditor.hasKeyboardFocus(false))
+        showSlicePattern();
 }
 
-void SlotRow::updateClipLoopInfoText()
+void SlotRow::commitSlicePattern()
 {
-    auto barsStr = clipLenBarsValue.toString();
-    auto samplesStr = clipSamplesValue.toString();
-
-    if (barsStr.isEmpty())    barsStr = "##";
-    if (samplesStr.isEmpty()) samplesStr = "########";
+    processor.setSlicePattern(slot, SlicePattern::fromString(slicesEditor.getText()));
+    showSlicePattern();
+}
 
-    // Update the combined Value once; Label updates automatically via referTo()
-    clipLoopInfoValue = "Bars: " + barsStr + " | Samples: " + samplesStr;
+void SlotRow::showSlicePattern()
+{
+    shownSliceVersion = processor.getSlicePatternVersion(slot);
+    slicesEditor.setText(processor.getSlicePattern(slot).toString(), false);
 }
 
+void SlotRow::updateLabels(const SlotSnapshot& snapshot)
+{
+    if (!hasShown || snapshot.activeClip != shown.activeClip)
+    {
+        const auto active = processor.getClipInfo(snapshot.activeClip);
+        waveform.setOverview(active.overview);
+
+        setTextIfChanged(titleLabel, "Slot " + juce::String(slot + 1) + ": "
+            + (active.name.isEmpty() ? juce::String("(empty)") : active.name));
+
+        setTextIfChanged(clipLoopInfoLabel, active.numSamples > 0
+            ? "Bars: " + juce::String(active.loopBars) + " | Samples: " + juce::String(active.numSamples)
+            : juce::String("Bars: ## | Samples: ########"));
+    }
+
+    // The clip label reflects intent: a launch the engine has queued shows until its bar, else the picked clip
+    if (snapshot.pendingClip >= 0)
+    {
+        const auto pending = processor.getClipInfo(snapshot.pendingClip);
+        setTextIfChanged(clipNameLabel, pending.name + (snapshot.pendingReady ? " (next bar)" : " (loading)"));
+    }
+    else
+    {
+        setTextIfChanged(clipNameLabel, processor.getClipInfo(snapshot.requestedClip).name);
+    }
+
+    recButton.setToggleState(snapshot.record != LiveLooper::State::idle, juce::dontSendNotification);
+}
 
 void SlotRow::resized()
 {
     auto r = getLocalBounds().reduced(4);      // Leaves 8px horizontal padding
     auto col1 = r.removeFromLeft(88);          // "Slot 1:"
-    auto col6 = r.removeFromRight(30);         // Solo button (rightmost)
+    auto col7 = r.removeFromRight(30);         // Record arm (rightmost)
+    auto col6 = r.removeFromRight(30);         // Solo button
     auto col5 = r.removeFromRight(30);         // Mute button
     auto col4 = r.removeFromRight(90);         // Slider
+    auto colBank = r.removeFromRight(70);      // Bank
     auto col3 = r.removeFromRight(160);        // Loop info: "Bars: x | Samples: y"
-    auto col2 = r;                              // Remaining = Clip name
+    auto colMeter = r.removeFromRight(70);     // Level meter
+    auto colSlices = r.removeFromRight(130);   // Slice pattern
+    auto col2 = r.removeFromLeft(r.getWidth() / 2); // Clip name
+    auto colWave = r;                           // Remaining = Waveform
 
     titleLabel.setBounds(col1);
     clipNameLabel.setBounds(col2);
+    waveform.setBounds(colWave.reduced(2, 4));
     clipLoopInfoLabel.setBounds(col3);
+    meter.setBounds(colMeter.reduced(2, 8));
+    slicesEditor.setBounds(colSlices.reduced(2, 6));
     clipIndexSlider.setBounds(col4);
+    bankSlider.setBounds(colBank);
     muteButton.setBounds(col5.reduced(2));
     soloButton.setBounds(col6.reduced(2));
+    recButton.setBounds(col7.reduced(2));
 }
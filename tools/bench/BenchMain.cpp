@@ -0,0 +1,255 @@
+/**
+ * djam_bench: drives DJAM0AudioProcessor::processBlock offline, as fast as
+ * it will go, and reports per-block cost.
+ *
+ *   djam_bench [--sr 48000] [--bpm 120] [--meter 4/4] [--blocks 64,256,1024]
+ *              [--slots 8] [--pattern hold|bar|scatter] [--seconds 60]
+ *              [--clips <folder>] [--fx] [--csv] [--trace <file.json>]
+ *
+ * Without --clips a synthetic pack is generated once in the temp folder.
+ * Patterns: hold = launch every slot once; bar = relaunch every slot with
+ * another clip each bar; scatter = a random slot/clip launch every block.
+ * --trace writes a Chrome/Perfetto trace of the whole run (load included).
+ * With --fx, the mean insert-chain load per slot (percent of the block
+ * budget, as the engine measures it) is added as a last column.
+ */
+
+#include <iostream>
+#include "PluginProcessor.h"
+#include "OfflineHost.h"
+
+using namespace djam::tools;
+
+namespace
+{
+struct Options
+{
+    double sampleRate = 48000.0;
+    double bpm = 120.0;
+    int numerator = 4, denominator = 4;
+    juce::Array<int> blockSizes{ 32, 64, 128, 256, 512, 1024, 2048 };
+    int slots = DJAM0AudioProcessor::getNumSlots();
+    juce::String pattern = "bar";
+    double seconds = 60.0;
+    juce::File clips;
+    bool fx = false;
+    bool csv = false;
+    juce::File trace;
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options o;
+
+    if (args.containsOption("--sr"))      o.sampleRate = args.getValueForOption("--sr").getDoubleValue();
+    if (args.containsOption("--bpm"))     o.bpm = args.getValueForOption("--bpm").getDoubleValue();
+    if (args.containsOption("--seconds")) o.seconds = args.getValueForOption("--seconds").getDoubleValue();
+    if (args.containsOption("--pattern")) o.pattern = args.getValueForOption("--pattern");
+    if (args.containsOption("--clips"))   o.clips = args.getExistingFolderForOption("--clips");
+    if (args.containsOption("--slots"))
+        o.slots = juce::jlimit(1, DJAM0AudioProcessor::getNumSlots(), args.getValueForOption("--slots").getIntValue());
+
+    if (args.containsOption("--meter"))
+    {
+        const auto meter = args.getValueForOption("--meter");
+        o.numerator = juce::jmax(1, meter.upToFirstOccurrenceOf("/", false, false).getIntValue());
+        o.denominator = juce::jmax(1, meter.fromFirstOccurrenceOf("/", false, false).getIntValue());
+    }
+
+    if (args.containsOption("--blocks"))
+    {
+        o.blockSizes.clear();
+        for (auto& token : juce::StringArray::fromTokens(args.getValueForOption("--blocks"), ",", {}))
+            if (token.getIntValue() > 0)
+                o.blockSizes.add(token.getIntValue());
+    }
+
+    o.fx = args.containsOption("--fx");
+    o.csv = args.containsOption("--csv");
+    if (args.containsOption("--trace"))
+        o.trace = args.getFileForOption("--trace");
+    return o;
+}
+
+void setParam(DJAM0AudioProcessor& proc, const juce::String& id, float value)
+{
+    if (auto* p = proc.getAPVTS().getParameter(id))
+        p->setValueNotifyingHost(p->convertTo0to1(value));
+}
+
+struct Result
+{
+    int blockSize = 0;
+    BlockTimings timings;
+    double audioSeconds = 0.0;
+    double insertLoad = 0.0;    // mean per-chain share of the block budget
+};
+
+Result runOnce(const Options& o, const juce::File& clipFolder, int blockSize)
+{
+    DJAM0AudioProcessor proc;
+    proc.setSamplesFolder(clipFolder);
+
+    OfflinePlayHead head(o.sampleRate, o.bpm, o.numerator, o.denominator);
+    proc.setPlayHead(&head);
+    proc.setRateAndBufferSizeDetails(o.sampleRate, blockSize);
+    proc.prepareToPlay(o.sampleRate, blockSize);
+
+    // Clip params pick within the slot's bank; every slot stays on bank 0
+    const int numClips = juce::jlimit(1, DJAM0AudioProcessor::kClipsPerBank, proc.getNumPackClips());
+    juce::Random random(1234);
+
+    for (int s = 0; s < o.slots; ++s)
+    {
+        setParam(proc, paramId_slotClip(s), (float)(s % numClips));
+        setParam(proc, paramId_slotFx(s), o.fx ? 1.0f : 0.0f);
+        if (o.fx)
+        {
+            setParam(proc, paramId_slotFxCutoff(s), 2000.0f);
+            setParam(proc, paramId_slotFxDrive(s), 6.0f);
+            setParam(proc, paramId_slotFxDelayMix(s), 0.3f);
+        }
+    }
+
+    const int numChannels = juce::jmax(proc.getTotalNumInputChannels(), proc.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    const int samplesPerBar = head.samplesPerBar();
+    const auto numBlocks = (size_t)(o.seconds * o.sampleRate / blockSize);
+    const auto warmupBlocks = (size_t)(o.sampleRate / blockSize); // one second, untimed
+
+    Result result;
+    result.blockSize = blockSize;
+    result.timings.reserve(numBlocks);
+
+    int launchCounter = 0;
+    for (size_t b = 0; b < warmupBlocks + numBlocks; ++b)
+    {
+        // Launch patterns run on the "message thread" between blocks
+        const auto pos = head.getSamplePosition();
+        if (o.pattern == "bar" && pos % samplesPerBar < blockSize)
+        {
+            for (int s = 0; s < o.slots; ++s)
+                setParam(proc, paramId_slotClip(s), (float)((s + ++launchCounter) % numClips));
+        }
+        else if (o.pattern == "scatter")
+        {
+            setParam(proc, paramId_slotClip(random.nextInt(o.slots)), (float)random.nextInt(numClips));
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.clear(ch, 0, blockSize);
+
+        const auto t0 = juce::Time::getHighResolutionTicks();
+        proc.processBlock(buffer, midi);
+        const auto t1 = juce::Time::getHighResolutionTicks();
+
+        if (b >= warmupBlocks)
+        {
+            result.timings.add(ticksToNanos(t1 - t0));
+            for (int s = 0; s < o.slots; ++s)
+                result.insertLoad += proc.getSlotInsertLoad(s);
+        }
+
+        head.advance(blockSize);
+    }
+
+    result.audioSeconds = (double)numBlocks * blockSize / o.sampleRate;
+    result.insertLoad /= (double)juce::jmax((size_t)1, numBlocks * (size_t)o.slots);
+
+#if DJAM_PROFILE
+    if (!o.csv)
+        std::cerr << "\n" << proc.getProfiler().createReport() << "\n";
+#endif
+
+    proc.releaseResources();
+    return result;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "djam_bench [--sr N] [--bpm N] [--meter N/D] [--blocks a,b,c] [--slots N]\n"
+                     "           [--pattern hold|bar|scatter] [--seconds N] [--clips DIR] [--fx] [--csv]\n"
+                     "           [--trace FILE]\n";
+        return 0;
+    }
+
+    const auto o = parseOptions(args);
+
+    auto clipFolder = o.clips;
+    if (clipFolder == juce::File())
+    {
+        clipFolder = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("djam_bench_pack");
+        if (!writeSyntheticPack(clipFolder, 16, o.sampleRate, o.bpm, o.numerator, 4))
+        {
+            std::cerr << "could not write the synthetic pack to " << clipFolder.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    if (o.trace != juce::File() && !TraceRecorder::get().start(o.trace))
+    {
+        std::cerr << "could not open " << o.trace.getFullPathName() << " for the trace\n";
+        return 1;
+    }
+
+    if (o.csv)
+        std::cout << "block,ns_per_sample,p50_us,p90_us,p99_us,p999_us,max_us,realtime_factor"
+                  << (o.fx ? ",insert_pct_per_chain" : "") << "\n";
+    else
+        std::cout << "D-Jam bench: " << o.sampleRate << " Hz, " << o.bpm << " BPM, " << o.numerator << "/" << o.denominator
+                  << ", " << o.slots << " slots, pattern " << o.pattern << (o.fx ? ", inserts on" : "")
+                  << ", " << o.seconds << " s per size\n\n"
+                  << " block   ns/sample    p50 us    p90 us    p99 us  p99.9 us    max us       xRT"
+                  << (o.fx ? "  fx %/chain" : "") << "\n";
+
+    for (int blockSize : o.blockSizes)
+    {
+        const auto r = runOnce(o, clipFolder, blockSize);
+        const double totalNs = r.timings.total();
+        const double samples = r.audioSeconds * o.sampleRate;
+        const double nsPerSample = samples > 0.0 ? totalNs / samples : 0.0;
+        const double realtime = totalNs > 0.0 ? r.audioSeconds * 1.0e9 / totalNs : 0.0;
+
+        const double us[] = { r.timings.percentile(50) / 1000.0, r.timings.percentile(90) / 1000.0,
+                              r.timings.percentile(99) / 1000.0, r.timings.percentile(99.9) / 1000.0,
+                              r.timings.percentile(100) / 1000.0 };
+
+        if (o.csv)
+        {
+            std::cout << blockSize << "," << nsPerSample;
+            for (double v : us) std::cout << "," << v;
+            std::cout << "," << realtime;
+            if (o.fx)
+                std::cout << "," << r.insertLoad * 100.0;
+            std::cout << "\n";
+        }
+        else
+        {
+            juce::String line = juce::String(blockSize).paddedLeft(' ', 6)
+                + juce::String(nsPerSample, 2).paddedLeft(' ', 12);
+            for (double v : us)
+                line += juce::String(v, 2).paddedLeft(' ', 10);
+            line += juce::String(realtime, 1).paddedLeft(' ', 10);
+            if (o.fx)
+                line += juce::String(r.insertLoad * 100.0, 3).paddedLeft(' ', 12);
+            std::cout << line << "\n";
+        }
+    }
+
+    if (TraceRecorder::get().isRecording())
+    {
+        TraceRecorder::get().stop();
+        std::cerr << "trace written to " << o.trace.getFullPathName() << " ("
+                  << (juce::int64)TraceRecorder::get().getDroppedCount() << " events dropped)\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+/**
+ * Shared pieces for the headless tools: a synthetic transport, a generated
+ * clip pack and block timing statistics. Header-only so each tool stays a
+ * single main plus the engine sources.
+ */
+namespace djam::tools
+{
+
+/**
+ * AudioPlayHead driven by the caller instead of a host. advance() moves the
+ * transport by one rendered block; jumpTo() models a host locate.
+ */
+class OfflinePlayHead : public juce::AudioPlayHead
+{
+public:
+    OfflinePlayHead(double sampleRate, double bpm, int numerator, int denominator)
+        : sampleRate(sampleRate), bpm(bpm), numerator(numerator), denominator(denominator) {}
+
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        PositionInfo info;
+        info.setIsPlaying(playing);
+        info.setBpm(bpm);
+        info.setTimeSignature(TimeSignature{ numerator, denominator });
+        info.setTimeInSamples(samplePosition);
+        info.setTimeInSeconds(samplePosition / sampleRate);
+        info.setPpqPosition(ppqPosition());
+
+        const double beatsPerBar = numerator * 4.0 / denominator;
+        info.setPpqPositionOfLastBarStart(std::floor(ppqPosition() / beatsPerBar) * beatsPerBar);
+        return info;
+    }
+
+    void setPlaying(bool shouldPlay) noexcept { playing = shouldPlay; }
+    void setBpm(double newBpm) noexcept { bpm = newBpm; }
+    void advance(int numSamples) noexcept { if (playing) samplePosition += numSamples; }
+    void jumpTo(juce::int64 sample) noexcept { samplePosition = sample; }
+
+    double ppqPosition() const noexcept { return samplePosition / sampleRate * bpm / 60.0; }
+    juce::int64 getSamplePosition() const noexcept { return samplePosition; }
+    int samplesPerBar() const noexcept { return (int)std::lround(sampleRate * 60.0 / bpm * numerator * 4.0 / denominator); }
+
+private:
+    double sampleRate, bpm;
+    int numerator, denominator;
+    bool playing = true;
+    juce::int64 samplePosition = 0;
+};
+
+/**
+ * Writes `numClips` bar-aligned test loops (kick on the one, hats on the
+ * beats, a pitched tone per clip) into `folder` as 24-bit WAVs, so tools
+ * exercise the real load, analysis and cache path.
+ */
+inline bool writeSyntheticPack(const juce::File& folder, int numClips, double sampleRate,
+    double bpm, int beatsPerBar, int bars)
+{
+    if (!folder.createDirectory())
+        return false;
+
+    const int samplesPerBeat = (int)std::lround(sampleRate * 60.0 / bpm);
+    const int length = samplesPerBeat * beatsPerBar * bars;
+    const double twoPi = juce::MathConstants<double>::twoPi;
+    juce::WavAudioFormat wav;
+
+    for (int c = 0; c < numClips; ++c)
+    {
+        const auto file = folder.getChildFile("clip" + juce::String(c).paddedLeft('0', 3) + ".wav");
+        if (file.existsAsFile())
+            continue;
+
+        juce::AudioBuffer<float> audio(2, length);
+        const double toneHz = 110.0 * std::pow(2.0, (c % 12) / 12.0);
+
+        for (int i = 0; i < length; ++i)
+        {
+            const int inBeat = i % samplesPerBeat;
+            const bool downbeat = (i % (samplesPerBeat * beatsPerBar)) < samplesPerBeat;
+            const double t = inBeat / sampleRate;
+
+            double s = 0.2 * std::sin(twoPi * toneHz * i / sampleRate);
+            if (downbeat) s += 0.8 * std::exp(-t * 30.0) * std::sin(twoPi * 55.0 * t);
+            s += 0.3 * std::exp(-t * 200.0) * ((i * 7919 % 2000) / 1000.0 - 1.0);
+
+            audio.setSample(0, i, (float)s);
+            audio.setSample(1, i, (float)s);
+        }
+
+        auto stream = file.createOutputStream();
+        if (stream == nullptr)
+            return false;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // owned by the writer now
+        writer->writeFromAudioSampleBuffer(audio, 0, length);
+    }
+
+    return true;
+}
+
+/** Per-block wall-clock samples with summary statistics. */
+class BlockTimings
+{
+public:
+    void reserve(size_t n) { nanos.reserve(n); }
+    void add(double ns) { nanos.push_back(ns); }
+    size_t size() const noexcept { return nanos.size(); }
+
+    double total() const
+    {
+        double sum = 0.0;
+        for (double v : nanos) sum += v;
+        return sum;
+    }
+
+    /** p in [0, 100]; sorts a copy, so call after the run. */
+    double percentile(double p) const
+    {
+        if (nanos.empty())
+            return 0.0;
+
+        auto sorted = nanos;
+        std::sort(sorted.begin(), sorted.end());
+        const auto index = (size_t)std::lround(p / 100.0 * (double)(sorted.size() - 1));
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+private:
+    std::vector<double> nanos;
+};
+
+inline double ticksToNanos(juce::int64 ticks) noexcept
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9;
+}
+
+} // namespace djam::tools
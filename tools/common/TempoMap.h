@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+/**
+ * Piecewise-constant tempo map and a transport that follows it, shared by
+ * the tools that replay sessions (launch scripts, Tracktion edits).
+ */
+namespace djam::tools
+{
+
+struct TempoChange
+{
+    double ppq = 0.0;
+    double bpm = 120.0;
+};
+
+/** Musical time <-> samples under step tempo changes. */
+class TempoMap
+{
+public:
+    /** `tempos` sorted by ppq; a map that does not start at 0 takes its first tempo from 0. */
+    TempoMap(const std::vector<TempoChange>& tempos, double sr)
+        : sampleRate(sr)
+    {
+        for (const auto& t : tempos)
+        {
+            if (segments.empty())
+            {
+                segments.push_back({ 0.0, 0.0, t.bpm });
+                if (t.ppq <= 0.0)
+                    continue;
+            }
+
+            const auto& prev = segments.back();
+            segments.push_back({ t.ppq, prev.startSample + (t.ppq - prev.ppq) * 60.0 / prev.bpm * sampleRate, t.bpm });
+        }
+
+        if (segments.empty())
+            segments.push_back({ 0.0, 0.0, 120.0 });
+    }
+
+    juce::int64 ppqToSample(double ppq) const noexcept
+    {
+        size_t i = 0;
+        while (i + 1 < segments.size() && ppq >= segments[i + 1].ppq)
+            ++i;
+
+        const auto& s = segments[i];
+        return (juce::int64)std::llround(s.startSample + (ppq - s.ppq) * 60.0 / s.bpm * sampleRate);
+    }
+
+    double sampleToPpq(juce::int64 sample) const noexcept
+    {
+        const auto& s = segmentForSample(sample);
+        return s.ppq + ((double)sample - s.startSample) / sampleRate * s.bpm / 60.0;
+    }
+
+    double bpmAtSample(juce::int64 sample) const noexcept { return segmentForSample(sample).bpm; }
+
+    /** First tempo change strictly after `sample`, or -1. */
+    juce::int64 nextChangeAfter(juce::int64 sample) const noexcept
+    {
+        for (const auto& s : segments)
+        {
+            const auto start = (juce::int64)std::llround(s.startSample);
+            if (start > sample)
+                return start;
+        }
+
+        return -1;
+    }
+
+    double getSampleRate() const noexcept { return sampleRate; }
+
+private:
+    struct Segment { double ppq; double startSample; double bpm; };
+
+    const Segment& segmentForSample(juce::int64 sample) const noexcept
+    {
+        size_t i = 0;
+        while (i + 1 < segments.size() && (double)sample >= std::round(segments[i + 1].startSample))
+            ++i;
+        return segments[i];
+    }
+
+    std::vector<Segment> segments;
+    double sampleRate;
+};
+
+/** Always-playing transport that follows a TempoMap; advance() moves it by one block. */
+class TempoMapPlayHead : public juce::AudioPlayHead
+{
+public:
+    TempoMapPlayHead(const TempoMap& map, int numerator, int denominator)
+        : tempoMap(map), numerator(numerator), denominator(denominator) {}
+
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        const double ppq = tempoMap.sampleToPpq(samplePosition);
+        const double beatsPerBar = numerator * 4.0 / denominator;
+
+        PositionInfo info;
+        info.setIsPlaying(true);
+        info.setBpm(tempoMap.bpmAtSample(samplePosition));
+        info.setTimeSignature(TimeSignature{ numerator, denominator });
+        info.setTimeInSamples(samplePosition);
+        info.setTimeInSeconds(samplePosition / tempoMap.getSampleRate());
+        info.setPpqPosition(ppq);
+        info.setPpqPositionOfLastBarStart(std::floor(ppq / beatsPerBar + 1.0e-9) * beatsPerBar);
+        return info;
+    }
+
+    void advance(int numSamples) noexcept { samplePosition += numSamples; }
+    juce::int64 getSamplePosition() const noexcept { return samplePosition; }
+
+private:
+    const TempoMap& tempoMap;
+    int numerator, denominator;
+    juce::int64 samplePosition = 0;
+};
+
+} // namespace djam::tools
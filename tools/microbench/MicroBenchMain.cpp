@@ -0,0 +1,392 @@
+/**
+ * djam_microbench: focused timings for the engine's hot paths.
+ *
+ *   djam_microbench [--filter <substring>] [--min-time 0.05] [--max-block 8192] [--table]
+ *
+ * Prints one JSON object per line (bench, block, channels, ns_per_call,
+ * ns_per_sample, iterations) so results can be diffed between versions.
+ * Each figure is the median of five runs of at least --min-time seconds.
+ */
+
+#include <iostream>
+#include "PluginProcessor.h"
+#include "OfflineHost.h"
+
+using namespace djam::tools;
+
+namespace
+{
+// Keeps results observable so the optimiser can't drop the work
+volatile float floatSink = 0.0f;
+volatile int intSink = 0;
+
+struct Measurement
+{
+    double nsPerCall = 0.0;
+    juce::int64 iterations = 0;
+};
+
+template <typename Fn>
+Measurement measure(Fn&& fn, double minSeconds)
+{
+    // Calibrate: double the batch until it runs long enough
+    juce::int64 batch = 1;
+    for (;;)
+    {
+        const auto t0 = juce::Time::getHighResolutionTicks();
+        for (juce::int64 i = 0; i < batch; ++i)
+            fn();
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - t0);
+
+        if (seconds >= minSeconds || batch >= ((juce::int64)1 << 40))
+            break;
+        batch *= 2;
+    }
+
+    constexpr int kRuns = 5;
+    double runs[kRuns];
+    for (auto& r : runs)
+    {
+        const auto t0 = juce::Time::getHighResolutionTicks();
+        for (juce::int64 i = 0; i < batch; ++i)
+            fn();
+        r = ticksToNanos(juce::Time::getHighResolutionTicks() - t0) / (double)batch;
+    }
+
+    std::sort(std::begin(runs), std::end(runs));
+    return { runs[kRuns / 2], batch * kRuns };
+}
+
+/** As measure(), with `setup` run before every call and its own cost (measured alone) taken off. */
+template <typename Setup, typename Fn>
+Measurement measure(Setup&& setup, Fn&& fn, double minSeconds)
+{
+    auto m = measure([&] { setup(); fn(); }, minSeconds);
+    m.nsPerCall = juce::jmax(0.0, m.nsPerCall - measure(setup, minSeconds).nsPerCall);
+    return m;
+}
+
+// Zeroes every sample; AudioBuffer::clear() skips buffers still flagged clear, which would time nothing
+void zero(juce::AudioBuffer<float>& buffer) noexcept
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        juce::FloatVectorOperations::clear(buffer.getWritePointer(ch), buffer.getNumSamples());
+}
+
+struct Reporter
+{
+    juce::String filter;
+    double minSeconds = 0.05;
+    bool table = false;
+
+    bool wants(const juce::String& name) const { return filter.isEmpty() || name.containsIgnoreCase(filter); }
+
+    void report(const juce::String& name, int block, int channels, const Measurement& m) const
+    {
+        const double perSample = block > 0 ? m.nsPerCall / block : m.nsPerCall;
+
+        if (table)
+        {
+            std::cout << name.paddedRight(' ', 34) << juce::String(block).paddedLeft(' ', 6)
+                      << juce::String(channels).paddedLeft(' ', 4)
+                      << juce::String(m.nsPerCall, 1).paddedLeft(' ', 14)
+                      << juce::String(perSample, 3).paddedLeft(' ', 12) << "\n";
+            return;
+        }
+
+        std::cout << "{\"bench\":\"" << name << "\",\"block\":" << block << ",\"channels\":" << channels
+                  << ",\"ns_per_call\":" << m.nsPerCall << ",\"ns_per_sample\":" << perSample
+                  << ",\"iterations\":" << m.iterations << "}" << std::endl;
+    }
+};
+
+constexpr double kSampleRate = 48000.0;
+constexpr double kBpm = 120.0;
+
+/** A two-bar 4/4 clip at 120 BPM built through the take API (no file I/O). */
+DJamClip makeClip(int channels)
+{
+    const int length = (int)(kSampleRate * 60.0 / kBpm * 8);
+
+    DJamClip clip;
+    clip.prepareTake("bench", channels, length, kSampleRate);
+    juce::Random random(7);
+    for (int ch = 0; ch < channels; ++ch)
+        for (int i = 0; i < length; ++i)
+            clip.getTakeWritePointer(ch)[i] = random.nextFloat() * 2.0f - 1.0f;
+    clip.finishTake(length, 2, (float)kBpm);
+    return clip;
+}
+
+HostPhase makePhase()
+{
+    HostPhase hp;
+    hp.bpm = kBpm;
+    hp.sampleRate = kSampleRate;
+    hp.isPlaying = true;
+    return hp;
+}
+
+void benchClipRender(const Reporter& r, const juce::Array<int>& blocks)
+{
+    const juce::String name = "DJamClip::render";
+    if (!r.wants(name))
+        return;
+
+    for (int channels : { 1, 2 })
+    {
+        const auto clip = makeClip(channels);
+
+        // Walks the loop block by block, so wraps and seam runs are included at their real rate.
+        // Renders add into `out`: it is zeroed before each call, outside the timing, so it never grows
+        for (int block : blocks)
+        {
+            juce::AudioBuffer<float> out(channels, block);
+            juce::int64 position = 0;
+            r.report(name, block, channels, measure([&] { zero(out); }, [&]
+                {
+                    clip.render(out, 0, block, position, nullptr, 1.0f, true);
+                    position = (position + block) % clip.getNumSamples();
+                    floatSink = out.getSample(0, 0);
+                }, r.minSeconds));
+        }
+    }
+}
+
+void benchSlotRender(const Reporter& r, const juce::Array<int>& blocks)
+{
+    const juce::String name = "Slot::render";
+    if (!r.wants(name))
+        return;
+
+    for (int channels : { 1, 2 })
+    {
+        std::vector<DJamClip> bank;
+        bank.push_back(makeClip(channels));
+
+        Slot slot;
+        slot.setClipBank(&bank);
+        slot.armStart(0);
+        slot.applyArmedStart();
+        const auto hp = makePhase();
+
+        for (int block : blocks)
+        {
+            juce::AudioBuffer<float> out(channels, block);
+            LevelAccumulator meter;
+            r.report(name, block, channels, measure([&] { zero(out); }, [&]
+                {
+                    slot.render(out, 0, block, 0, hp, &meter);
+                    floatSink = meter.peak;
+                }, r.minSeconds));
+        }
+    }
+}
+
+void benchSliceRender(const Reporter& r, const juce::Array<int>& blocks)
+{
+    const juce::String name = "Slot::render slices";
+    if (!r.wants(name))
+        return;
+
+    // Reordered, reversed, stuttered and resting steps: every retrigger fades in and out
+    const auto pattern = SlicePattern::fromString("1 1 3r 4x4 - 2 7 8x2");
+
+    for (int channels : { 1, 2 })
+    {
+        std::vector<DJamClip> bank;
+        bank.push_back(makeClip(channels));
+
+        Slot slot;
+        slot.setClipBank(&bank);
+        slot.setSlicePattern(pattern);
+        slot.armStart(0);
+        slot.applyArmedStart();
+        const auto hp = makePhase();
+
+        for (int block : blocks)
+        {
+            juce::AudioBuffer<float> out(channels, block);
+            LevelAccumulator meter;
+            r.report(name, block, channels, measure([&] { zero(out); }, [&]
+                {
+                    slot.render(out, 0, block, 0, hp, &meter);
+                    floatSink = meter.peak;
+                }, r.minSeconds));
+        }
+    }
+}
+
+void benchHostSync(const Reporter& r)
+{
+    if (r.wants("samplesToNextBar"))
+    {
+        auto hp = makePhase();
+        r.report("samplesToNextBar", 0, 0, measure([&]
+            {
+                hp.ppqPosition += 0.01;
+                intSink = samplesToNextBar(hp);
+            }, r.minSeconds));
+    }
+
+    if (r.wants("getHostPhase"))
+    {
+        OfflinePlayHead head(kSampleRate, kBpm, 4, 4);
+        auto hp = makePhase();
+        r.report("getHostPhase", 0, 0, measure([&]
+            {
+                head.advance(256);
+                intSink = getHostPhase(&head, hp) ? 1 : 0;
+            }, r.minSeconds));
+    }
+}
+
+void benchScheduler(const Reporter& r)
+{
+    const juce::String name = "QuantizedScheduler::flushAtBar";
+    if (!r.wants(name))
+        return;
+
+    // One request per slot, then a bar flush: the launch-every-bar worst case
+    QuantizedScheduler<DJAM0AudioProcessor::getNumSlots()> scheduler;
+    const int numRequests = DJAM0AudioProcessor::getNumSlots();
+
+    r.report(name, numRequests, 0, measure([&]
+        {
+            for (int s = 0; s < numRequests; ++s)
+                scheduler.request({ s, s });
+
+            int applied = 0;
+            scheduler.flushAtBar([&](const StartRequest& req) { applied += req.clip; return true; });
+            intSink = applied;
+        }, r.minSeconds));
+}
+
+void benchParameterDispatch(const Reporter& r)
+{
+    const juce::String name = "parameterChanged";
+    if (!r.wants(name))
+        return;
+
+    DJAM0AudioProcessor proc;
+
+    // First and last slot: best and worst case of the ID search
+    const juce::String first = paramId_slotMute(0);
+    const juce::String last = paramId_slotSolo(DJAM0AudioProcessor::getNumSlots() - 1);
+    float value = 0.0f;
+
+    r.report(name + " (first)", 0, 0, measure([&]
+        {
+            value = 1.0f - value;
+            proc.parameterChanged(first, value);
+        }, r.minSeconds));
+
+    r.report(name + " (last)", 0, 0, measure([&]
+        {
+            value = 1.0f - value;
+            proc.parameterChanged(last, value);
+        }, r.minSeconds));
+}
+
+void benchState(const Reporter& r)
+{
+    const juce::String name = "state";
+    if (!r.wants(name))
+        return;
+
+    // Save is what hosts call for every undo snapshot; restore is per instance at session load.
+    // The block column carries the state size in bytes.
+    DJAM0AudioProcessor proc;
+    juce::MemoryBlock saved;
+    proc.getStateInformation(saved);
+
+    r.report(name + " save", (int)saved.getSize(), 0, measure([&]
+        {
+            juce::MemoryBlock block;
+            proc.getStateInformation(block);
+            intSink = (int)block.getSize();
+        }, r.minSeconds));
+
+    r.report(name + " restore", (int)saved.getSize(), 0, measure([&]
+        {
+            proc.setStateInformation(saved.getData(), (int)saved.getSize());
+        }, r.minSeconds));
+}
+
+void benchSearch(const Reporter& r)
+{
+    const juce::String name = "ClipSearchIndex::search";
+    if (!r.wants(name))
+        return;
+
+    // A large synthetic pack: folder tags, loop-library style names, tempo on most clips.
+    // The block column carries the number of clips.
+    constexpr int numClips = 50000;
+    const char* const folders[] = { "Drums", "Bass", "Keys", "Vocals", "FX", "Pads", "Guitar", "Percussion" };
+    const char* const words[] = { "deep", "house", "groove", "funky", "dark", "minimal", "acid", "warm",
+                                  "break", "shuffle", "rolling", "dusty", "bright", "chord", "stab", "riser" };
+    const char* const keys[] = { "Am", "C", "Dm", "F#m", "G", "Eb", "Bbm", "E" };
+
+    ClipSearchIndex index;
+    index.clear(numClips);
+    juce::Random random(11);
+
+    for (int i = 0; i < numClips; ++i)
+    {
+        const int bpm = 90 + random.nextInt(60);
+        const juce::String clipName = juce::String(words[random.nextInt(16)]) + "_" + words[random.nextInt(16)]
+            + "_" + juce::String(bpm) + "_" + keys[random.nextInt(8)] + "_" + juce::String(i % 100).paddedLeft('0', 2);
+
+        index.addClip(i, clipName, { folders[i % 8] });
+        if (random.nextInt(4) != 0)
+            index.setMetadata(i, { (float)bpm, 1 << random.nextInt(4) });
+    }
+
+    const std::pair<const char*, const char*> queries[] = {
+        { "prefix", "gro" },
+        { "two words", "deep drums" },
+        { "fuzzy", "shufle" },
+        { "filters", "bass bpm:118-124 key:am" },
+    };
+
+    for (const auto& [label, query] : queries)
+    {
+        const juce::String text(query);
+        r.report(name + " (" + label + ")", numClips, 0, measure([&]
+            {
+                intSink = (int)index.search(text, 500).size();
+            }, r.minSeconds));
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    const juce::ArgumentList args(argc, argv);
+
+    Reporter reporter;
+    if (args.containsOption("--filter"))   reporter.filter = args.getValueForOption("--filter");
+    if (args.containsOption("--min-time")) reporter.minSeconds = args.getValueForOption("--min-time").getDoubleValue();
+    reporter.table = args.containsOption("--table");
+
+    const int maxBlock = args.containsOption("--max-block")
+        ? juce::jlimit(1, 1 << 16, args.getValueForOption("--max-block").getIntValue()) : 8192;
+
+    juce::Array<int> blocks;
+    for (int b = 1; b <= maxBlock; b *= 2)
+        blocks.add(b);
+
+    if (reporter.table)
+        std::cout << juce::String("bench").paddedRight(' ', 34) << " block  ch   ns/call       ns/sample\n";
+
+    benchClipRender(reporter, blocks);
+    benchSlotRender(reporter, blocks);
+    benchSliceRender(reporter, blocks);
+    benchHostSync(reporter);
+    benchScheduler(reporter);
+    benchParameterDispatch(reporter);
+    benchState(reporter);
+    benchSearch(reporter);
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include "LaunchScript.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace djam::tools
+{
+
+//===================== LaunchScript =====================
+
+bool LaunchScript::parsePosition(const juce::String& token, double& ppq) const
+{
+    // bar[.beat[.sixteenth]], all 1-based
+    const auto parts = juce::StringArray::fromTokens(token, ".", {});
+    if (parts.isEmpty() || parts.size() > 3)
+        return false;
+
+    int fields[3] = { 1, 1, 1 };
+    for (int i = 0; i < parts.size(); ++i)
+    {
+        if (!parts[i].containsOnly("0123456789") || parts[i].isEmpty())
+            return false;
+        fields[i] = parts[i].getIntValue();
+        if (fields[i] < 1)
+            return false;
+    }
+
+    const double beatLength = 4.0 / denominator;
+    ppq = (fields[0] - 1) * beatsPerBar() + (fields[1] - 1) * beatLength + (fields[2] - 1) * 0.25;
+    return true;
+}
+
+bool LaunchScript::parse(const juce::String& text, juce::String& error)
+{
+    std::map<juce::String, std::vector<std::pair<int, int>>> scenes;
+    std::vector<std::pair<double, juce::String>> rawTempos;  // position token resolved after the meter
+    std::vector<std::pair<int, juce::StringArray>> rawEvents;
+
+    tempos.clear();
+    events.clear();
+
+    const auto lines = juce::StringArray::fromLines(text);
+    auto fail = [&error](int line, const juce::String& message)
+        {
+            error = "line " + juce::String(line + 1) + ": " + message;
+            return false;
+        };
+
+    // Pass 1: settings, scenes and tempos (the meter must be known before positions mean anything)
+    for (int l = 0; l < lines.size(); ++l)
+    {
+        const auto line = lines[l].upToFirstOccurrenceOf("#", false, false).trim();
+        if (line.isEmpty())
+            continue;
+
+        const auto tokens = juce::StringArray::fromTokens(line, " \t", {});
+        const auto& keyword = tokens[0];
+
+        if (keyword == "samplerate" && tokens.size() == 2)
+        {
+            sampleRate = tokens[1].getDoubleValue();
+            if (sampleRate < 8000.0 || sampleRate > 384000.0)
+                return fail(l, "sample rate out of range");
+        }
+        else if (keyword == "meter" && tokens.size() == 2)
+        {
+            numerator = tokens[1].upToFirstOccurrenceOf("/", false, false).getIntValue();
+            denominator = tokens[1].fromFirstOccurrenceOf("/", false, false).getIntValue();
+            if (numerator < 1 || !juce::isPositiveAndBelow(denominator, 33) || !juce::isPowerOfTwo(denominator))
+                return fail(l, "bad meter");
+        }
+        else if (keyword == "length" && tokens.size() == 2)
+        {
+            lengthBars = tokens[1].getDoubleValue();
+            if (lengthBars <= 0.0)
+                return fail(l, "length must be positive");
+        }
+        else if (keyword == "seed" && tokens.size() == 2)
+        {
+            seed = tokens[1].getLargeIntValue();
+        }
+        else if (keyword == "tempo" && tokens.size() == 3)
+        {
+            if (!tokens[1].containsOnly("0123456789") || tokens[1].getIntValue() < 1)
+                return fail(l, "tempo changes go on a bar");
+            const double bpm = tokens[2].getDoubleValue();
+            if (bpm < 20.0 || bpm > 400.0)
+                return fail(l, "bpm out of range");
+            rawTempos.push_back({ bpm, tokens[1] });
+        }
+        else if (keyword == "scene" && tokens.size() >= 3)
+        {
+            auto& pairs = scenes[tokens[1]];
+            pairs.clear();
+            for (int t = 2; t < tokens.size(); ++t)
+            {
+                const int slot = tokens[t].upToFirstOccurrenceOf(":", false, false).getIntValue();
+                const int clip = tokens[t].fromFirstOccurrenceOf(":", false, false).getIntValue();
+                if (!tokens[t].contains(":") || slot < 0 || clip < 0)
+                    return fail(l, "scene entries are slot:clip");
+                pairs.push_back({ slot, clip });
+            }
+        }
+        else if (keyword == "at" && tokens.size() >= 3)
+        {
+            rawEvents.push_back({ l, tokens });
+        }
+        else
+        {
+            return fail(l, "unknown statement '" + line + "'");
+        }
+    }
+
+    for (const auto& [bpm, bar] : rawTempos)
+        tempos.push_back({ (bar.getIntValue() - 1) * beatsPerBar(), bpm });
+
+    std::stable_sort(tempos.begin(), tempos.end(),
+        [](const TempoChange& a, const TempoChange& b) { return a.ppq < b.ppq; });
+    if (tempos.empty() || tempos.front().ppq > 0.0)
+        tempos.insert(tempos.begin(), { 0.0, tempos.empty() ? 120.0 : tempos.front().bpm });
+
+    // Pass 2: timed actions
+    for (const auto& [l, tokens] : rawEvents)
+    {
+        LaunchEvent e;
+        if (!parsePosition(tokens[1], e.ppq))
+            return fail(l, "bad position '" + tokens[1] + "' (bar[.beat[.sixteenth]])");
+
+        const auto& action = tokens[2];
+        auto onOff = [&tokens](int& value)
+            {
+                value = tokens[4] == "on" ? 1 : 0;
+                return tokens[4] == "on" || tokens[4] == "off";
+            };
+
+        if (action == "launch" && tokens.size() == 5)
+        {
+            e.type = LaunchEvent::Type::launch;
+            e.slot = tokens[3].getIntValue();
+            e.value = tokens[4].getIntValue();
+            events.push_back(e);
+        }
+        else if (action == "scene" && tokens.size() == 4)
+        {
+            const auto it = scenes.find(tokens[3]);
+            if (it == scenes.end())
+                return fail(l, "unknown scene '" + tokens[3] + "'");
+
+            for (const auto& [slot, clip] : it->second)
+                events.push_back({ e.ppq, LaunchEvent::Type::launch, slot, clip });
+        }
+        else if (action == "slices" && tokens.size() >= 5)
+        {
+            e.type = LaunchEvent::Type::slices;
+            e.slot = tokens[3].getIntValue();
+            e.pattern = tokens[4] == "off" ? juce::String() : juce::StringArray(tokens.begin() + 4, tokens.size() - 4).joinIntoString(" ");
+            events.push_back(e);
+        }
+        else if ((action == "mute" || action == "solo") && tokens.size() == 5)
+        {
+            e.type = action == "mute" ? LaunchEvent::Type::mute : LaunchEvent::Type::solo;
+            e.slot = tokens[3].getIntValue();
+            if (!onOff(e.value))
+                return fail(l, action + " takes on|off");
+            events.push_back(e);
+        }
+        else
+        {
+            return fail(l, "unknown action '" + action + "'");
+        }
+
+        if (events.back().slot < 0 || events.back().value < 0)
+            return fail(l, "negative slot or clip");
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+        [](const LaunchEvent& a, const LaunchEvent& b) { return a.ppq < b.ppq; });
+    return true;
+}
+
+juce::Array<int> LaunchScript::getLaunchedSlots() const
+{
+    juce::Array<int> result;
+    for (const auto& e : events)
+        if (e.type == LaunchEvent::Type::launch)
+            result.addIfNotAlreadyThere(e.slot);
+
+    result.sort();
+    return result;
+}
+
+std::vector<LaunchEvent> LaunchScript::eventsForStem(int slot) const
+{
+    std::vector<LaunchEvent> result;
+    std::map<int, bool> muted, soloed;
+    bool audible = true;
+
+    for (size_t i = 0; i < events.size();)
+    {
+        // Apply every event at this time before judging audibility, as the engine would see them
+        const double ppq = events[i].ppq;
+        for (; i < events.size() && events[i].ppq == ppq; ++i)
+        {
+            const auto& e = events[i];
+            if ((e.type == LaunchEvent::Type::launch || e.type == LaunchEvent::Type::slices) && e.slot == slot)
+                result.push_back(e);
+            else if (e.type == LaunchEvent::Type::mute)
+                muted[e.slot] = e.value != 0;
+            else if (e.type == LaunchEvent::Type::solo)
+                soloed[e.slot] = e.value != 0;
+        }
+
+        const bool anySolo = std::any_of(soloed.begin(), soloed.end(), [](const auto& s) { return s.second; });
+        const bool nowAudible = !muted[slot] && (!anySolo || soloed[slot]);
+
+        if (nowAudible != audible)
+            result.push_back({ ppq, LaunchEvent::Type::mute, slot, nowAudible ? 0 : 1 });
+        audible = nowAudible;
+    }
+
+    return result;
+}
+
+} // namespace djam::tools
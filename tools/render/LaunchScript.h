@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <juce_core/juce_core.h>
+#include "TempoMap.h"
+
+/**
+ * Launch script for djam_render: a tempo map plus timestamped performer
+ * actions, in plain text, one statement per line ('#' starts a comment).
+ *
+ *   samplerate 48000
+ *   meter 4/4
+ *   length 32                  bars to render
+ *   seed 1                     follow-action dice
+ *   tempo 1 120                bpm from a bar on (bars are 1-based)
+ *   scene intro 0:3 1:7        slot:clip pairs, launched together
+ *   at 1 launch 0 3            slot 0 requests clip 3
+ *   at 8.4 scene intro         bar 8, beat 4
+ *   at 9 mute 2 on
+ *   at 9.2.3 solo 1 off        bar 9, beat 2, third sixteenth
+ *   at 11 slices 2 1 1 3r 4x4  slot 2 plays a slice pattern (SlicePattern text)
+ *   at 15 slices 2 off         and straight again
+ *
+ * Actions happen at exactly their time, as if a performer pressed the
+ * button there; launches are then quantized by the engine like live ones,
+ * so "at 4.4 launch" starts on bar 5. Tempo changes must fall on a bar.
+ */
+namespace djam::tools
+{
+
+struct LaunchEvent
+{
+    enum class Type { launch, mute, solo, slices };
+
+    double ppq = 0.0;
+    Type type = Type::launch;
+    int slot = 0;
+    int value = 0; // clip index, or 0/1 for mute and solo
+    juce::String pattern; // slices: SlicePattern text form, empty = off
+};
+
+class LaunchScript
+{
+public:
+    /** Parses `text`; on failure returns false with a line-numbered message in `error`. */
+    bool parse(const juce::String& text, juce::String& error);
+
+    double sampleRate = 48000.0;
+    int numerator = 4, denominator = 4;
+    double lengthBars = 16.0;
+    juce::int64 seed = 1;
+
+    std::vector<TempoChange> tempos;    // sorted, first one at ppq 0
+    std::vector<LaunchEvent> events;    // sorted by time, file order kept within a time
+
+    double beatsPerBar() const noexcept { return numerator * 4.0 / denominator; }
+    double lengthPpq() const noexcept { return lengthBars * beatsPerBar(); }
+
+    /** Slots with at least one launch. */
+    juce::Array<int> getLaunchedSlots() const;
+
+    /**
+     * Events that reproduce slot `slot` alone: its launches and slice patterns, plus a mute
+     * whenever the mix's mute/solo state makes it (in)audible. Another
+     * slot's solo thereby mutes this one without touching other slots.
+     */
+    std::vector<LaunchEvent> eventsForStem(int slot) const;
+
+private:
+    bool parsePosition(const juce::String& token, double& ppq) const;
+};
+
+} // namespace djam::tools
@@ -0,0 +1,337 @@
+/**
+ * djam_render: renders a launch script through the D-Jam engine offline,
+ * faster than real time, to a stereo mix and/or per-slot stems.
+ *
+ *   djam_render <script> [-o mix.wav] [--stems <folder>] [--clips <folder>]
+ *               [--block 512] [--float] [--hash] [--repeat N] [--check]
+ *
+ * See LaunchScript.h for the script format. The mix and every stem render
+ * in their own engine instance on their own thread; a stem instance only
+ * hears its slot's launches, and mute/solo reach it as a plain mute.
+ *
+ * Output is bit-exact between runs: blocks are cut at event and tempo-change
+ * times only, the follow-action dice are seeded from the script and clips
+ * load in name order. --hash prints a digest of each render and --repeat
+ * renders N times and fails if any digest differs (used as a ctest).
+ * --check also fails unless every stem sounds on the first beat of the bar
+ * its first launch lands on, so a dropped or late launch can't pass as
+ * deterministic silence.
+ * Without --clips a synthetic pack is generated once in the temp folder.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "PluginProcessor.h"
+#include "ParallelFor.h"
+#include "OfflineHost.h"
+#include "LaunchScript.h"
+
+using namespace djam::tools;
+
+namespace
+{
+struct Options
+{
+    juce::File script, mixFile, stemFolder, clips;
+    int blockSize = 512;
+    bool floatOutput = false;
+    bool hash = false;
+    int repeat = 1;
+    bool check = false;
+};
+
+struct Job
+{
+    juce::String name;                  // "mix" or "slotN"
+    std::vector<LaunchEvent> events;
+    juce::File target;
+    int slot = -1;                      // stems only
+    juce::AudioBuffer<float> audio;
+    juce::uint64 digest = 0;
+    juce::String error;
+};
+
+void setParam(DJAM0AudioProcessor& proc, const juce::String& id, float value)
+{
+    if (auto* p = proc.getAPVTS().getParameter(id))
+        p->setValueNotifyingHost(p->convertTo0to1(value));
+}
+
+void applyEvent(DJAM0AudioProcessor& proc, const LaunchEvent& e)
+{
+    if (e.slot >= DJAM0AudioProcessor::getNumSlots())
+        return;
+
+    switch (e.type)
+    {
+        case LaunchEvent::Type::launch:
+            // Through "no clip" first, so relaunching the current clip still notifies; the
+            // bank goes first so the clip request lands in it
+            setParam(proc, paramId_slotClip(e.slot), -1.0f);
+            setParam(proc, paramId_slotBank(e.slot), (float)(e.value / DJAM0AudioProcessor::kClipsPerBank));
+            setParam(proc, paramId_slotClip(e.slot), (float)(e.value % DJAM0AudioProcessor::kClipsPerBank));
+            break;
+        case LaunchEvent::Type::mute:
+            setParam(proc, paramId_slotMute(e.slot), (float)e.value);
+            break;
+        case LaunchEvent::Type::solo:
+            setParam(proc, paramId_slotSolo(e.slot), (float)e.value);
+            break;
+        case LaunchEvent::Type::slices:
+            proc.setSlicePattern(e.slot, SlicePattern::fromString(e.pattern));
+            break;
+    }
+}
+
+/** FNV-1a over the sample bit patterns: any changed sample changes the digest. */
+juce::uint64 digestOf(const juce::AudioBuffer<float>& audio)
+{
+    juce::uint64 h = 0xcbf29ce484222325ull;
+    for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+    {
+        const auto* bytes = reinterpret_cast<const juce::uint8*>(audio.getReadPointer(ch));
+        for (size_t i = 0; i < (size_t)audio.getNumSamples() * sizeof(float); ++i)
+            h = (h ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+void render(const LaunchScript& script, const TempoMap& tempoMap, const Options& o,
+    const juce::File& clipFolder, Job& job)
+{
+    DJAM0AudioProcessor proc;
+    proc.setSamplesFolder(clipFolder);
+    proc.setFollowSeed(script.seed);
+    proc.setNonRealtime(true);
+
+    TempoMapPlayHead head(tempoMap, script.numerator, script.denominator);
+    proc.setPlayHead(&head);
+    proc.setRateAndBufferSizeDetails(script.sampleRate, o.blockSize);
+    proc.prepareToPlay(script.sampleRate, o.blockSize);
+
+    const auto total = tempoMap.ppqToSample(script.lengthPpq());
+    const int numChannels = juce::jmax(proc.getTotalNumInputChannels(), proc.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, o.blockSize);
+    juce::MidiBuffer midi;
+
+    job.audio.setSize(2, (int)total);
+    job.audio.clear();
+
+    std::vector<juce::int64> eventSamples;
+    for (const auto& e : job.events)
+        eventSamples.push_back(tempoMap.ppqToSample(e.ppq));
+
+    size_t next = 0;
+    for (juce::int64 pos = 0; pos < total;)
+    {
+        // Actions land between blocks, exactly at their sample
+        for (; next < job.events.size() && eventSamples[next] <= pos; ++next)
+            applyEvent(proc, job.events[next]);
+
+        // Cut the block at the next action or tempo change
+        juce::int64 end = juce::jmin(pos + o.blockSize, total);
+        if (next < eventSamples.size())
+            end = juce::jmin(end, eventSamples[next]);
+        if (const auto change = tempoMap.nextChangeAfter(pos); change > 0)
+            end = juce::jmin(end, change);
+
+        const int n = (int)(end - pos);
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, n);
+        block.clear();
+        proc.processBlock(block, midi);
+
+        for (int ch = 0; ch < 2; ++ch)
+            job.audio.copyFrom(ch, (int)pos, block, juce::jmin(ch, numChannels - 1), 0, n);
+
+        head.advance(n);
+        pos = end;
+    }
+
+    proc.releaseResources();
+    job.digest = digestOf(job.audio);
+}
+
+/**
+ * Empty if the stem sounds on the first beat of the bar its first launch
+ * lands on (launches are quantized to the next bar), else what is wrong.
+ * Skipped while the stem is muted there.
+ */
+juce::String checkFirstLaunch(const LaunchScript& script, const TempoMap& tempoMap, const Job& job)
+{
+    const auto launch = std::find_if(job.events.begin(), job.events.end(),
+        [](const LaunchEvent& e) { return e.type == LaunchEvent::Type::launch; });
+    if (launch == job.events.end())
+        return {};
+
+    const double bar = script.beatsPerBar();
+    const double landing = (std::floor(launch->ppq / bar + 1.0e-9) + 1.0) * bar;
+    const double beatEnd = landing + 4.0 / script.denominator;
+    if (beatEnd > script.lengthPpq())
+        return {};
+
+    bool muted = false;
+    for (const auto& e : job.events)
+    {
+        if (e.type != LaunchEvent::Type::mute || e.ppq >= beatEnd)
+            continue;
+        if (e.ppq > landing)
+            return {};     // mute changes inside the window: nothing certain to check
+        muted = e.value != 0;
+    }
+
+    if (muted)
+        return {};
+
+    const auto start = tempoMap.ppqToSample(landing);
+    const int n = (int)(tempoMap.ppqToSample(beatEnd) - start);
+    if (job.audio.getMagnitude((int)start, n) > 1.0e-3f)
+        return {};
+
+    return job.name + " is silent on bar " + juce::String((int)(landing / bar) + 1)
+         + ", where its first launch should have started";
+}
+
+bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio, double sampleRate, bool floatOutput)
+{
+    file.deleteFile();
+    auto stream = file.createOutputStream();
+    if (stream == nullptr)
+        return false;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+        (unsigned int)audio.getNumChannels(), floatOutput ? 32 : 24, {}, 0));
+    if (writer == nullptr)
+        return false;
+
+    stream.release(); // owned by the writer now
+    return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+}
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options o;
+    o.script = juce::File::getCurrentWorkingDirectory().getChildFile(args[0].text.unquoted());
+
+    if (args.containsOption("-o"))       o.mixFile = args.getFileForOption("-o");
+    if (args.containsOption("--stems"))  o.stemFolder = args.getFileForOption("--stems");
+    if (args.containsOption("--clips"))  o.clips = args.getExistingFolderForOption("--clips");
+    if (args.containsOption("--block"))  o.blockSize = juce::jlimit(1, 8192, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--repeat")) o.repeat = juce::jmax(1, args.getValueForOption("--repeat").getIntValue());
+    o.floatOutput = args.containsOption("--float");
+    o.hash = args.containsOption("--hash");
+    o.check = args.containsOption("--check");
+    return o;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        std::cout << "djam_render <script> [-o mix.wav] [--stems DIR] [--clips DIR] [--block N]\n"
+                     "            [--float] [--hash] [--repeat N] [--check]\n";
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    const auto o = parseOptions(args);
+
+    LaunchScript script;
+    juce::String error;
+    if (!script.parse(o.script.loadFileAsString(), error))
+    {
+        std::cerr << o.script.getFullPathName() << ": " << error << "\n";
+        return 1;
+    }
+
+    auto clipFolder = o.clips;
+    if (clipFolder == juce::File())
+    {
+        clipFolder = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("djam_render_pack");
+        if (!writeSyntheticPack(clipFolder, 16, script.sampleRate, script.tempos.front().bpm, script.numerator, 4))
+        {
+            std::cerr << "could not write the synthetic pack to " << clipFolder.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    // Fill the clip cache once up front, so every instance reads the same cached analysis
+    {
+        DJAM0AudioProcessor warm;
+        warm.setSamplesFolder(clipFolder);
+        warm.setRateAndBufferSizeDetails(script.sampleRate, o.blockSize);
+        warm.prepareToPlay(script.sampleRate, o.blockSize);
+        warm.releaseResources();
+    }
+
+    const TempoMap tempoMap(script.tempos, script.sampleRate);
+    const bool wantMix = o.mixFile != juce::File() || o.stemFolder == juce::File();
+    juce::uint64 firstDigests = 0;
+
+    for (int run = 0; run < o.repeat; ++run)
+    {
+        std::vector<Job> jobs;
+        if (wantMix)
+            jobs.push_back({ "mix", script.events, o.mixFile });
+
+        if (o.stemFolder != juce::File())
+        {
+            o.stemFolder.createDirectory();
+            for (int slot : script.getLaunchedSlots())
+                jobs.push_back({ "slot" + juce::String(slot + 1), script.eventsForStem(slot),
+                                 o.stemFolder.getChildFile("slot" + juce::String(slot + 1) + ".wav"), slot });
+        }
+
+        const auto t0 = juce::Time::getHighResolutionTicks();
+
+        // Instances share nothing but the read-only pack folder: one per thread
+        parallelFor((int)jobs.size(), [&](int i)
+            {
+                auto& job = jobs[(size_t)i];
+                render(script, tempoMap, o, clipFolder, job);
+
+                if (job.target != juce::File() && run == 0
+                    && !writeWav(job.target, job.audio, script.sampleRate, o.floatOutput))
+                    job.error = "could not write " + job.target.getFullPathName();
+
+                if (o.check && job.slot >= 0 && job.error.isEmpty())
+                    job.error = checkFirstLaunch(script, tempoMap, job);
+            });
+
+        const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - t0);
+        const double audioSeconds = tempoMap.ppqToSample(script.lengthPpq()) / script.sampleRate;
+
+        juce::uint64 combined = 0;
+        for (const auto& job : jobs)
+        {
+            if (job.error.isNotEmpty())
+            {
+                std::cerr << job.error << "\n";
+                return 1;
+            }
+
+            combined = combined * 31 + job.digest;
+            if (o.hash)
+                std::cout << job.name << " " << juce::String::toHexString((juce::int64)job.digest).paddedLeft('0', 16) << "\n";
+        }
+
+        std::cerr << "rendered " << jobs.size() << " x " << audioSeconds << " s in " << seconds << " s ("
+                  << juce::String(audioSeconds * (double)jobs.size() / juce::jmax(1.0e-9, seconds), 1) << "x real time)\n";
+
+        if (run == 0)
+        {
+            firstDigests = combined;
+        }
+        else if (combined != firstDigests)
+        {
+            std::cerr << "render " << run + 1 << " differs from the first: output is not deterministic\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,283 @@
+/**
+ * djam_replay: replays a Tracktion / Waveform session headlessly through
+ * DJAM0AudioProcessor and checks it, so operational test sessions run as
+ * automated timing and performance regressions.
+ *
+ *   djam_replay <edit.tracktionedit> [--sr 48000] [--block 512] [--seconds N]
+ *               [--clips <folder>] [--tolerance 1] [--max-load 0.5] [--csv <file>]
+ *
+ * The edit's tempo sequence and time signature drive the playhead, the
+ * D-Jam instance's saved state is restored and its automation is applied
+ * between blocks. Blocks are cut at tempo changes, as a host would.
+ *
+ * Checks, after every block:
+ *  - every clip start and loop wrap happened on a bar line (within
+ *    --tolerance samples);
+ *  - with --max-load, the p99 block time stays under that fraction of
+ *    the block's real-time budget.
+ * Per-block CPU goes to --csv. Exit code 0 passes, 1 fails, 2 for bad input.
+ * Without --clips a synthetic pack is generated once in the temp folder.
+ */
+
+#include <iostream>
+#include "PluginProcessor.h"
+#include "OfflineHost.h"
+#include "TracktionEdit.h"
+
+using namespace djam::tools;
+
+namespace
+{
+struct Options
+{
+    juce::File edit, clips, csv;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    double seconds = 0.0;       // 0 = the edit's length plus a bar
+    int tolerance = 1;
+    double maxLoad = 0.0;       // 0 = report only
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options o;
+    o.edit = juce::File::getCurrentWorkingDirectory().getChildFile(args[0].text.unquoted());
+
+    if (args.containsOption("--sr"))        o.sampleRate = args.getValueForOption("--sr").getDoubleValue();
+    if (args.containsOption("--block"))     o.blockSize = juce::jlimit(1, 8192, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--seconds"))   o.seconds = args.getValueForOption("--seconds").getDoubleValue();
+    if (args.containsOption("--clips"))     o.clips = args.getExistingFolderForOption("--clips");
+    if (args.containsOption("--tolerance")) o.tolerance = juce::jmax(0, args.getValueForOption("--tolerance").getIntValue());
+    if (args.containsOption("--max-load"))  o.maxLoad = args.getValueForOption("--max-load").getDoubleValue();
+    if (args.containsOption("--csv"))       o.csv = args.getFileForOption("--csv");
+    return o;
+}
+
+/**
+ * Finds the parameter an automation lane was recorded against. Hosts store
+ * our string ID, the VST3 ID JUCE derives from it, or the parameter index.
+ */
+juce::RangedAudioParameter* findParameter(DJAM0AudioProcessor& proc, const juce::String& stored)
+{
+    auto& apvts = proc.getAPVTS();
+    if (auto* p = apvts.getParameter(stored))
+        return p;
+
+    const auto& params = proc.getParameters();
+    for (int i = 0; i < params.size(); ++i)
+    {
+        auto* p = dynamic_cast<juce::RangedAudioParameter*>(params[i]);
+        if (p == nullptr)
+            continue;
+
+        const auto vst3ID = (juce::uint32)p->getParameterID().hashCode() & 0x7fffffffu;
+        if (stored == juce::String(vst3ID) || stored == juce::String(i))
+            return p;
+    }
+
+    return nullptr;
+}
+
+/** Verifies clip starts and loop wraps land on bar lines. */
+class BarAlignmentCheck
+{
+public:
+    BarAlignmentCheck(const TempoMap& map, double beatsPerBar, int tolerance)
+        : tempoMap(map), beatsPerBar(beatsPerBar), tolerance(tolerance) {}
+
+    /** Call after the block [blockEnd - numSamples, blockEnd). */
+    void check(const EngineSnapshot& now, juce::int64 blockEnd, int numSamples)
+    {
+        if (previous.slots.size() != now.slots.size())
+            previous.slots.resize(now.slots.size());
+
+        for (size_t s = 0; s < now.slots.size(); ++s)
+        {
+            const auto& before = previous.slots[s];
+            const auto& after = now.slots[s];
+            if (after.activeClip < 0)
+                continue;
+
+            const bool started = after.activeClip != before.activeClip;
+            const bool wrapped = !started && after.phaseSamples < before.phaseSamples + numSamples
+                && after.phaseSamples != before.phaseSamples; // muted slots hold their phase
+            if (!started && !wrapped)
+                continue;
+
+            // Where the clip (re)started inside this block
+            const juce::int64 at = blockEnd - after.phaseSamples;
+            const double bar = std::round(tempoMap.sampleToPpq(at) / beatsPerBar);
+            const juce::int64 barLine = tempoMap.ppqToSample(bar * beatsPerBar);
+
+            ++(started ? starts : wraps);
+
+            if (std::abs(at - barLine) > tolerance && failures.size() < 50)
+                failures.add("slot " + juce::String((int)s + 1) + (started ? " started clip " : " wrapped clip ")
+                    + juce::String(after.activeClip) + " at sample " + juce::String(at) + ", "
+                    + juce::String(at - barLine) + " samples off bar " + juce::String((int)bar + 1));
+            if (std::abs(at - barLine) > tolerance)
+                ++numFailures;
+        }
+
+        previous = now;
+    }
+
+    int starts = 0, wraps = 0, numFailures = 0;
+    juce::StringArray failures;     // first few, for the log
+
+private:
+    const TempoMap& tempoMap;
+    double beatsPerBar;
+    int tolerance;
+    EngineSnapshot previous;
+};
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        std::cout << "djam_replay <edit.tracktionedit> [--sr N] [--block N] [--seconds N] [--clips DIR]\n"
+                     "            [--tolerance N] [--max-load F] [--csv FILE]\n";
+        return args.size() == 0 ? 2 : 0;
+    }
+
+    const auto o = parseOptions(args);
+
+    TracktionEdit edit;
+    juce::String error;
+    if (!edit.load(o.edit, error))
+    {
+        std::cerr << error << "\n";
+        return 2;
+    }
+
+    for (const auto& w : edit.warnings)
+        std::cerr << "warning: " << w << "\n";
+
+    const TempoMap tempoMap(edit.tempos, o.sampleRate);
+    const double beatsPerBar = edit.numerator * 4.0 / edit.denominator;
+
+    auto clipFolder = o.clips;
+    if (clipFolder == juce::File())
+    {
+        clipFolder = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("djam_replay_pack");
+        const double bpm = edit.tempos.empty() ? 120.0 : edit.tempos.front().bpm;
+        if (!writeSyntheticPack(clipFolder, 16, o.sampleRate, bpm, edit.numerator, 4))
+        {
+            std::cerr << "could not write the synthetic pack to " << clipFolder.getFullPathName() << "\n";
+            return 2;
+        }
+    }
+
+    DJAM0AudioProcessor proc;
+    proc.setSamplesFolder(clipFolder);
+    proc.setFollowSeed(1);
+
+    if (!edit.pluginState.isEmpty())
+        proc.setStateInformation(edit.pluginState.getData(), (int)edit.pluginState.getSize());
+
+    TempoMapPlayHead head(tempoMap, edit.numerator, edit.denominator);
+    proc.setPlayHead(&head);
+    proc.setRateAndBufferSizeDetails(o.sampleRate, o.blockSize);
+    proc.prepareToPlay(o.sampleRate, o.blockSize);
+
+    // Automation lanes resolved once; unknown IDs are reported, not fatal
+    std::vector<std::pair<const AutomationLane*, juce::RangedAudioParameter*>> lanes;
+    for (const auto& lane : edit.automation)
+    {
+        if (auto* p = findParameter(proc, lane.paramID))
+            lanes.push_back({ &lane, p });
+        else
+            std::cerr << "warning: automation for unknown parameter " << lane.paramID << " ignored\n";
+    }
+
+    const double barSeconds = beatsPerBar * 60.0 / tempoMap.bpmAtSample(0);
+    const double seconds = o.seconds > 0.0 ? o.seconds : juce::jmax(edit.endSeconds, 8.0 * barSeconds) + barSeconds;
+    const auto total = (juce::int64)std::llround(seconds * o.sampleRate);
+
+    const int numChannels = juce::jmax(proc.getTotalNumInputChannels(), proc.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, o.blockSize);
+    juce::MidiBuffer midi;
+
+    BlockTimings timings;
+    timings.reserve((size_t)(total / o.blockSize + 1));
+    juce::String csv = "block,start_sample,samples,ns,budget_ns\n";
+
+    BarAlignmentCheck alignment(tempoMap, beatsPerBar, o.tolerance);
+    EngineSnapshot snapshot;
+    int deadlineMisses = 0;
+    double worstLoad = 0.0;
+
+    for (juce::int64 pos = 0, block = 0; pos < total; ++block)
+    {
+        const double now = pos / o.sampleRate;
+        for (auto& [lane, param] : lanes)
+        {
+            const float v = lane->valueAt(now);
+            if (v != param->getValue())
+                param->setValueNotifyingHost(v);
+        }
+
+        juce::int64 end = juce::jmin(pos + o.blockSize, total);
+        if (const auto change = tempoMap.nextChangeAfter(pos); change > 0)
+            end = juce::jmin(end, change);
+
+        const int n = (int)(end - pos);
+        juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(), numChannels, n);
+        view.clear();
+
+        const auto t0 = juce::Time::getHighResolutionTicks();
+        proc.processBlock(view, midi);
+        const double ns = ticksToNanos(juce::Time::getHighResolutionTicks() - t0);
+
+        const double budget = n / o.sampleRate * 1.0e9;
+        timings.add(ns);
+        worstLoad = juce::jmax(worstLoad, ns / budget);
+        if (ns > budget)
+            ++deadlineMisses;
+        if (o.csv != juce::File())
+            csv << block << "," << pos << "," << n << "," << juce::String(ns, 0) << "," << juce::String(budget, 0) << "\n";
+
+        head.advance(n);
+        pos = end;
+
+        proc.captureSnapshot(snapshot);
+        alignment.check(snapshot, pos, n);
+    }
+
+    proc.releaseResources();
+
+    if (o.csv != juce::File() && !o.csv.replaceWithText(csv))
+        std::cerr << "could not write " << o.csv.getFullPathName() << "\n";
+
+    const double budgetNs = o.blockSize / o.sampleRate * 1.0e9;
+    const double p99Load = timings.percentile(99) / budgetNs;
+
+    std::cout << o.edit.getFileName() << ": " << seconds << " s at " << o.sampleRate << " Hz, "
+              << edit.numerator << "/" << edit.denominator << ", " << edit.tempos.size() << " tempo point(s), "
+              << lanes.size() << " automation lane(s)\n"
+              << "  bar alignment: " << alignment.starts << " clip starts, " << alignment.wraps << " loop wraps, "
+              << alignment.numFailures << " off the bar\n"
+              << "  cpu per block: p50 " << juce::String(timings.percentile(50) / 1000.0, 2) << " us, p99 "
+              << juce::String(timings.percentile(99) / 1000.0, 2) << " us, max "
+              << juce::String(timings.percentile(100) / 1000.0, 2) << " us, p99 load "
+              << juce::String(p99Load * 100.0, 1) << "%, worst " << juce::String(worstLoad * 100.0, 1)
+              << "%, " << deadlineMisses << " deadline misses\n";
+
+    for (const auto& f : alignment.failures)
+        std::cout << "  FAIL " << f << "\n";
+
+    bool ok = alignment.numFailures == 0;
+    if (o.maxLoad > 0.0 && p99Load > o.maxLoad)
+    {
+        std::cout << "  FAIL p99 load " << juce::String(p99Load * 100.0, 1) << "% exceeds "
+                  << juce::String(o.maxLoad * 100.0, 1) << "%\n";
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}
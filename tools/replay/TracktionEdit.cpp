@@ -0,0 +1,142 @@
+#include "TracktionEdit.h"
+#include <algorithm>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace djam::tools
+{
+
+float AutomationLane::valueAt(double seconds) const noexcept
+{
+    if (points.empty())
+        return 0.0f;
+    if (seconds <= points.front().seconds)
+        return points.front().value;
+
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+        const auto& a = points[i - 1];
+        const auto& b = points[i];
+        if (seconds < b.seconds)
+        {
+            const double span = b.seconds - a.seconds;
+            const double t = span > 0.0 ? (seconds - a.seconds) / span : 1.0;
+            return a.value + (float)t * (b.value - a.value);
+        }
+    }
+
+    return points.back().value;
+}
+
+juce::MemoryBlock TracktionEdit::decodePluginState(const juce::String& encoded)
+{
+    juce::MemoryBlock data;
+    if (!data.fromBase64Encoding(encoded))
+        return {};
+
+    // A VST3 instance saves its component and controller state wrapped in XML;
+    // the component part is what our setStateInformation wrote
+    if (auto xml = juce::AudioProcessor::getXmlFromBinary(data.getData(), (int)data.getSize()))
+    {
+        if (xml->hasTagName("VST3PluginState"))
+        {
+            juce::MemoryBlock component;
+            if (component.fromBase64Encoding(xml->getChildElementAllSubText("IComponent", {})))
+                return component;
+        }
+    }
+
+    return data;
+}
+
+bool TracktionEdit::load(const juce::File& file, juce::String& error)
+{
+    const auto edit = juce::XmlDocument::parse(file);
+    if (edit == nullptr || !edit->hasTagName("EDIT"))
+    {
+        error = file.getFullPathName() + " is not a Tracktion edit";
+        return false;
+    }
+
+    tempos.clear();
+    automation.clear();
+    warnings.clear();
+    pluginState.reset();
+    endSeconds = 0.0;
+
+    if (auto* sequence = edit->getChildByName("TEMPOSEQUENCE"))
+    {
+        int numTimeSigs = 0;
+
+        for (auto* e : sequence->getChildIterator())
+        {
+            if (e->hasTagName("TEMPO"))
+            {
+                tempos.push_back({ e->getDoubleAttribute("startBeat"), e->getDoubleAttribute("bpm", 120.0) });
+                if (tempos.size() > 1 && e->getDoubleAttribute("curve", 1.0) != 1.0)
+                    warnings.add("tempo ramp at beat " + e->getStringAttribute("startBeat") + " replayed as a step");
+            }
+            else if (e->hasTagName("TIMESIG") && numTimeSigs++ == 0)
+            {
+                numerator = juce::jmax(1, e->getIntAttribute("numerator", 4));
+                denominator = juce::jmax(1, e->getIntAttribute("denominator", 4));
+            }
+        }
+
+        if (numTimeSigs > 1)
+            warnings.add("only the first of " + juce::String(numTimeSigs) + " time signatures is used");
+    }
+
+    std::stable_sort(tempos.begin(), tempos.end(),
+        [](const TempoChange& a, const TempoChange& b) { return a.ppq < b.ppq; });
+
+    // Edit length from the clips on every track
+    for (auto* track : edit->getChildWithTagNameIterator("TRACK"))
+        for (auto* clip : track->getChildIterator())
+            if (clip->hasAttribute("start") && clip->hasAttribute("length"))
+                endSeconds = juce::jmax(endSeconds, clip->getDoubleAttribute("start") + clip->getDoubleAttribute("length"));
+
+    // The first D-Jam instance on any track
+    const juce::XmlElement* plugin = nullptr;
+    for (auto* track : edit->getChildWithTagNameIterator("TRACK"))
+    {
+        for (auto* p : track->getChildWithTagNameIterator("PLUGIN"))
+            if (p->getStringAttribute("name") == "D-Jam")
+                plugin = p;
+
+        if (plugin != nullptr)
+            break;
+    }
+
+    if (plugin == nullptr)
+    {
+        error = file.getFullPathName() + " has no D-Jam instance";
+        return false;
+    }
+
+    pluginState = decodePluginState(plugin->getStringAttribute("state"));
+    if (pluginState.isEmpty())
+        warnings.add("the D-Jam instance has no readable state; starting from defaults");
+
+    // Points are in seconds, values normalised
+    for (auto* curve : plugin->getChildWithTagNameIterator("AUTOMATIONCURVE"))
+    {
+        AutomationLane lane;
+        lane.paramID = curve->getStringAttribute("paramID");
+
+        for (auto* point : curve->getChildWithTagNameIterator("POINT"))
+            lane.points.push_back({ point->getDoubleAttribute("t"), (float)point->getDoubleAttribute("v") });
+
+        std::stable_sort(lane.points.begin(), lane.points.end(),
+            [](const auto& a, const auto& b) { return a.seconds < b.seconds; });
+
+        if (lane.paramID.isNotEmpty() && !lane.points.empty())
+        {
+            endSeconds = juce::jmax(endSeconds, lane.points.back().seconds);
+            automation.push_back(std::move(lane));
+        }
+    }
+
+    return true;
+}
+
+} // namespace djam::tools
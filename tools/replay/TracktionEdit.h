@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <juce_core/juce_core.h>
+#include "TempoMap.h"
+
+/**
+ * The parts of a Tracktion / Waveform `.tracktionedit` that decide what a
+ * D-Jam instance hears: the tempo sequence, the time signature, the
+ * plugin's saved state and its parameter automation.
+ *
+ * Tempo points are taken as steps (ramps are not followed) and only the
+ * first time signature is used; load() notes either in `warnings`.
+ */
+namespace djam::tools
+{
+
+struct AutomationLane
+{
+    struct Point { double seconds; float value; };
+
+    juce::String paramID;           // as the host stored it: our ID, a VST3 hash or an index
+    std::vector<Point> points;      // sorted by time; values normalised 0..1
+
+    /** Linear between points, held before the first and after the last. */
+    float valueAt(double seconds) const noexcept;
+};
+
+class TracktionEdit
+{
+public:
+    /** Reads `file`; false with a message in `error` if it is not an edit holding a D-Jam instance. */
+    bool load(const juce::File& file, juce::String& error);
+
+    std::vector<TempoChange> tempos;
+    int numerator = 4, denominator = 4;
+    juce::MemoryBlock pluginState;      // what the host would pass to setStateInformation
+    std::vector<AutomationLane> automation;
+    double endSeconds = 0.0;            // last clip end or automation point
+    juce::StringArray warnings;
+
+private:
+    static juce::MemoryBlock decodePluginState(const juce::String& encoded);
+};
+
+} // namespace djam::tools
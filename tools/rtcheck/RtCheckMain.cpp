@@ -0,0 +1,169 @@
+/**
+ * djam_rtcheck: runs the engine with allocation, lock and blocking-syscall
+ * hooks armed inside processBlock, and fails on any violation.
+ *
+ *   djam_rtcheck [--seconds 120] [--block 256] [--max-reports 25]
+ *
+ * The scenario covers launches, scene launches (every slot on one bar),
+ * host automation delivered on the audio thread, insert chains, follow
+ * actions, a live-looper take, transport stop/start and locates.
+ * Exit codes: 0 clean, 1 violations, 77 unsupported platform (ctest skip).
+ */
+
+#include <iostream>
+#include "PluginProcessor.h"
+#include "OfflineHost.h"
+#include "RtIntercept.h"
+
+using namespace djam::tools;
+
+namespace
+{
+constexpr double kSampleRate = 48000.0;
+constexpr double kBpm = 128.0;
+
+void setParam(DJAM0AudioProcessor& proc, const juce::String& id, float value)
+{
+    if (auto* p = proc.getAPVTS().getParameter(id))
+        p->setValueNotifyingHost(p->convertTo0to1(value));
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList args(argc, argv);
+
+    if (!djam::rtcheck::isSupported())
+    {
+        std::cout << "djam_rtcheck: interposition is only implemented for Linux/glibc, skipping\n";
+        return 77;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    djam::rtcheck::install();
+
+    const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 120.0;
+    const int blockSize = args.containsOption("--block") ? juce::jmax(1, args.getValueForOption("--block").getIntValue()) : 256;
+    if (args.containsOption("--max-reports"))
+        djam::rtcheck::setMaxReports(args.getValueForOption("--max-reports").getIntValue());
+
+    // Everything up to the first block runs on the "message thread" and may allocate freely
+    const auto work = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("djam_rtcheck");
+    const auto packFolder = work.getChildFile("pack");
+    if (!writeSyntheticPack(packFolder, 12, kSampleRate, kBpm, 4, 2))
+    {
+        std::cerr << "could not write the synthetic pack\n";
+        return 1;
+    }
+
+    DJAM0AudioProcessor proc;
+    proc.setSamplesFolder(packFolder);
+    proc.setTakeFolder(work.getChildFile("takes"));
+
+    OfflinePlayHead head(kSampleRate, kBpm, 4, 4);
+    proc.setPlayHead(&head);
+    proc.setRateAndBufferSizeDetails(kSampleRate, blockSize);
+    proc.prepareToPlay(kSampleRate, blockSize);
+
+    const int numSlots = DJAM0AudioProcessor::getNumSlots();
+    // Clip params pick within the slot's bank; every slot stays on bank 0
+    const int numClips = juce::jlimit(1, DJAM0AudioProcessor::kClipsPerBank, proc.getNumPackClips());
+
+    // Inserts and slice patterns on half the slots, follow actions on every clip
+    for (int s = 0; s < numSlots; s += 2)
+    {
+        setParam(proc, paramId_slotFx(s), 1.0f);
+        setParam(proc, paramId_slotFxCutoff(s), 1500.0f);
+        setParam(proc, paramId_slotFxDelayMix(s), 0.25f);
+        proc.setSlicePattern(s, SlicePattern::fromString(s % 4 == 0 ? "1 1 3r 4x4 - 2" : "t: 2 1x3 4r 3"));
+    }
+
+    for (int c = 0; c < numClips; ++c)
+    {
+        FollowAction action;
+        action.type = (c % 3 == 0) ? FollowActionType::random : FollowActionType::next;
+        action.unit = FollowUnit::bars;
+        action.count = 1 + c % 3;
+        proc.setClipFollowAction(c, action);
+    }
+
+    // Host automation arrives on the audio thread: the listener path must be RT-safe too
+    const juce::String automationIds[] = { paramId_slotMute(1), paramId_slotClip(2), paramId_slotSolo(3 % numSlots) };
+
+    const int numChannels = juce::jmax(proc.getTotalNumInputChannels(), proc.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random(42);
+
+    const int samplesPerBar = head.samplesPerBar();
+    const auto numBlocks = (juce::int64)(seconds * kSampleRate / blockSize);
+    int bar = -1, stoppedBlocks = 0;
+
+    for (juce::int64 b = 0; b < numBlocks; ++b)
+    {
+        const int currentBar = (int)(head.getSamplePosition() / samplesPerBar);
+
+        // Message-thread actions, once per new bar
+        if (currentBar != bar)
+        {
+            bar = currentBar;
+
+            if (bar % 4 == 0)
+            {
+                // Scene: every slot launches on the same bar
+                for (int s = 0; s < numSlots; ++s)
+                    setParam(proc, paramId_slotClip(s), (float)((s + bar) % numClips));
+            }
+            else
+            {
+                setParam(proc, paramId_slotClip(random.nextInt(numSlots)), (float)random.nextInt(numClips));
+            }
+
+            if (bar == 3)
+                proc.armSlotRecording(numSlots - 1);
+
+            if (bar > 0 && bar % 7 == 0)
+                head.jumpTo((juce::int64)random.nextInt(32) * samplesPerBar + random.nextInt(samplesPerBar));
+
+            if (bar > 0 && bar % 11 == 0 && stoppedBlocks == 0)
+            {
+                head.setPlaying(false);
+                stoppedBlocks = 40;
+            }
+        }
+
+        if (stoppedBlocks > 0 && --stoppedBlocks == 0)
+        {
+            head.setPlaying(true);
+            for (int s = 0; s < numSlots; ++s)
+                setParam(proc, paramId_slotClip(s), (float)(s % numClips));
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.clear(ch, 0, blockSize);
+
+        // The host's audio callback: automation, then the render
+        {
+            DJAM_RT_AUDIO_CALLBACK_SCOPE
+
+            if (b % 16 == 0)
+            {
+                const auto& id = automationIds[(b / 16) % 3];
+                proc.parameterChanged(id, id == automationIds[1] ? (float)random.nextInt(numClips)
+                                                                 : (float)((b / 48) % 2));
+            }
+
+            proc.processBlock(buffer, midi);
+        }
+
+        head.advance(blockSize);
+    }
+
+    proc.releaseResources();
+
+    const int violations = djam::rtcheck::getViolationCount();
+    std::cout << "djam_rtcheck: " << numBlocks << " blocks of " << blockSize << ", "
+              << violations << " real-time violation" << (violations == 1 ? "" : "s") << "\n";
+
+    return violations == 0 ? 0 : 1;
+}
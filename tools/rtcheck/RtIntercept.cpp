@@ -0,0 +1,321 @@
+#include "RtIntercept.h"
+#include "RealtimeCheck.h"
+
+#include <atomic>
+
+#if defined(__linux__) && defined(__GLIBC__)
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// glibc's own allocator entry points; forwarding to these avoids dlsym() in malloc
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void  __libc_free(void*);
+extern "C" void* __libc_memalign(size_t, size_t);
+
+namespace
+{
+std::atomic<int> violations{ 0 };
+std::atomic<int> maxReports{ 25 };
+thread_local bool inReport = false;
+
+void rawWrite(const char* text)
+{
+    ::syscall(SYS_write, 2, text, std::strlen(text));
+}
+
+/** Counts and reports a hooked call made inside the audio callback. */
+inline void check(const char* what)
+{
+    if (djam::rt::callbackDepth <= 0 || inReport)
+        return;
+
+    inReport = true;
+    const int n = ++violations;
+
+    if (n <= maxReports.load())
+    {
+        char header[160];
+        std::snprintf(header, sizeof(header), "\n[rtcheck] violation #%d: %s inside the audio callback\n", n, what);
+        rawWrite(header);
+
+        void* frames[48];
+        const int depth = ::backtrace(frames, 48);
+        ::backtrace_symbols_fd(frames + 1, depth - 1, 2); // skip check() itself
+    }
+
+    inReport = false;
+}
+
+template <typename Fn>
+Fn next(const char* name)
+{
+    return reinterpret_cast<Fn>(::dlsym(RTLD_NEXT, name));
+}
+
+// Resolved once by install(), before any audio runs
+using MutexFn = int (*)(pthread_mutex_t*);
+using RwFn = int (*)(pthread_rwlock_t*);
+using CondWaitFn = int (*)(pthread_cond_t*, pthread_mutex_t*);
+using CondTimedFn = int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*);
+using SemFn = int (*)(sem_t*);
+using ReadFn = ssize_t (*)(int, void*, size_t);
+using WriteFn = ssize_t (*)(int, const void*, size_t);
+using OpenFn = int (*)(const char*, int, ...);
+using OpenAtFn = int (*)(int, const char*, int, ...);
+using CloseFn = int (*)(int);
+using NanosleepFn = int (*)(const struct timespec*, struct timespec*);
+using ClockNanosleepFn = int (*)(clockid_t, int, const struct timespec*, struct timespec*);
+using UsleepFn = int (*)(useconds_t);
+using PollFn = int (*)(struct pollfd*, nfds_t, int);
+using SelectFn = int (*)(int, fd_set*, fd_set*, fd_set*, struct timeval*);
+
+MutexFn realMutexLock = nullptr;
+RwFn realRdLock = nullptr, realWrLock = nullptr;
+CondWaitFn realCondWait = nullptr;
+CondTimedFn realCondTimedWait = nullptr;
+SemFn realSemWait = nullptr;
+ReadFn realRead = nullptr;
+WriteFn realWrite = nullptr;
+OpenFn realOpen = nullptr;
+OpenAtFn realOpenAt = nullptr;
+CloseFn realClose = nullptr;
+NanosleepFn realNanosleep = nullptr;
+ClockNanosleepFn realClockNanosleep = nullptr;
+UsleepFn realUsleep = nullptr;
+PollFn realPoll = nullptr;
+SelectFn realSelect = nullptr;
+
+template <typename Fn>
+Fn resolved(Fn& slot, const char* name)
+{
+    if (slot == nullptr)
+        slot = next<Fn>(name);
+    return slot;
+}
+} // namespace
+
+//===================== Allocation =====================
+
+extern "C" void* malloc(size_t size)
+{
+    check("malloc");
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t n, size_t size)
+{
+    check("calloc");
+    return __libc_calloc(n, size);
+}
+
+extern "C" void* realloc(void* p, size_t size)
+{
+    check("realloc");
+    return __libc_realloc(p, size);
+}
+
+extern "C" void free(void* p)
+{
+    if (p != nullptr)
+        check("free");
+    __libc_free(p);
+}
+
+extern "C" int posix_memalign(void** out, size_t alignment, size_t size)
+{
+    check("posix_memalign");
+    void* p = __libc_memalign(alignment, size);
+    if (p == nullptr)
+        return 12; // ENOMEM
+    *out = p;
+    return 0;
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size)
+{
+    check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size)
+{
+    check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+//===================== Locks =====================
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* m)
+{
+    check("pthread_mutex_lock");
+    return resolved(realMutexLock, "pthread_mutex_lock")(m);
+}
+
+extern "C" int pthread_rwlock_rdlock(pthread_rwlock_t* l)
+{
+    check("pthread_rwlock_rdlock");
+    return resolved(realRdLock, "pthread_rwlock_rdlock")(l);
+}
+
+extern "C" int pthread_rwlock_wrlock(pthread_rwlock_t* l)
+{
+    check("pthread_rwlock_wrlock");
+    return resolved(realWrLock, "pthread_rwlock_wrlock")(l);
+}
+
+extern "C" int pthread_cond_wait(pthread_cond_t* c, pthread_mutex_t* m)
+{
+    check("pthread_cond_wait");
+    return resolved(realCondWait, "pthread_cond_wait")(c, m);
+}
+
+extern "C" int pthread_cond_timedwait(pthread_cond_t* c, pthread_mutex_t* m, const struct timespec* t)
+{
+    check("pthread_cond_timedwait");
+    return resolved(realCondTimedWait, "pthread_cond_timedwait")(c, m, t);
+}
+
+extern "C" int sem_wait(sem_t* s)
+{
+    check("sem_wait");
+    return resolved(realSemWait, "sem_wait")(s);
+}
+
+//===================== Blocking syscalls =====================
+
+extern "C" ssize_t read(int fd, void* buf, size_t n)
+{
+    check("read");
+    return resolved(realRead, "read")(fd, buf, n);
+}
+
+extern "C" ssize_t write(int fd, const void* buf, size_t n)
+{
+    check("write");
+    return resolved(realWrite, "write")(fd, buf, n);
+}
+
+extern "C" int open(const char* path, int flags, ...)
+{
+    check("open");
+    mode_t mode = 0;
+    if ((flags & O_CREAT) != 0)
+    {
+        va_list args;
+        va_start(args, flags);
+        mode = (mode_t)va_arg(args, int);
+        va_end(args);
+    }
+    return resolved(realOpen, "open")(path, flags, mode);
+}
+
+extern "C" int openat(int dirfd, const char* path, int flags, ...)
+{
+    check("openat");
+    mode_t mode = 0;
+    if ((flags & O_CREAT) != 0)
+    {
+        va_list args;
+        va_start(args, flags);
+        mode = (mode_t)va_arg(args, int);
+        va_end(args);
+    }
+    return resolved(realOpenAt, "openat")(dirfd, path, flags, mode);
+}
+
+extern "C" int close(int fd)
+{
+    check("close");
+    return resolved(realClose, "close")(fd);
+}
+
+extern "C" int nanosleep(const struct timespec* req, struct timespec* rem)
+{
+    check("nanosleep");
+    return resolved(realNanosleep, "nanosleep")(req, rem);
+}
+
+extern "C" int clock_nanosleep(clockid_t clock, int flags, const struct timespec* req, struct timespec* rem)
+{
+    check("clock_nanosleep");
+    return resolved(realClockNanosleep, "clock_nanosleep")(clock, flags, req, rem);
+}
+
+extern "C" int usleep(useconds_t us)
+{
+    check("usleep");
+    return resolved(realUsleep, "usleep")(us);
+}
+
+extern "C" int poll(struct pollfd* fds, nfds_t n, int timeout)
+{
+    check("poll");
+    return resolved(realPoll, "poll")(fds, n, timeout);
+}
+
+extern "C" int select(int n, fd_set* r, fd_set* w, fd_set* e, struct timeval* t)
+{
+    check("select");
+    return resolved(realSelect, "select")(n, r, w, e, t);
+}
+
+//===================== Control =====================
+
+namespace djam::rtcheck
+{
+bool install()
+{
+    resolved(realMutexLock, "pthread_mutex_lock");
+    resolved(realRdLock, "pthread_rwlock_rdlock");
+    resolved(realWrLock, "pthread_rwlock_wrlock");
+    resolved(realCondWait, "pthread_cond_wait");
+    resolved(realCondTimedWait, "pthread_cond_timedwait");
+    resolved(realSemWait, "sem_wait");
+    resolved(realRead, "read");
+    resolved(realWrite, "write");
+    resolved(realOpen, "open");
+    resolved(realOpenAt, "openat");
+    resolved(realClose, "close");
+    resolved(realNanosleep, "nanosleep");
+    resolved(realClockNanosleep, "clock_nanosleep");
+    resolved(realUsleep, "usleep");
+    resolved(realPoll, "poll");
+    resolved(realSelect, "select");
+
+    // The first backtrace() loads libgcc_s (and allocates); do it now, outside any callback
+    void* frames[4];
+    ::backtrace(frames, 4);
+
+    return realMutexLock != nullptr && realWrite != nullptr;
+}
+
+bool isSupported() { return true; }
+int getViolationCount() { return violations.load(); }
+void setMaxReports(int n) { maxReports.store(n); }
+}
+
+#else
+
+namespace djam::rtcheck
+{
+bool install() { return false; }
+bool isSupported() { return false; }
+int getViolationCount() { return 0; }
+void setMaxReports(int) {}
+}
+
+#endif
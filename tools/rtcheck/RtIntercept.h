@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * Interposed allocation, lock and blocking-syscall hooks for djam_rtcheck.
+ *
+ * While djam::rt::callbackDepth is non-zero on the calling thread, every
+ * hooked call is counted and reported to stderr with a stack trace. Only
+ * implemented for Linux/glibc; elsewhere isSupported() returns false.
+ */
+namespace djam::rtcheck
+{
+    /** Resolves the real functions and primes backtrace(); call before any audio. */
+    bool install();
+    bool isSupported();
+
+    /** Violations seen so far (all threads). */
+    int getViolationCount();
+
+    /** Stops printing traces after this many (still counts them). */
+    void setMaxReports(int maxReports);
+}
@@ -0,0 +1,497 @@
+/**
+ * djam_stress: randomized fuzzing of processBlock against odd hosts.
+ *
+ *   djam_stress [--seed N] [--blocks 200000] [--rounds 4] [--max-load 0.5]
+ *               [--spike-floor-us 200] [--max-spikes 0] [--fp-traps]
+ *
+ * Each round prepares the processor at a random sample rate, then feeds it
+ * blocks of 1 to 16384 samples (changing between blocks, larger than the
+ * prepared size too) while the transport misbehaves: tempo and meter
+ * changes including garbage (0, negative, inf, NaN), ppq jumps forwards,
+ * backwards and into pre-roll, cycle-loop wraps, stop/start, and launch,
+ * mute/solo/FX storms between blocks.
+ *
+ * After every block it checks:
+ *  - the output is finite (no NaN/inf) and not absurdly loud;
+ *  - the bar-split segment count stays within what the tempo limits allow;
+ *  - the block took no longer than --max-load of its real-time budget
+ *    (or --spike-floor-us for tiny blocks); more than --max-spikes fails.
+ * Integer divide-by-zero crashes the run; --fp-traps (glibc) also traps
+ * float division by zero and invalid operations inside the engine.
+ * The seed is printed so a failing run can be replayed exactly.
+ *
+ * Before the rounds, a fixed check runs against a well-behaved transport:
+ * clips requested while it is stopped must start once it plays, and a
+ * launch pending across a locate must still land on the next bar. Then,
+ * in 3/4, a clip must start on a bar line and keep looping in whole bars.
+ */
+
+#include <iostream>
+#include "PluginProcessor.h"
+#include "OfflineHost.h"
+
+#if defined(__GLIBC__)
+ #include <fenv.h>
+#endif
+
+using namespace djam::tools;
+
+namespace
+{
+/** Play head whose every field the fuzzer sets directly, garbage included. */
+class FuzzPlayHead : public juce::AudioPlayHead
+{
+public:
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        PositionInfo info;
+        info.setIsPlaying(playing);
+        info.setBpm(bpm);
+        info.setTimeSignature(TimeSignature{ numerator, denominator });
+        info.setTimeInSamples(samplePosition);
+        info.setPpqPosition(ppq);
+        return info;
+    }
+
+    void advance(int numSamples, double sampleRate) noexcept
+    {
+        if (!playing)
+            return;
+
+        samplePosition += numSamples;
+        if (std::isfinite(bpm) && bpm > 0.0)
+            ppq += numSamples / sampleRate * bpm / 60.0;
+    }
+
+    bool playing = true;
+    double bpm = 120.0;
+    int numerator = 4, denominator = 4;
+    double ppq = 0.0;
+    juce::int64 samplePosition = 0;
+};
+
+struct Options
+{
+    juce::int64 seed = 0;
+    int blocks = 200000;
+    int rounds = 4;
+    double maxLoad = 0.5;
+    double spikeFloorUs = 200.0;
+    int maxSpikes = 0;
+    bool fpTraps = false;
+};
+
+Options parseOptions(const juce::ArgumentList& args)
+{
+    Options o;
+    o.seed = args.containsOption("--seed") ? args.getValueForOption("--seed").getLargeIntValue()
+                                           : juce::Time::currentTimeMillis();
+
+    if (args.containsOption("--blocks"))         o.blocks = juce::jmax(1, args.getValueForOption("--blocks").getIntValue());
+    if (args.containsOption("--rounds"))         o.rounds = juce::jmax(1, args.getValueForOption("--rounds").getIntValue());
+    if (args.containsOption("--max-load"))       o.maxLoad = args.getValueForOption("--max-load").getDoubleValue();
+    if (args.containsOption("--spike-floor-us")) o.spikeFloorUs = args.getValueForOption("--spike-floor-us").getDoubleValue();
+    if (args.containsOption("--max-spikes"))     o.maxSpikes = juce::jmax(0, args.getValueForOption("--max-spikes").getIntValue());
+    o.fpTraps = args.containsOption("--fp-traps");
+    return o;
+}
+
+void setParam(DJAM0AudioProcessor& proc, const juce::String& id, float value)
+{
+    if (auto* p = proc.getAPVTS().getParameter(id))
+        p->setValueNotifyingHost(p->convertTo0to1(value));
+}
+
+/** Block sizes weighted towards the awkward ones. */
+int randomBlockSize(juce::Random& r)
+{
+    switch (r.nextInt(6))
+    {
+        case 0:  return 1 + r.nextInt(4);                          // 1..4
+        case 1:  return 1 << r.nextInt(15);                        // 1..16384, powers of two
+        case 2:  return 1 + r.nextInt(16384);                      // anything
+        case 3:  { static const int primes[] = { 7, 97, 331, 1021, 4099, 16381 }; return primes[r.nextInt(6)]; }
+        case 4:  return 16384;
+        default: return 64 + r.nextInt(1024);                      // typical
+    }
+}
+
+double randomTempo(juce::Random& r)
+{
+    switch (r.nextInt(10))
+    {
+        case 0:  return 0.0;
+        case 1:  return -120.0;
+        case 2:  return std::numeric_limits<double>::infinity();
+        case 3:  return std::numeric_limits<double>::quiet_NaN();
+        case 4:  return 1.0e6;
+        case 5:  return kMaxHostBpm;                               // shortest legal bars
+        default: return 40.0 + r.nextDouble() * 200.0;
+    }
+}
+
+/** Slice patterns from off to full length, slices past any clip's table, every step kind. */
+SlicePattern randomSlicePattern(juce::Random& r)
+{
+    SlicePattern p;
+    p.source = r.nextBool() ? SliceSource::transients : SliceSource::beats;
+    p.numSteps = r.nextInt(SlicePattern::kMaxSteps + 1);
+
+    for (int i = 0; i < p.numSteps; ++i)
+    {
+        auto& step = p.steps[(size_t)i];
+        step.slice = r.nextInt(8) == 0 ? SliceStep::kRest : r.nextInt(2 * SliceTable::kMaxSlices);
+        step.reverse = r.nextBool();
+        step.repeats = 1 + r.nextInt(SliceStep::kMaxRepeats);
+    }
+
+    return p;
+}
+
+void randomJump(FuzzPlayHead& head, juce::Random& r, double sampleRate)
+{
+    switch (r.nextInt(6))
+    {
+        case 0: head.ppq = -8.0 * r.nextDouble(); break;          // pre-roll
+        case 1: head.ppq = r.nextDouble() * 1.0e7; break;          // far out
+        case 2: head.ppq = std::floor(head.ppq);                   // snap to a beat
+                break;
+        case 3: head.ppq = std::numeric_limits<double>::quiet_NaN(); break;
+        case 4: head.ppq = std::nextafter(std::ceil(head.ppq / 4.0) * 4.0, 0.0); break; // just before a bar
+        default: head.ppq = juce::jmax(0.0, head.ppq - r.nextDouble() * 16.0); break;
+    }
+
+    head.samplePosition = std::isfinite(head.ppq) ? (juce::int64)(head.ppq * 60.0 / 120.0 * sampleRate) : 0;
+}
+
+/** Largest segment count processBlock may legitimately produce for `numSamples`. */
+int maxSegmentsFor(int numSamples, double sampleRate)
+{
+    const double shortestBar = 60.0 / kMaxHostBpm * sampleRate; // one beat per bar at the top tempo
+    return juce::jmin(DJAM0AudioProcessor::kMaxSegmentsPerBlock, 2 + (int)(numSamples / shortestBar));
+}
+
+struct Stats
+{
+    juce::int64 blocks = 0, samples = 0;
+    int nonFinite = 0, tooLoud = 0, segmentOverruns = 0, spikes = 0, launchFailures = 0, gridFailures = 0;
+    int maxSegments = 0;
+    double worstLoad = 0.0, worstNs = 0.0;
+    juce::StringArray firstFailures;
+
+    void fail(const juce::String& message)
+    {
+        if (firstFailures.size() < 20)
+            firstFailures.add(message);
+    }
+};
+
+/** Launches queued while stopped, and across a locate, must still start (see the file comment). */
+void checkLaunches(const juce::File& clipFolder, Stats& stats)
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    DJAM0AudioProcessor proc;
+    proc.setSamplesFolder(clipFolder);
+
+    OfflinePlayHead head(sampleRate, 120.0, 4, 4);
+    head.setPlaying(false);
+    proc.setPlayHead(&head);
+    proc.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    proc.prepareToPlay(sampleRate, blockSize);
+
+    const int numSlots = juce::jmin(2, DJAM0AudioProcessor::getNumSlots());
+    const int numClips = juce::jlimit(1, DJAM0AudioProcessor::kClipsPerBank, proc.getNumPackClips());
+    const int numChannels = juce::jmax(proc.getTotalNumInputChannels(), proc.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    EngineSnapshot snapshot;
+
+    auto runSamples = [&](int numSamples)
+        {
+            for (int done = 0; done < numSamples; done += blockSize)
+            {
+                proc.processBlock(buffer, midi);
+                head.advance(blockSize);
+            }
+            proc.captureSnapshot(snapshot);
+        };
+
+    auto expect = [&](int slot, int clip, const juce::String& when)
+        {
+            const int active = snapshot.slots[(size_t)slot].activeClip;
+            if (active != clip)
+            {
+                ++stats.launchFailures;
+                stats.fail("slot " + juce::String(slot + 1) + " plays clip " + juce::String(active)
+                    + " instead of " + juce::String(clip) + " " + when);
+            }
+        };
+
+    // Picked while stopped: nothing plays until the transport starts, then each starts on a bar
+    for (int s = 0; s < numSlots; ++s)
+        setParam(proc, paramId_slotClip(s), (float)((s + 1) % numClips));
+
+    runSamples(head.samplesPerBar());
+    for (int s = 0; s < numSlots; ++s)
+        expect(s, -1, "while stopped");
+
+    head.setPlaying(true);
+    runSamples(2 * head.samplesPerBar());
+    for (int s = 0; s < numSlots; ++s)
+        expect(s, (s + 1) % numClips, "after the transport started");
+
+    // Requested mid-bar, then the host locates (a cycle wrap) before that bar ends
+    const int relaunched = (2 + numSlots) % numClips;
+    runSamples(head.samplesPerBar() / 2);
+    setParam(proc, paramId_slotClip(0), (float)relaunched);
+    head.jumpTo(0);
+    runSamples(2 * head.samplesPerBar());
+    expect(0, relaunched, "after a locate");
+
+    proc.releaseResources();
+}
+
+/** In a meter other than 4/4, a loop must start on a bar line and stay a whole number of bars long. */
+void checkBarGrid(const juce::File& clipFolder, Stats& stats)
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr double bpm = 120.0;
+    constexpr int numerator = 3;
+    constexpr int blockSize = 500;   // not a divisor of the bar, so bar lines fall inside blocks
+
+    DJAM0AudioProcessor proc;
+    proc.setSamplesFolder(clipFolder);
+
+    OfflinePlayHead head(sampleRate, bpm, numerator, 4);
+    proc.setPlayHead(&head);
+    proc.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    proc.prepareToPlay(sampleRate, blockSize);
+
+    const int numChannels = juce::jmax(proc.getTotalNumInputChannels(), proc.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    EngineSnapshot snapshot;
+
+    constexpr int clip = 0;
+    setParam(proc, paramId_slotClip(0), (float)clip);
+
+    const int samplesPerBar = head.samplesPerBar();
+    juce::int64 launchSample = -1;
+    int loopSamples = 0;
+
+    for (int block = 0; block < 16 * samplesPerBar / blockSize; ++block)
+    {
+        proc.processBlock(buffer, midi);
+        head.advance(blockSize);
+        proc.captureSnapshot(snapshot, { 0, 1 });
+
+        const auto& slot = snapshot.slots[0];
+        if (slot.activeClip != clip)
+            continue;
+
+        const juce::int64 end = head.getSamplePosition();
+        if (launchSample < 0)
+        {
+            // The clip's length in bars is known once it has loaded, which it has by its launch
+            loopSamples = (int)(juce::jmax(1, proc.getClipInfo(clip).loopBars) * numerator * (sampleRate * 60.0 / bpm));
+            launchSample = end - slot.phaseSamples;
+            if (launchSample % samplesPerBar != 0)
+            {
+                ++stats.gridFailures;
+                stats.fail("3/4 launch at sample " + juce::String(launchSample) + ", off the bar line");
+                break;
+            }
+        }
+        else if (slot.phaseSamples != (int)((end - launchSample) % loopSamples))
+        {
+            ++stats.gridFailures;
+            stats.fail("3/4 loop at phase " + juce::String(slot.phaseSamples) + " instead of "
+                + juce::String((end - launchSample) % loopSamples) + " (sample " + juce::String(end) + ")");
+            break;
+        }
+    }
+
+    if (launchSample < 0)
+    {
+        ++stats.gridFailures;
+        stats.fail("3/4 clip never started");
+    }
+
+    proc.releaseResources();
+}
+
+void runRound(const Options& o, juce::Random& r, const juce::File& clipFolder, int round, Stats& stats)
+{
+    static const double rates[] = { 8000.0, 22050.0, 44100.0, 48000.0, 96000.0, 192000.0 };
+    const double sampleRate = rates[r.nextInt(6)];
+    const int preparedBlock = 1 << (5 + r.nextInt(8)); // 32..4096; blocks up to 16384 still arrive
+
+    DJAM0AudioProcessor proc;
+    proc.setSamplesFolder(clipFolder);
+    proc.setFollowSeed(r.nextInt64());
+
+    FuzzPlayHead head;
+    proc.setPlayHead(&head);
+    proc.setRateAndBufferSizeDetails(sampleRate, preparedBlock);
+    proc.prepareToPlay(sampleRate, preparedBlock);
+
+    const int numSlots = DJAM0AudioProcessor::getNumSlots();
+    // Clip params pick within the slot's bank; every slot stays on bank 0
+    const int numClips = juce::jlimit(1, DJAM0AudioProcessor::kClipsPerBank, proc.getNumPackClips());
+    const int numChannels = juce::jmax(proc.getTotalNumInputChannels(), proc.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, 16384);
+    juce::MidiBuffer midi;
+
+    // Loop region for cycle wraps, in bars
+    const double loopStart = 4.0 * r.nextInt(8);
+    const double loopEnd = loopStart + 4.0 * (1 + r.nextInt(4));
+    bool cycling = false;
+    int blockSize = randomBlockSize(r);
+
+    for (int b = 0; b < o.blocks / o.rounds; ++b)
+    {
+        // Host misbehaviour between blocks
+        if (r.nextInt(8) == 0)    blockSize = randomBlockSize(r);
+        if (r.nextInt(500) == 0)  head.bpm = randomTempo(r);
+        if (r.nextInt(2000) == 0) { head.numerator = r.nextInt(70) - 2; head.denominator = 1 << r.nextInt(6); }
+        if (r.nextInt(1000) == 0) randomJump(head, r, sampleRate);
+        if (r.nextInt(3000) == 0) head.playing = !head.playing;
+        if (r.nextInt(1000) == 0) cycling = !cycling;
+        if (cycling && head.ppq >= loopEnd)
+            head.ppq = loopStart + (head.ppq - loopEnd);
+
+        // Host vanishing and the clock source, tempo and run flipping under it
+        if (r.nextInt(3000) == 0) proc.setPlayHead(proc.getPlayHead() != nullptr ? nullptr : &head);
+        if (r.nextInt(2000) == 0) setParam(proc, paramId_clockMode(), (float)r.nextInt(3));
+        if (r.nextInt(500) == 0)  setParam(proc, paramId_clockBpm(), 40.0f + r.nextFloat() * 260.0f);
+        if (r.nextInt(2000) == 0) setParam(proc, paramId_clockNumerator(), (float)(1 + r.nextInt(16)));
+        if (r.nextInt(2000) == 0) setParam(proc, paramId_clockRun(), (float)r.nextInt(2));
+
+        // Launch storm: every slot, several times, clip indices past the pack too
+        if (r.nextInt(200) == 0)
+            for (int n = 0; n < 4; ++n)
+                for (int s = 0; s < numSlots; ++s)
+                    setParam(proc, paramId_slotClip(s), (float)(r.nextInt(numClips + 4) - 1));
+        else if (r.nextInt(4) == 0)
+            setParam(proc, paramId_slotClip(r.nextInt(numSlots)), (float)r.nextInt(numClips));
+
+        if (r.nextInt(50) == 0)  setParam(proc, paramId_slotMute(r.nextInt(numSlots)), (float)r.nextInt(2));
+        if (r.nextInt(80) == 0)  setParam(proc, paramId_slotSolo(r.nextInt(numSlots)), (float)r.nextInt(2));
+        if (r.nextInt(100) == 0) setParam(proc, paramId_slotFx(r.nextInt(numSlots)), (float)r.nextInt(2));
+        if (r.nextInt(500) == 0) setParam(proc, paramId_normalise(), (float)r.nextInt(2));
+        if (r.nextInt(200) == 0) proc.setSlicePattern(r.nextInt(numSlots), randomSlicePattern(r));
+
+        juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(), numChannels, blockSize);
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::fill(view.getWritePointer(ch), r.nextFloat() - 0.5f, blockSize); // looper input
+
+        const auto t0 = juce::Time::getHighResolutionTicks();
+        proc.processBlock(view, midi);
+        const double ns = ticksToNanos(juce::Time::getHighResolutionTicks() - t0);
+
+        // Checks
+        const auto where = "round " + juce::String(round) + " block " + juce::String(b) + " (" + juce::String(blockSize)
+            + " samples at " + juce::String(sampleRate, 0) + " Hz, bpm " + juce::String(head.bpm) + ", ppq " + juce::String(head.ppq) + ")";
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* data = view.getReadPointer(ch);
+            float peak = 0.0f;
+            bool finite = true;
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                finite = finite && std::isfinite(data[i]);
+                peak = juce::jmax(peak, std::abs(data[i]));
+            }
+
+            if (!finite)          { ++stats.nonFinite; stats.fail("non-finite output, " + where); break; }
+            if (peak > 64.0f)     { ++stats.tooLoud; stats.fail("output peak " + juce::String(peak) + ", " + where); break; }
+        }
+
+        const int segments = proc.getLastBlockSegments();
+        stats.maxSegments = juce::jmax(stats.maxSegments, segments);
+        if (segments > maxSegmentsFor(blockSize, sampleRate))
+        {
+            ++stats.segmentOverruns;
+            stats.fail(juce::String(segments) + " segments, " + where);
+        }
+
+        const double budgetNs = blockSize / sampleRate * 1.0e9;
+        const double limitNs = juce::jmax(budgetNs * o.maxLoad, o.spikeFloorUs * 1000.0);
+        stats.worstLoad = juce::jmax(stats.worstLoad, ns / budgetNs);
+        stats.worstNs = juce::jmax(stats.worstNs, ns);
+        if (ns > limitNs && b > 100) // the first blocks warm caches and the insert chains
+        {
+            ++stats.spikes;
+            stats.fail("spike " + juce::String(ns / 1000.0, 1) + " us, " + where);
+        }
+
+        head.advance(blockSize, sampleRate);
+        ++stats.blocks;
+        stats.samples += blockSize;
+    }
+
+    proc.releaseResources();
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    const juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "djam_stress [--seed N] [--blocks N] [--rounds N] [--max-load F]\n"
+                     "            [--spike-floor-us N] [--max-spikes N] [--fp-traps]\n";
+        return 0;
+    }
+
+    const auto o = parseOptions(args);
+    std::cout << "djam_stress seed " << o.seed << "\n";
+
+    const auto clipFolder = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("djam_stress_pack");
+    if (!writeSyntheticPack(clipFolder, 12, 48000.0, 120.0, 4, 2))
+    {
+        std::cerr << "could not write the synthetic pack to " << clipFolder.getFullPathName() << "\n";
+        return 1;
+    }
+
+#if defined(__GLIBC__)
+    if (o.fpTraps)
+        feenableexcept(FE_DIVBYZERO | FE_INVALID);
+#else
+    if (o.fpTraps)
+        std::cerr << "--fp-traps needs glibc; ignored\n";
+#endif
+
+    juce::Random random(o.seed);
+    Stats stats;
+    checkLaunches(clipFolder, stats);
+    checkBarGrid(clipFolder, stats);
+
+    for (int round = 0; round < o.rounds; ++round)
+        runRound(o, random, clipFolder, round, stats);
+
+    std::cout << stats.blocks << " blocks, " << stats.samples << " samples\n"
+              << "  non-finite blocks " << stats.nonFinite << ", too loud " << stats.tooLoud << "\n"
+              << "  max segments per block " << stats.maxSegments << ", overruns " << stats.segmentOverruns << "\n"
+              << "  worst block " << juce::String(stats.worstNs / 1000.0, 1) << " us, worst load "
+              << juce::String(stats.worstLoad * 100.0, 1) << "%, spikes " << stats.spikes << "\n"
+              << "  launch check failures " << stats.launchFailures << ", bar grid failures " << stats.gridFailures << "\n";
+
+    for (const auto& f : stats.firstFailures)
+        std::cout << "  FAIL " << f << "\n";
+
+    const bool ok = stats.nonFinite == 0 && stats.tooLoud == 0 && stats.segmentOverruns == 0
+                 && stats.spikes <= o.maxSpikes && stats.launchFailures == 0
+                 && stats.gridFailures == 0;
+
+    if (!ok)
+        std::cout << "failed; replay with --seed " << o.seed << "\n";
+
+    return ok ? 0 : 1;
+}